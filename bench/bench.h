@@ -0,0 +1,80 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Operations timed together as one sample, so clock overhead does not dominate cheap ops
+#define BENCH_BATCH 16
+
+typedef struct BenchConfig
+{
+    FILE* csv; // CSV output stream, NULL if CSV was not requested
+    const char* filter; // run only benchmarks which name contains this string
+    int quick; // smaller sizes, useful for smoke runs
+} BenchConfig;
+
+// Single workload run used by the profiling targets (make cachegrind / make perf_stat)
+typedef struct BenchProfile
+{
+    const char* workload; // search_hit, search_miss, search_batch_hit or search_batch_miss
+    size_t tableSize;
+    size_t keyLen;
+    size_t ops;
+    int baseline; // do the whole setup but skip the measured operations
+} BenchProfile;
+
+typedef struct BenchRng
+{
+    uint64_t state;
+} BenchRng;
+
+typedef struct BenchZipf
+{
+    double* cdf; // cumulative distribution of ranks 0..n-1
+    size_t n;
+} BenchZipf;
+
+typedef struct BenchSamples
+{
+    double* nsPerOp; // per operation time of every sample
+    size_t count;
+    size_t capacity;
+    uint64_t totalNs;
+    size_t ops;
+    size_t allocs; // allocations done inside measured batches
+    uint64_t batchStartNs;
+    size_t batchStartAllocs;
+} BenchSamples;
+
+// Incremented by every malloc/calloc/realloc done by the benchmarked modules
+extern size_t bench_alloc_count;
+
+// Written by benchmarks to keep results of the measured calls alive
+extern volatile uintptr_t bench_sink;
+
+uint64_t bench_now_ns(void);
+
+void bench_rng_seed(BenchRng* rng, uint64_t seed);
+uint64_t bench_rng_next(BenchRng* rng);
+size_t bench_rng_below(BenchRng* rng, size_t bound);
+void bench_shuffle(BenchRng* rng, size_t* array, size_t n);
+
+BenchZipf* bench_zipf_new(size_t n, double exponent);
+size_t bench_zipf_next(const BenchZipf* zipf, BenchRng* rng);
+void bench_zipf_delete(BenchZipf* zipf);
+
+int bench_enabled(const BenchConfig* config, const char* name);
+void bench_samples_start(BenchSamples* samples, size_t ops);
+void bench_batch_begin(BenchSamples* samples);
+void bench_batch_end(BenchSamples* samples, size_t ops);
+void bench_report(const BenchConfig* config, BenchSamples* samples, const char* name,
+                  const char* distribution, size_t tableSize, size_t keyLen, size_t elems);
+void bench_report_header(const BenchConfig* config);
+
+void hashtable_bench(const BenchConfig* config);
+void nodelist_bench(const BenchConfig* config);
+int hashtable_profile(const BenchProfile* profile);
+
+#endif // BENCH_H
@@ -0,0 +1,47 @@
+#define _POSIX_C_SOURCE 200809L // pthread_rwlock_t of the included modules
+#include <stdlib.h> // malloc, calloc, realloc
+#include "bench.h"
+
+/*
+    Benchmarked modules are compiled in this translation unit with the allocation functions
+    replaced by counting wrappers (same approach as test/mocks), so every benchmark can
+    report how many allocations a single operation costs.
+*/
+
+size_t bench_alloc_count = 0;
+
+static inline void* bench_malloc(size_t size)
+{
+    bench_alloc_count++;
+    return malloc(size);
+}
+
+static inline void* bench_calloc(size_t nmemb, size_t size)
+{
+    bench_alloc_count++;
+    return calloc(nmemb, size);
+}
+
+static inline void* bench_realloc(void* ptr, size_t size)
+{
+    bench_alloc_count++;
+    return realloc(ptr, size);
+}
+
+#define malloc(size) bench_malloc(size)
+#define calloc(nmemb, size) bench_calloc(nmemb, size)
+#define realloc(ptr, size) bench_realloc(ptr, size)
+
+#include <hashtable.c>
+#include <hashtable_frozen.c>
+#include <hashtable_cuckoo.c>
+#include <hashtable_export.c>
+#include <hashtable_intern.c>
+#include <hashtable_radix.c>
+#include <hashtable_rcu.c>
+#include <nodelist.c>
+#include <unrolledlist.c>
+#include <hashtable_module/hashtable_typed.h>
+
+// Integer keyed typed table, declared by HASHTABLE_TYPED_DECLARE in hashtable_bench.c
+HASHTABLE_TYPED_INIT2(U64, , uint64_t, uint64_t, hashTableTyped_hash_u64, HASHTABLE_TYPED_EQUAL_SCALAR)
@@ -0,0 +1,241 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+
+#include "bench.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+volatile uintptr_t bench_sink = 0;
+
+static int compare_double(const void* a, const void* b);
+static double percentile(const double* sorted, size_t count, double p);
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*
+    xorshift64* generator - fast and deterministic, so every run measures the same workload.
+*/
+void bench_rng_seed(BenchRng* rng, uint64_t seed)
+{
+    rng->state = seed != 0 ? seed : 0x9E3779B97F4A7C15u;
+}
+
+uint64_t bench_rng_next(BenchRng* rng)
+{
+    uint64_t x = rng->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng->state = x;
+    return x * 0x2545F4914F6CDD1Du;
+}
+
+size_t bench_rng_below(BenchRng* rng, size_t bound)
+{
+    return (size_t)(bench_rng_next(rng) % bound);
+}
+
+void bench_shuffle(BenchRng* rng, size_t* array, size_t n)
+{
+    for (size_t i = n; i > 1; --i)
+    {
+        const size_t j = bench_rng_below(rng, i);
+        const size_t tmp = array[i - 1];
+        array[i - 1] = array[j];
+        array[j] = tmp;
+    }
+}
+
+/*
+    Function: BenchZipf* bench_zipf_new(size_t n, double exponent)
+        Precomputes the cumulative distribution of Zipf law over n ranks,
+        so drawing a sample is just a binary search.
+*/
+BenchZipf* bench_zipf_new(size_t n, double exponent)
+{
+    if (n < 1)
+    {
+        return NULL;
+    }
+
+    BenchZipf* zipf = malloc(sizeof(*zipf));
+    if (zipf == NULL)
+    {
+        return NULL;
+    }
+
+    zipf->cdf = malloc(n * sizeof(*zipf->cdf));
+    if (zipf->cdf == NULL)
+    {
+        free(zipf);
+        return NULL;
+    }
+
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        sum += 1.0 / pow((double)(i + 1), exponent);
+        zipf->cdf[i] = sum;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        zipf->cdf[i] /= sum;
+    }
+
+    zipf->n = n;
+    return zipf;
+}
+
+size_t bench_zipf_next(const BenchZipf* zipf, BenchRng* rng)
+{
+    const double u = (double)(bench_rng_next(rng) >> 11) / 9007199254740992.0; // [0, 1)
+    size_t low = 0;
+    size_t high = zipf->n - 1;
+
+    while (low < high)
+    {
+        const size_t mid = low + (high - low) / 2;
+        if (zipf->cdf[mid] < u)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+void bench_zipf_delete(BenchZipf* zipf)
+{
+    if (zipf == NULL)
+    {
+        return;
+    }
+
+    free(zipf->cdf);
+    free(zipf);
+}
+
+int bench_enabled(const BenchConfig* config, const char* name)
+{
+    return config->filter == NULL || strstr(name, config->filter) != NULL;
+}
+
+/*
+    Function: void bench_samples_start(BenchSamples* samples, size_t ops)
+        Prepares the sample storage for measuring given number of operations.
+        Every measured batch of operations is surrounded by bench_batch_begin/bench_batch_end,
+        which collect the elapsed time and number of allocations done within the batch.
+*/
+void bench_samples_start(BenchSamples* samples, size_t ops)
+{
+    samples->capacity = ops / BENCH_BATCH + 1;
+    samples->nsPerOp = malloc(samples->capacity * sizeof(*samples->nsPerOp));
+    samples->count = 0;
+    samples->totalNs = 0;
+    samples->ops = 0;
+    samples->allocs = 0;
+}
+
+void bench_batch_begin(BenchSamples* samples)
+{
+    samples->batchStartAllocs = bench_alloc_count;
+    samples->batchStartNs = bench_now_ns();
+}
+
+void bench_batch_end(BenchSamples* samples, size_t ops)
+{
+    const uint64_t ns = bench_now_ns() - samples->batchStartNs;
+    samples->allocs += bench_alloc_count - samples->batchStartAllocs;
+
+    if (ops == 0)
+    {
+        return;
+    }
+
+    if (samples->nsPerOp != NULL && samples->count < samples->capacity)
+    {
+        samples->nsPerOp[samples->count++] = (double)ns / (double)ops;
+    }
+
+    samples->totalNs += ns;
+    samples->ops += ops;
+}
+
+void bench_report_header(const BenchConfig* config)
+{
+    printf("%-28s %-8s %8s %5s %8s %10s %10s %10s %10s %10s %9s\n",
+           "benchmark", "dist", "size", "klen", "elems", "ns/op", "p50", "p90", "p99", "max", "allocs/op");
+
+    if (config->csv != NULL)
+    {
+        fprintf(config->csv, "benchmark,distribution,table_size,key_len,elements,ops,"
+                             "ns_per_op,p50_ns,p90_ns,p99_ns,max_ns,allocs_per_op\n");
+    }
+}
+
+/*
+    Function: void bench_report(...)
+        Prints one result line (and CSV row if requested) and releases the samples.
+        Percentiles are computed over samples of BENCH_BATCH operations each.
+*/
+void bench_report(const BenchConfig* config, BenchSamples* samples, const char* name,
+                  const char* distribution, size_t tableSize, size_t keyLen, size_t elems)
+{
+    const double ops = samples->ops > 0 ? (double)samples->ops : 1.0;
+    const double mean = (double)samples->totalNs / ops;
+    const double allocsPerOp = (double)samples->allocs / ops;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+
+    if (samples->nsPerOp != NULL && samples->count > 0)
+    {
+        qsort(samples->nsPerOp, samples->count, sizeof(*samples->nsPerOp), compare_double);
+        p50 = percentile(samples->nsPerOp, samples->count, 0.50);
+        p90 = percentile(samples->nsPerOp, samples->count, 0.90);
+        p99 = percentile(samples->nsPerOp, samples->count, 0.99);
+        max = samples->nsPerOp[samples->count - 1];
+    }
+
+    printf("%-28s %-8s %8zu %5zu %8zu %10.1f %10.1f %10.1f %10.1f %10.1f %9.3f\n",
+           name, distribution, tableSize, keyLen, elems, mean, p50, p90, p99, max, allocsPerOp);
+
+    if (config->csv != NULL)
+    {
+        fprintf(config->csv, "%s,%s,%zu,%zu,%zu,%zu,%.2f,%.2f,%.2f,%.2f,%.2f,%.4f\n",
+                name, distribution, tableSize, keyLen, elems, samples->ops,
+                mean, p50, p90, p99, max, allocsPerOp);
+    }
+
+    free(samples->nsPerOp);
+    samples->nsPerOp = NULL;
+}
+
+static int compare_double(const void* a, const void* b)
+{
+    const double x = *(const double*)a;
+    const double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* sorted, size_t count, double p)
+{
+    size_t index = (size_t)(p * (double)(count - 1) + 0.5);
+    if (index >= count)
+    {
+        index = count - 1;
+    }
+    return sorted[index];
+}
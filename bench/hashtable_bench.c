@@ -0,0 +1,1270 @@
+#define _POSIX_C_SOURCE 200809L // pthread_rwlock_t
+#include "bench.h"
+#include <hashtable_module/hashtable.h>
+#include <hashtable_module/hashtable_frozen.h>
+#include <hashtable_module/hashtable_cuckoo.h>
+#include <hashtable_module/hashtable_export.h>
+#include <hashtable_module/hashtable_intern.h>
+#include <hashtable_module/hashtable_radix.h>
+#include <hashtable_module/hashtable_rcu.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <hashtable_module/hashtable_typed.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Anagram keys are permutations of eight letters, their count is limited to keep them distinct
+#define ANAGRAM_MAX_ELEMS 4096
+#define SEARCH_MAX_OPS (1u << 16)
+// Keys passed to one hashTable_search_batch call
+#define SEARCH_BATCH_KEYS 256
+// Table of bench_large, its records, buckets and strings (over 600 MiB) don't fit the 300 MiB L3 of the test machines
+#define LARGE_TABLE_SIZE (1u << 23)
+#define LARGE_KEY_LEN 32
+// TTL workload: keys expire within TTL_MAX_TICKS, time advances by TTL_STEP_TICKS per hashTable_expire call
+#define TTL_MAX_TICKS 4096
+#define TTL_STEP_TICKS 64
+
+// Defined in bench_alloc.c
+HASHTABLE_TYPED_DECLARE(U64, uint64_t, uint64_t)
+
+typedef enum KeyDistribution
+{
+    DIST_UNIFORM,
+    DIST_ZIPF,
+    DIST_ANAGRAM
+} KeyDistribution;
+
+typedef struct BenchKeys
+{
+    char** keys; // first elems keys are inserted, second elems keys are never inserted (misses)
+    char* storage; // one block with all keys
+    size_t elems;
+    size_t keyLen;
+} BenchKeys;
+
+static const char* dist_name(KeyDistribution dist);
+static int keys_generate(BenchKeys* keys, KeyDistribution dist, size_t elems, size_t keyLen, BenchRng* rng);
+static void keys_release(BenchKeys* keys);
+static const char** queries_generate(const BenchKeys* keys, KeyDistribution dist, size_t ops, int miss, BenchRng* rng);
+static HashTable* bench_insert(const BenchConfig* config, const BenchKeys* keys, const char* dist, size_t tableSize);
+static void bench_insert_borrowed(const BenchConfig* config, const BenchKeys* keys, const char* dist, size_t tableSize);
+static void bench_bulk_load(const BenchConfig* config, const BenchKeys* keys, const char* dist, size_t threads);
+static void bench_merge(const BenchConfig* config, const BenchKeys* keys, const char* dist, size_t tableSize, size_t threads);
+static const char* bench_combine_sum(const char* key, const char* present, const char* incoming,
+                                     char* buffer, size_t capacity, void* context);
+static void bench_search(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys,
+                         KeyDistribution dist, int miss, BenchRng* rng);
+static void bench_search_batch(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys,
+                               KeyDistribution dist, int miss, BenchRng* rng);
+static void bench_bloom(const BenchConfig* config, HashTable* ht, const BenchKeys* keys, KeyDistribution dist, BenchRng* rng);
+static void bench_cache(const BenchConfig* config, const BenchKeys* keys, KeyDistribution dist, size_t tableSize, BenchRng* rng);
+static void bench_ttl(const BenchConfig* config, const BenchKeys* keys, size_t tableSize, BenchRng* rng);
+static void bench_typed(const BenchConfig* config, size_t tableSize, BenchRng* rng);
+static void bench_radix(const BenchConfig* config, size_t tableSize, BenchRng* rng);
+static void bench_frozen(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys, BenchRng* rng);
+static void bench_cuckoo(const BenchConfig* config, const BenchKeys* keys, KeyDistribution dist, size_t tableSize, BenchRng* rng);
+static void bench_export(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys);
+static void bench_intern(const BenchConfig* config, const BenchKeys* keys, size_t tableSize, BenchRng* rng);
+static void bench_rcu(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys, BenchRng* rng);
+static void bench_delete(const BenchConfig* config, HashTable* ht, const BenchKeys* keys, const char* dist, BenchRng* rng);
+static void bench_large(const BenchConfig* config, BenchRng* rng);
+
+/*
+    Function: int hashtable_profile(const BenchProfile* profile)
+        Runs just one workload without any timing, to be observed by cachegrind or perf.
+        Baseline run does identical setup (keys, table, queries) and skips the operations,
+        so subtracting its counters leaves the cost of the operations only.
+*/
+int hashtable_profile(const BenchProfile* profile)
+{
+    const int miss = strcmp(profile->workload, "search_miss") == 0 || strcmp(profile->workload, "search_batch_miss") == 0;
+    const int batch = strncmp(profile->workload, "search_batch_", 13) == 0;
+    if (!miss && strcmp(profile->workload, "search_hit") != 0 && strcmp(profile->workload, "search_batch_hit") != 0)
+    {
+        return -1;
+    }
+
+    BenchRng rng;
+    BenchKeys keys;
+    bench_rng_seed(&rng, 42);
+
+    if (profile->tableSize < 2 || profile->ops < 1 ||
+        keys_generate(&keys, DIST_UNIFORM, profile->tableSize / 2, profile->keyLen, &rng) != 0)
+    {
+        return -1;
+    }
+
+    HashTable* ht = hashTable_new(profile->tableSize);
+    const char** queries = queries_generate(&keys, DIST_UNIFORM, profile->ops, miss, &rng);
+    int result = -1;
+
+    if (ht != NULL && queries != NULL)
+    {
+        uintptr_t sink = 0;
+
+        for (size_t i = 0; i < keys.elems; ++i)
+        {
+            hashTable_insert(ht, keys.keys[i], keys.keys[i]);
+        }
+
+        for (size_t i = 0; !profile->baseline && !batch && i < profile->ops; ++i)
+        {
+            const char* value = hashTable_search(ht, queries[i]);
+            sink ^= (uintptr_t)value;
+        }
+
+        for (size_t i = 0; !profile->baseline && batch && i < profile->ops; i += SEARCH_BATCH_KEYS)
+        {
+            const char* values[SEARCH_BATCH_KEYS];
+            const size_t n = i + SEARCH_BATCH_KEYS < profile->ops ? SEARCH_BATCH_KEYS : profile->ops - i;
+            hashTable_search_batch(ht, queries + i, values, n);
+            sink ^= (uintptr_t)values[0];
+        }
+
+        bench_sink ^= sink;
+        result = 0;
+    }
+
+    free(queries);
+    hashTable_delete(ht);
+    keys_release(&keys);
+    return result;
+}
+
+/*
+    Function: void hashtable_bench(const BenchConfig* config)
+        Runs insert/search/delete workloads over all combinations of table size,
+        key length and key distribution. Tables are filled up to the half of their size.
+*/
+void hashtable_bench(const BenchConfig* config)
+{
+    static const size_t fullSizes[] = {1024, 16384, 131072};
+    static const size_t quickSizes[] = {1024, 4096};
+    static const size_t keyLens[] = {8, 32};
+
+    const size_t* sizes = config->quick ? quickSizes : fullSizes;
+    const size_t noOfSizes = config->quick ? sizeof(quickSizes) / sizeof(*quickSizes)
+                                           : sizeof(fullSizes) / sizeof(*fullSizes);
+    BenchRng rng;
+    bench_rng_seed(&rng, 42);
+
+    for (size_t s = 0; s < noOfSizes; ++s)
+    {
+        bench_typed(config, sizes[s], &rng);
+        bench_radix(config, sizes[s], &rng);
+
+        for (size_t k = 0; k < sizeof(keyLens) / sizeof(*keyLens); ++k)
+        {
+            const size_t tableSize = sizes[s];
+            BenchKeys keys;
+
+            // Uniform keys, accessed uniformly and with Zipfian skew
+            if (keys_generate(&keys, DIST_UNIFORM, tableSize / 2, keyLens[k], &rng) == 0)
+            {
+                HashTable* ht = bench_insert(config, &keys, dist_name(DIST_UNIFORM), tableSize);
+                bench_insert_borrowed(config, &keys, dist_name(DIST_UNIFORM), tableSize);
+                bench_bulk_load(config, &keys, dist_name(DIST_UNIFORM), 1);
+                bench_bulk_load(config, &keys, dist_name(DIST_UNIFORM), 4);
+                bench_merge(config, &keys, dist_name(DIST_UNIFORM), tableSize, 1);
+                bench_merge(config, &keys, dist_name(DIST_UNIFORM), tableSize, 4);
+                bench_search(config, ht, &keys, DIST_UNIFORM, 0, &rng);
+                bench_search(config, ht, &keys, DIST_UNIFORM, 1, &rng);
+                bench_search(config, ht, &keys, DIST_ZIPF, 0, &rng);
+                bench_search(config, ht, &keys, DIST_ZIPF, 1, &rng);
+                bench_search_batch(config, ht, &keys, DIST_UNIFORM, 0, &rng);
+                bench_search_batch(config, ht, &keys, DIST_UNIFORM, 1, &rng);
+                bench_bloom(config, ht, &keys, DIST_UNIFORM, &rng);
+                bench_cache(config, &keys, DIST_ZIPF, tableSize, &rng);
+                bench_ttl(config, &keys, tableSize, &rng);
+                bench_frozen(config, ht, &keys, &rng);
+                bench_cuckoo(config, &keys, DIST_UNIFORM, tableSize, &rng);
+                bench_export(config, ht, &keys);
+                bench_intern(config, &keys, tableSize, &rng);
+                bench_rcu(config, ht, &keys, &rng);
+                bench_delete(config, ht, &keys, dist_name(DIST_UNIFORM), &rng);
+                hashTable_delete(ht);
+                keys_release(&keys);
+            }
+
+            // Adversarial keys, all of them land in the same bucket
+            const size_t anagrams = tableSize / 2 < ANAGRAM_MAX_ELEMS ? tableSize / 2 : ANAGRAM_MAX_ELEMS;
+            if (keys_generate(&keys, DIST_ANAGRAM, anagrams, keyLens[k], &rng) == 0)
+            {
+                HashTable* ht = bench_insert(config, &keys, dist_name(DIST_ANAGRAM), tableSize);
+                bench_search(config, ht, &keys, DIST_ANAGRAM, 0, &rng);
+                bench_search(config, ht, &keys, DIST_ANAGRAM, 1, &rng);
+                bench_bloom(config, ht, &keys, DIST_ANAGRAM, &rng);
+                bench_cuckoo(config, &keys, DIST_ANAGRAM, tableSize, &rng);
+                bench_delete(config, ht, &keys, dist_name(DIST_ANAGRAM), &rng);
+                hashTable_delete(ht);
+                keys_release(&keys);
+            }
+        }
+    }
+
+    bench_large(config, &rng);
+}
+
+static const char* dist_name(KeyDistribution dist)
+{
+    switch (dist)
+    {
+        case DIST_UNIFORM: return "uniform";
+        case DIST_ZIPF: return "zipf";
+        case DIST_ANAGRAM: return "anagram";
+        default: return "unknown";
+    }
+}
+
+/*
+    static int keys_generate(...)
+        Generates 2 * elems distinct keys of given length.
+        Uniform keys are random alphanumeric strings ended with a unique base-62 index.
+        Anagram keys are distinct permutations of "abcdefgh" followed by a fixed suffix,
+        so they have equal byte sum, the worst case of a hash which ignores the byte order.
+*/
+static int keys_generate(BenchKeys* keys, KeyDistribution dist, size_t elems, size_t keyLen, BenchRng* rng)
+{
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    const size_t count = 2 * elems;
+
+    keys->elems = elems;
+    keys->keyLen = keyLen;
+    keys->keys = malloc(count * sizeof(*keys->keys));
+    keys->storage = malloc(count * (keyLen + 1));
+    if (keys->keys == NULL || keys->storage == NULL)
+    {
+        keys_release(keys);
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        char* key = keys->storage + i * (keyLen + 1);
+        keys->keys[i] = key;
+
+        if (dist == DIST_ANAGRAM)
+        {
+            // i-th permutation in factorial number system (8! = 40320 distinct keys)
+            char pool[] = "abcdefgh";
+            size_t poolLen = 8;
+            size_t rest = i;
+            size_t factorial = 5040; // 7!
+
+            for (size_t pos = 0; pos < 8; ++pos)
+            {
+                const size_t sel = rest / factorial;
+                rest %= factorial;
+                key[pos] = pool[sel];
+                memmove(&pool[sel], &pool[sel + 1], poolLen - sel);
+                poolLen--;
+                factorial = poolLen > 0 ? factorial / poolLen : 1;
+            }
+            memset(key + 8, 'x', keyLen - 8);
+        }
+        else
+        {
+            size_t index = i;
+            size_t pos = keyLen;
+            do
+            {
+                key[--pos] = alphabet[index % 62];
+                index /= 62;
+            } while (index > 0 && pos > 0);
+
+            while (pos > 0)
+            {
+                key[--pos] = alphabet[bench_rng_below(rng, 62)];
+            }
+        }
+        key[keyLen] = '\0';
+    }
+
+    return 0;
+}
+
+static void keys_release(BenchKeys* keys)
+{
+    free(keys->keys);
+    free(keys->storage);
+    keys->keys = NULL;
+    keys->storage = NULL;
+}
+
+/*
+    static const char** queries_generate(...)
+        Prepares the sequence of searched keys upfront, so drawing random numbers is not measured.
+*/
+static const char** queries_generate(const BenchKeys* keys, KeyDistribution dist, size_t ops, int miss, BenchRng* rng)
+{
+    const char** queries = malloc(ops * sizeof(*queries));
+    if (queries == NULL)
+    {
+        return NULL;
+    }
+
+    BenchZipf* zipf = dist == DIST_ZIPF ? bench_zipf_new(keys->elems, 0.99) : NULL;
+    const size_t offset = miss ? keys->elems : 0;
+
+    for (size_t i = 0; i < ops; ++i)
+    {
+        const size_t index = zipf != NULL ? bench_zipf_next(zipf, rng) : bench_rng_below(rng, keys->elems);
+        queries[i] = keys->keys[offset + index];
+    }
+
+    bench_zipf_delete(zipf);
+    return queries;
+}
+
+static HashTable* bench_insert(const BenchConfig* config, const BenchKeys* keys, const char* dist, size_t tableSize)
+{
+    HashTable* ht = hashTable_new(tableSize);
+    if (ht == NULL)
+    {
+        return NULL;
+    }
+
+    BenchSamples samples;
+    bench_samples_start(&samples, keys->elems);
+
+    for (size_t i = 0; i < keys->elems; i += BENCH_BATCH)
+    {
+        const size_t end = i + BENCH_BATCH < keys->elems ? i + BENCH_BATCH : keys->elems;
+        bench_batch_begin(&samples);
+        for (size_t j = i; j < end; ++j)
+        {
+            hashTable_insert(ht, keys->keys[j], keys->keys[j]);
+        }
+        bench_batch_end(&samples, end - i);
+    }
+
+    if (bench_enabled(config, "hashTable_insert"))
+    {
+        bench_report(config, &samples, "hashTable_insert", dist, tableSize, keys->keyLen, keys->elems);
+    }
+    else
+    {
+        free(samples.nsPerOp);
+    }
+
+    return ht;
+}
+
+/*
+    static void bench_insert_borrowed(...)
+        Same inserts as bench_insert without copying the strings, the keys outlive the table.
+        Compared with hashTable_insert shows the cost of the two string copies (two allocations less per insert).
+*/
+static void bench_insert_borrowed(const BenchConfig* config, const BenchKeys* keys, const char* dist, size_t tableSize)
+{
+    if (!bench_enabled(config, "hashTable_insert_borrowed"))
+    {
+        return;
+    }
+
+    HashTable* ht = hashTable_new(tableSize);
+    if (ht == NULL)
+    {
+        return;
+    }
+
+    BenchSamples samples;
+    bench_samples_start(&samples, keys->elems);
+
+    for (size_t i = 0; i < keys->elems; i += BENCH_BATCH)
+    {
+        const size_t end = i + BENCH_BATCH < keys->elems ? i + BENCH_BATCH : keys->elems;
+        bench_batch_begin(&samples);
+        for (size_t j = i; j < end; ++j)
+        {
+            bench_sink ^= (uintptr_t)hashTable_insert_borrowed(ht, keys->keys[j], keys->keys[j]);
+        }
+        bench_batch_end(&samples, end - i);
+    }
+
+    bench_report(config, &samples, "hashTable_insert_borrowed", dist, tableSize, keys->keyLen, keys->elems);
+    hashTable_delete(ht);
+}
+
+/*
+    static void bench_bulk_load(...)
+        Builds the table of the same keys with hashTable_new_from_arrays, reported per key.
+        Whole build is one sample, so percentiles are not meaningful here.
+*/
+static void bench_bulk_load(const BenchConfig* config, const BenchKeys* keys, const char* dist, size_t threads)
+{
+    const char* name = threads > 1 ? "hashTable_new_from_arrays_mt" : "hashTable_new_from_arrays";
+    if (!bench_enabled(config, name))
+    {
+        return;
+    }
+
+    BenchSamples samples;
+    bench_samples_start(&samples, keys->elems);
+
+    bench_batch_begin(&samples);
+    HashTable* ht = hashTable_new_from_arrays((const char* const*)keys->keys, (const char* const*)keys->keys,
+                                              keys->elems, threads);
+    bench_batch_end(&samples, keys->elems);
+
+    bench_report(config, &samples, name, dist, keys->elems, keys->keyLen, keys->elems);
+    hashTable_delete(ht);
+}
+
+// Number of per-thread tables merged by bench_merge
+#define MERGE_SOURCES 4
+
+/*
+    static void bench_merge(...)
+        Merges MERGE_SOURCES per-thread counter tables of the same keys into a global one, summing the counts,
+        reported per merged record. Then releases the global table with hashTable_delete_parallel, reported per record.
+        Every merge and release is one sample, so percentiles are not meaningful here.
+*/
+static void bench_merge(const BenchConfig* config, const BenchKeys* keys, const char* dist, size_t tableSize, size_t threads)
+{
+    const char* mergeName = threads > 1 ? "hashTable_merge_mt" : "hashTable_merge";
+    const char* deleteName = threads > 1 ? "hashTable_delete_table_mt" : "hashTable_delete_table";
+    if (!bench_enabled(config, mergeName) && !bench_enabled(config, deleteName))
+    {
+        return;
+    }
+
+    HashTable* sources[MERGE_SOURCES];
+    for (size_t s = 0; s < MERGE_SOURCES; ++s)
+    {
+        sources[s] = hashTable_new(tableSize);
+        for (size_t i = 0; sources[s] != NULL && i < keys->elems; ++i)
+        {
+            hashTable_insert(sources[s], keys->keys[i], "1");
+        }
+    }
+
+    BenchSamples samples;
+    for (int round = 0; round < 2; ++round)
+    {
+        HashTable* ht = hashTable_new(tableSize);
+        const int ready = ht != NULL && sources[0] != NULL && sources[1] != NULL && sources[2] != NULL && sources[3] != NULL;
+
+        bench_samples_start(&samples, MERGE_SOURCES * keys->elems);
+        bench_batch_begin(&samples);
+        if (ready)
+        {
+            hashTable_merge(ht, (const HashTable* const*)sources, MERGE_SOURCES, bench_combine_sum, NULL, threads);
+        }
+        bench_batch_end(&samples, MERGE_SOURCES * keys->elems);
+
+        // First round warms up the allocator, only the second one is reported
+        if (ready && round == 1 && bench_enabled(config, mergeName))
+        {
+            bench_report(config, &samples, mergeName, dist, tableSize, keys->keyLen, keys->elems);
+        }
+
+        bench_samples_start(&samples, keys->elems);
+        bench_batch_begin(&samples);
+        hashTable_delete_parallel(ht, threads);
+        bench_batch_end(&samples, keys->elems);
+
+        if (ready && round == 1 && bench_enabled(config, deleteName))
+        {
+            bench_report(config, &samples, deleteName, dist, tableSize, keys->keyLen, keys->elems);
+        }
+    }
+
+    for (size_t s = 0; s < MERGE_SOURCES; ++s)
+    {
+        hashTable_delete(sources[s]);
+    }
+}
+
+// Sums decimal counts of per-thread tables
+static const char* bench_combine_sum(const char* key, const char* present, const char* incoming,
+                                     char* buffer, size_t capacity, void* context)
+{
+    (void)key;
+    (void)context;
+    snprintf(buffer, capacity, "%lu", strtoul(present, NULL, 10) + strtoul(incoming, NULL, 10));
+    return buffer;
+}
+
+static void bench_search(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys,
+                         KeyDistribution dist, int miss, BenchRng* rng)
+{
+    const char* name = ht != NULL && ht->bloom != NULL ? (miss ? "hashTable_bloom_search_miss" : "hashTable_bloom_search_hit")
+                                                       : (miss ? "hashTable_search_miss" : "hashTable_search_hit");
+    if (ht == NULL || !bench_enabled(config, name))
+    {
+        return;
+    }
+
+    const size_t ops = keys->elems < SEARCH_MAX_OPS ? keys->elems : SEARCH_MAX_OPS;
+    const char** queries = queries_generate(keys, dist, ops, miss, rng);
+    if (queries == NULL)
+    {
+        return;
+    }
+
+    BenchSamples samples;
+    uintptr_t sink = 0;
+    bench_samples_start(&samples, ops);
+
+    for (size_t i = 0; i < ops; i += BENCH_BATCH)
+    {
+        const size_t end = i + BENCH_BATCH < ops ? i + BENCH_BATCH : ops;
+        bench_batch_begin(&samples);
+        for (size_t j = i; j < end; ++j)
+        {
+            const char* value = hashTable_search(ht, queries[j]);
+            sink ^= (uintptr_t)value;
+        }
+        bench_batch_end(&samples, end - i);
+    }
+
+    bench_sink ^= sink;
+    bench_report(config, &samples, name, dist_name(dist), ht->size, keys->keyLen, keys->elems);
+    free(queries);
+}
+
+/*
+    static void bench_large(...)
+        Single and batched lookups in a table bigger than the last level cache, so nearly every
+        lookup misses the cache and the batch can overlap the misses. Skipped by the quick run.
+*/
+static void bench_large(const BenchConfig* config, BenchRng* rng)
+{
+    if (config->quick || (!bench_enabled(config, "hashTable_search_hit") && !bench_enabled(config, "hashTable_search_miss") &&
+                          !bench_enabled(config, "hashTable_search_batch_hit") && !bench_enabled(config, "hashTable_search_batch_miss")))
+    {
+        return;
+    }
+
+    BenchKeys keys;
+    if (keys_generate(&keys, DIST_UNIFORM, LARGE_TABLE_SIZE / 2, LARGE_KEY_LEN, rng) != 0)
+    {
+        return;
+    }
+
+    HashTable* ht = hashTable_new(LARGE_TABLE_SIZE);
+    for (size_t i = 0; ht != NULL && i < keys.elems; ++i)
+    {
+        hashTable_insert(ht, keys.keys[i], keys.keys[i]);
+    }
+
+    bench_search(config, ht, &keys, DIST_UNIFORM, 0, rng);
+    bench_search(config, ht, &keys, DIST_UNIFORM, 1, rng);
+    bench_search_batch(config, ht, &keys, DIST_UNIFORM, 0, rng);
+    bench_search_batch(config, ht, &keys, DIST_UNIFORM, 1, rng);
+    hashTable_delete(ht);
+    keys_release(&keys);
+}
+
+/*
+    static void bench_search_batch(...)
+        Same queries as bench_search, resolved by hashTable_search_batch in chunks of SEARCH_BATCH_KEYS.
+        One sample is one call, so percentiles are per op averaged over the chunk.
+*/
+static void bench_search_batch(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys,
+                               KeyDistribution dist, int miss, BenchRng* rng)
+{
+    const char* name = miss ? "hashTable_search_batch_miss" : "hashTable_search_batch_hit";
+    if (ht == NULL || !bench_enabled(config, name))
+    {
+        return;
+    }
+
+    const size_t ops = keys->elems < SEARCH_MAX_OPS ? keys->elems : SEARCH_MAX_OPS;
+    const char** queries = queries_generate(keys, dist, ops, miss, rng);
+    if (queries == NULL)
+    {
+        return;
+    }
+
+    BenchSamples samples;
+    uintptr_t sink = 0;
+    const char* values[SEARCH_BATCH_KEYS];
+    bench_samples_start(&samples, ops);
+
+    for (size_t i = 0; i < ops; i += SEARCH_BATCH_KEYS)
+    {
+        const size_t n = i + SEARCH_BATCH_KEYS < ops ? SEARCH_BATCH_KEYS : ops - i;
+        bench_batch_begin(&samples);
+        hashTable_search_batch(ht, queries + i, values, n);
+        bench_batch_end(&samples, n);
+        sink ^= (uintptr_t)values[n - 1];
+    }
+
+    bench_sink ^= sink;
+    bench_report(config, &samples, name, dist_name(dist), ht->size, keys->keyLen, keys->elems);
+    free(queries);
+}
+
+/*
+    static void bench_bloom(...)
+        Enables the counting Bloom filter (reported per key) and repeats hit and miss lookups through it.
+        The filter is disabled afterwards, so following workloads run on the plain table.
+*/
+static void bench_bloom(const BenchConfig* config, HashTable* ht, const BenchKeys* keys, KeyDistribution dist, BenchRng* rng)
+{
+    if (ht == NULL || !bench_enabled(config, "hashTable_bloom"))
+    {
+        return;
+    }
+
+    BenchSamples samples;
+    bench_samples_start(&samples, keys->elems);
+    bench_batch_begin(&samples);
+    const int enabled = hashTable_bloom_enable(ht, 0, HASHTABLE_BLOOM_COUNTING) == 0;
+    bench_batch_end(&samples, keys->elems);
+    bench_report(config, &samples, "hashTable_bloom_enable", dist_name(dist), ht->size, keys->keyLen, keys->elems);
+
+    if (enabled)
+    {
+        bench_search(config, ht, keys, dist, 0, rng);
+        bench_search(config, ht, keys, dist, 1, rng);
+    }
+
+    hashTable_bloom_disable(ht);
+}
+
+/*
+    static void bench_cache(...)
+        Table in cache mode with room for a quarter of the keys, every query is a lookup
+        followed by an insert on miss (which evicts). Reported per query.
+*/
+static void bench_cache(const BenchConfig* config, const BenchKeys* keys, KeyDistribution dist, size_t tableSize, BenchRng* rng)
+{
+    if (!bench_enabled(config, "hashTable_cache"))
+    {
+        return;
+    }
+
+    HashTable* ht = hashTable_new(tableSize);
+    const size_t ops = keys->elems < SEARCH_MAX_OPS ? keys->elems : SEARCH_MAX_OPS;
+    const char** queries = queries_generate(keys, dist, ops, 0, rng);
+    if (ht == NULL || queries == NULL || hashTable_cache_enable(ht, keys->elems / 4 + 1, 0) != 0)
+    {
+        free(queries);
+        hashTable_delete(ht);
+        return;
+    }
+
+    BenchSamples samples;
+    uintptr_t sink = 0;
+    bench_samples_start(&samples, ops);
+
+    for (size_t i = 0; i < ops; i += BENCH_BATCH)
+    {
+        const size_t end = i + BENCH_BATCH < ops ? i + BENCH_BATCH : ops;
+        bench_batch_begin(&samples);
+        for (size_t j = i; j < end; ++j)
+        {
+            const char* value = hashTable_search(ht, queries[j]);
+            if (value == NULL)
+            {
+                hashTable_insert(ht, queries[j], queries[j]);
+            }
+            sink ^= (uintptr_t)value;
+        }
+        bench_batch_end(&samples, end - i);
+    }
+
+    bench_sink ^= sink;
+    bench_report(config, &samples, "hashTable_cache_get_or_insert", dist_name(dist), tableSize, keys->keyLen, keys->elems);
+    free(queries);
+    hashTable_delete(ht);
+}
+
+/*
+    static void bench_ttl(...)
+        Inserts all keys with random TTL up to TTL_MAX_TICKS, then advances the time by TTL_STEP_TICKS
+        until everything expires. Expire is reported per deleted record, one sample per tick
+        (a tick which deletes nothing counts as one op).
+*/
+static void bench_ttl(const BenchConfig* config, const BenchKeys* keys, size_t tableSize, BenchRng* rng)
+{
+    if (!bench_enabled(config, "hashTable_ttl"))
+    {
+        return;
+    }
+
+    HashTable* ht = hashTable_new(tableSize);
+    if (ht == NULL)
+    {
+        return;
+    }
+
+    BenchSamples samples;
+    bench_samples_start(&samples, keys->elems);
+    for (size_t i = 0; i < keys->elems; i += BENCH_BATCH)
+    {
+        const size_t end = i + BENCH_BATCH < keys->elems ? i + BENCH_BATCH : keys->elems;
+        uint64_t ttls[BENCH_BATCH];
+        for (size_t j = i; j < end; ++j)
+        {
+            ttls[j - i] = 1 + bench_rng_below(rng, TTL_MAX_TICKS);
+        }
+
+        bench_batch_begin(&samples);
+        for (size_t j = i; j < end; ++j)
+        {
+            hashTable_insert_ttl(ht, keys->keys[j], keys->keys[j], ttls[j - i]);
+        }
+        bench_batch_end(&samples, end - i);
+    }
+    bench_report(config, &samples, "hashTable_ttl_insert", "uniform", tableSize, keys->keyLen, keys->elems);
+
+    bench_samples_start(&samples, keys->elems);
+    for (uint64_t now = TTL_STEP_TICKS; ht->noOfElems > 0; now += TTL_STEP_TICKS)
+    {
+        bench_batch_begin(&samples);
+        const size_t deleted = hashTable_expire(ht, now, SIZE_MAX);
+        bench_batch_end(&samples, deleted > 0 ? deleted : 1);
+    }
+    bench_report(config, &samples, "hashTable_ttl_expire", "uniform", tableSize, keys->keyLen, keys->elems);
+
+    hashTable_delete(ht);
+}
+
+/*
+    static void bench_typed(...)
+        Integer keys in the typed table generated by HASHTABLE_TYPED_INIT2 compared with
+        the same keys printed as decimal strings in HashTable. Reported per op.
+*/
+static void bench_typed(const BenchConfig* config, size_t tableSize, BenchRng* rng)
+{
+    if (!bench_enabled(config, "hashTableU64") && !bench_enabled(config, "hashTable_u64_as_string"))
+    {
+        return;
+    }
+
+    const size_t elems = tableSize / 2;
+    uint64_t* keys = malloc(elems * sizeof(*keys));
+    char* strings = malloc(elems * 24);
+    size_t* order = malloc(elems * sizeof(*order));
+    HashTableU64* typed = hashTableU64_new(elems);
+    HashTable* ht = hashTable_new(tableSize);
+
+    if (keys != NULL && strings != NULL && order != NULL && typed != NULL && ht != NULL)
+    {
+        for (size_t i = 0; i < elems; ++i)
+        {
+            // Odd multiplier is a bijection, so keys are distinct
+            keys[i] = (uint64_t)(i + 1) * 0x9E3779B97F4A7C15u;
+            snprintf(strings + i * 24, 24, "%llu", (unsigned long long)keys[i]);
+            order[i] = i;
+        }
+        bench_shuffle(rng, order, elems);
+
+        BenchSamples samples;
+        uintptr_t sink = 0;
+
+        bench_samples_start(&samples, elems);
+        for (size_t i = 0; i < elems; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < elems ? i + BENCH_BATCH : elems;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                hashTableU64_insert(typed, keys[j], keys[j]);
+            }
+            bench_batch_end(&samples, end - i);
+        }
+        bench_report(config, &samples, "hashTableU64_insert", "uniform", tableSize, sizeof(uint64_t), elems);
+
+        bench_samples_start(&samples, elems);
+        for (size_t i = 0; i < elems; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < elems ? i + BENCH_BATCH : elems;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                const uint64_t* value = hashTableU64_search(typed, keys[order[j]]);
+                sink ^= (uintptr_t)value;
+            }
+            bench_batch_end(&samples, end - i);
+        }
+        bench_report(config, &samples, "hashTableU64_search_hit", "uniform", tableSize, sizeof(uint64_t), elems);
+
+        bench_samples_start(&samples, elems);
+        for (size_t i = 0; i < elems; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < elems ? i + BENCH_BATCH : elems;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                hashTable_insert(ht, strings + j * 24, strings + j * 24);
+            }
+            bench_batch_end(&samples, end - i);
+        }
+        bench_report(config, &samples, "hashTable_u64_as_string_insert", "uniform", tableSize, 20, elems);
+
+        bench_samples_start(&samples, elems);
+        for (size_t i = 0; i < elems; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < elems ? i + BENCH_BATCH : elems;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                const char* value = hashTable_search(ht, strings + order[j] * 24);
+                sink ^= (uintptr_t)value;
+            }
+            bench_batch_end(&samples, end - i);
+        }
+        bench_report(config, &samples, "hashTable_u64_as_string_search_hit", "uniform", tableSize, 20, elems);
+
+        bench_sink ^= sink;
+    }
+
+    hashTable_delete(ht);
+    hashTableU64_delete(typed);
+    free(order);
+    free(strings);
+    free(keys);
+}
+
+/*
+    static void bench_radix(...)
+        Resolves levels of categories four segments deep, whose services and some of their modules
+        are configured. The radix tree resolves by one walk, HashTable needs a search of every prefix
+        from the longest one. Reported per op.
+*/
+static void bench_radix(const BenchConfig* config, size_t tableSize, BenchRng* rng)
+{
+    if (!bench_enabled(config, "hashTableRadix") && !bench_enabled(config, "hashTable_prefix"))
+    {
+        return;
+    }
+
+    const size_t ops = tableSize < SEARCH_MAX_OPS ? tableSize : SEARCH_MAX_OPS;
+    const size_t services = tableSize / 64 + 1;
+    char* queries = malloc(ops * 48);
+    HashTableRadix* tree = hashTableRadix_new(0);
+    HashTable* ht = hashTable_new(tableSize);
+
+    if (queries != NULL && tree != NULL && ht != NULL)
+    {
+        char category[48];
+        for (size_t i = 0; i < services; ++i)
+        {
+            snprintf(category, sizeof(category), "service%zu", i);
+            hashTableRadix_set(tree, category, 1);
+            hashTable_insert(ht, category, "1");
+
+            snprintf(category, sizeof(category), "service%zu.module%zu", i, i % 8);
+            hashTableRadix_set(tree, category, 2);
+            hashTable_insert(ht, category, "2");
+        }
+
+        for (size_t i = 0; i < ops; ++i)
+        {
+            snprintf(queries + i * 48, 48, "service%zu.module%zu.class%zu.method%zu", bench_rng_below(rng, services),
+                     bench_rng_below(rng, 8), bench_rng_below(rng, 16), bench_rng_below(rng, 4));
+        }
+
+        BenchSamples samples;
+        uintptr_t sink = 0;
+
+        bench_samples_start(&samples, ops);
+        for (size_t i = 0; i < ops; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < ops ? i + BENCH_BATCH : ops;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                sink ^= (uintptr_t)hashTableRadix_resolve(tree, queries + j * 48);
+            }
+            bench_batch_end(&samples, end - i);
+        }
+        bench_report(config, &samples, "hashTableRadix_resolve", "uniform", tableSize, 40, 2 * services);
+
+        bench_samples_start(&samples, ops);
+        for (size_t i = 0; i < ops; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < ops ? i + BENCH_BATCH : ops;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                strcpy(category, queries + j * 48);
+                const char* level = hashTable_search(ht, category);
+                for (char* separator = strrchr(category, '.'); level == NULL && separator != NULL;
+                     separator = strrchr(category, '.'))
+                {
+                    *separator = '\0';
+                    level = hashTable_search(ht, category);
+                }
+                sink ^= (uintptr_t)level;
+            }
+            bench_batch_end(&samples, end - i);
+        }
+        bench_report(config, &samples, "hashTable_prefix_resolve", "uniform", tableSize, 40, 2 * services);
+
+        bench_sink ^= sink;
+    }
+
+    hashTable_delete(ht);
+    hashTableRadix_delete(tree);
+    free(queries);
+}
+
+/*
+    static void bench_frozen(...)
+        Freezes the table (reported per key) and runs uniform hit and miss lookups on the frozen copy.
+*/
+static void bench_frozen(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys, BenchRng* rng)
+{
+    if (ht == NULL || !bench_enabled(config, "hashTableFrozen"))
+    {
+        return;
+    }
+
+    BenchSamples samples;
+    bench_samples_start(&samples, keys->elems);
+    bench_batch_begin(&samples);
+    HashTableFrozen* frozen = hashTable_freeze(ht);
+    bench_batch_end(&samples, keys->elems);
+    bench_report(config, &samples, "hashTableFrozen_freeze", "uniform", ht->size, keys->keyLen, keys->elems);
+
+    const size_t ops = keys->elems < SEARCH_MAX_OPS ? keys->elems : SEARCH_MAX_OPS;
+    for (int miss = 0; frozen != NULL && miss < 2; ++miss)
+    {
+        const char** queries = queries_generate(keys, DIST_UNIFORM, ops, miss, rng);
+        if (queries == NULL)
+        {
+            break;
+        }
+
+        uintptr_t sink = 0;
+        bench_samples_start(&samples, ops);
+        for (size_t i = 0; i < ops; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < ops ? i + BENCH_BATCH : ops;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                const char* value = hashTableFrozen_search(frozen, queries[j]);
+                sink ^= (uintptr_t)value;
+            }
+            bench_batch_end(&samples, end - i);
+        }
+
+        bench_sink ^= sink;
+        bench_report(config, &samples, miss ? "hashTableFrozen_search_miss" : "hashTableFrozen_search_hit",
+                     "uniform", ht->size, keys->keyLen, keys->elems);
+        free(queries);
+    }
+
+    hashTableFrozen_delete(frozen);
+}
+
+/*
+    static void bench_cuckoo(...)
+        Same inserts and hit and miss lookups on HashTableCuckoo. Every lookup reads at most two buckets,
+        so its p99 and max stay flat.
+*/
+static void bench_cuckoo(const BenchConfig* config, const BenchKeys* keys, KeyDistribution dist, size_t tableSize, BenchRng* rng)
+{
+    if (!bench_enabled(config, "hashTableCuckoo"))
+    {
+        return;
+    }
+
+    HashTableCuckoo* cuckoo = hashTableCuckoo_new(tableSize);
+    if (cuckoo == NULL)
+    {
+        return;
+    }
+
+    BenchSamples samples;
+    bench_samples_start(&samples, keys->elems);
+    for (size_t i = 0; i < keys->elems; i += BENCH_BATCH)
+    {
+        const size_t end = i + BENCH_BATCH < keys->elems ? i + BENCH_BATCH : keys->elems;
+        bench_batch_begin(&samples);
+        for (size_t j = i; j < end; ++j)
+        {
+            hashTableCuckoo_insert(cuckoo, keys->keys[j], keys->keys[j]);
+        }
+        bench_batch_end(&samples, end - i);
+    }
+    bench_report(config, &samples, "hashTableCuckoo_insert", dist_name(dist), tableSize, keys->keyLen, keys->elems);
+
+    const size_t ops = keys->elems < SEARCH_MAX_OPS ? keys->elems : SEARCH_MAX_OPS;
+    for (int miss = 0; miss < 2; ++miss)
+    {
+        const char** queries = queries_generate(keys, dist, ops, miss, rng);
+        if (queries == NULL)
+        {
+            break;
+        }
+
+        uintptr_t sink = 0;
+        bench_samples_start(&samples, ops);
+        for (size_t i = 0; i < ops; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < ops ? i + BENCH_BATCH : ops;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                const char* value = hashTableCuckoo_search(cuckoo, queries[j]);
+                sink ^= (uintptr_t)value;
+            }
+            bench_batch_end(&samples, end - i);
+        }
+
+        bench_sink ^= sink;
+        bench_report(config, &samples, miss ? "hashTableCuckoo_search_miss" : "hashTableCuckoo_search_hit",
+                     dist_name(dist), tableSize, keys->keyLen, keys->elems);
+        free(queries);
+    }
+
+    hashTableCuckoo_delete(cuckoo);
+}
+
+/*
+    static void bench_export(...)
+        Exports the whole table to /dev/null in every format (reported per record), compared with
+        the fprintf per record which hashTable_print does.
+*/
+static void bench_export(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys)
+{
+    static const char* const names[] = {"hashTable_export_text", "hashTable_export_tsv", "hashTable_export_jsonl"};
+    static const int formats[] = {HASHTABLE_EXPORT_TEXT, HASHTABLE_EXPORT_TSV, HASHTABLE_EXPORT_JSONL};
+
+    if (ht == NULL || !bench_enabled(config, "hashTable_export"))
+    {
+        return;
+    }
+
+    const int fd = open("/dev/null", O_WRONLY);
+    FILE* file = fopen("/dev/null", "w");
+    if (fd < 0 || file == NULL)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        return;
+    }
+
+    BenchSamples samples;
+    for (size_t f = 0; f < sizeof(formats) / sizeof(*formats); ++f)
+    {
+        bench_samples_start(&samples, keys->elems);
+        bench_batch_begin(&samples);
+        bench_sink ^= (uintptr_t)hashTable_export_fd(ht, fd, formats[f], NULL, 0);
+        bench_batch_end(&samples, keys->elems);
+        bench_report(config, &samples, names[f], "uniform", ht->size, keys->keyLen, keys->elems);
+    }
+
+    HashTableIterator iterator;
+    bench_samples_start(&samples, keys->elems);
+    bench_batch_begin(&samples);
+    hashTable_iterator_init(&iterator, ht);
+    for (const Record* record = hashTable_iterator_next(&iterator); record != NULL; record = hashTable_iterator_next(&iterator))
+    {
+        fprintf(file, "Key: %s, Value: %s\n", record_key(record), record_value(record));
+    }
+    fflush(file);
+    bench_batch_end(&samples, keys->elems);
+    bench_report(config, &samples, "hashTable_export_fprintf", "uniform", ht->size, keys->keyLen, keys->elems);
+
+    fclose(file);
+    close(fd);
+}
+
+/*
+    static void bench_intern(...)
+        Interns every key twice (new strings, then already interned ones) and searches a table
+        holding the canonical pointers by those pointers, compared with the same lookups by copies of the keys.
+*/
+static void bench_intern(const BenchConfig* config, const BenchKeys* keys, size_t tableSize, BenchRng* rng)
+{
+    static const char* const names[] = {"hashTableIntern_get_new", "hashTableIntern_get_hit"};
+
+    if (!bench_enabled(config, "hashTableIntern"))
+    {
+        return;
+    }
+
+    HashTableInternPool* pool = hashTableIntern_new(keys->elems, 0);
+    HashTable* ht = hashTable_new(tableSize);
+    const char** handles = malloc(keys->elems * sizeof(*handles));
+    if (pool == NULL || ht == NULL || handles == NULL)
+    {
+        hashTableIntern_delete(pool);
+        hashTable_delete(ht);
+        free(handles);
+        return;
+    }
+
+    BenchSamples samples;
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+        bench_samples_start(&samples, keys->elems);
+        for (size_t i = 0; i < keys->elems; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < keys->elems ? i + BENCH_BATCH : keys->elems;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                handles[j] = hashTableIntern_get(pool, keys->keys[j]);
+            }
+            bench_batch_end(&samples, end - i);
+        }
+        bench_report(config, &samples, names[pass], "uniform", tableSize, keys->keyLen, keys->elems);
+    }
+
+    for (size_t i = 0; i < keys->elems; ++i)
+    {
+        hashTable_insert_borrowed(ht, handles[i], handles[i]);
+    }
+
+    const size_t ops = keys->elems < SEARCH_MAX_OPS ? keys->elems : SEARCH_MAX_OPS;
+    const char** queries = queries_generate(keys, DIST_UNIFORM, ops, 0, rng);
+    for (int interned = 0; queries != NULL && interned < 2; ++interned)
+    {
+        // Queries point to the generated keys, interned ones are replaced by their canonical pointers
+        for (size_t i = 0; interned && i < ops; ++i)
+        {
+            queries[i] = hashTableIntern_find(pool, queries[i]);
+        }
+
+        uintptr_t sink = 0;
+        bench_samples_start(&samples, ops);
+        for (size_t i = 0; i < ops; i += BENCH_BATCH)
+        {
+            const size_t end = i + BENCH_BATCH < ops ? i + BENCH_BATCH : ops;
+            bench_batch_begin(&samples);
+            for (size_t j = i; j < end; ++j)
+            {
+                const char* value = hashTable_search(ht, queries[j]);
+                sink ^= (uintptr_t)value;
+            }
+            bench_batch_end(&samples, end - i);
+        }
+
+        bench_sink ^= sink;
+        bench_report(config, &samples, interned ? "hashTable_search_interned" : "hashTable_search_copy",
+                     "uniform", tableSize, keys->keyLen, keys->elems);
+    }
+
+    free(queries);
+    free(handles);
+    hashTable_delete(ht);
+    hashTableIntern_delete(pool);
+}
+
+/*
+    static void bench_rcu(...)
+        Loads the table into HashTableRcu (reported per key), then runs hit lookups each in its own read section,
+        publishes versions with one changed key and reloads the unchanged table, in which every bucket is shared.
+*/
+static void bench_rcu(const BenchConfig* config, const HashTable* ht, const BenchKeys* keys, BenchRng* rng)
+{
+    if (ht == NULL || !bench_enabled(config, "hashTableRcu"))
+    {
+        return;
+    }
+
+    HashTableRcu* rcu = hashTableRcu_new(ht->size);
+    HashTableRcuReader* reader = hashTableRcu_reader_register(rcu);
+    const size_t ops = keys->elems < SEARCH_MAX_OPS ? keys->elems : SEARCH_MAX_OPS;
+    const char** queries = queries_generate(keys, DIST_UNIFORM, ops, 0, rng);
+    if (rcu == NULL || reader == NULL || queries == NULL)
+    {
+        free(queries);
+        hashTableRcu_delete(rcu);
+        return;
+    }
+
+    BenchSamples samples;
+    for (int reload = 0; reload < 2; ++reload)
+    {
+        bench_samples_start(&samples, keys->elems);
+        bench_batch_begin(&samples);
+        hashTableRcu_begin(rcu);
+        hashTableRcu_load(rcu, ht);
+        hashTableRcu_publish(rcu);
+        bench_batch_end(&samples, keys->elems);
+        bench_report(config, &samples, reload ? "hashTableRcu_reload_unchanged" : "hashTableRcu_load",
+                     "uniform", ht->size, keys->keyLen, keys->elems);
+    }
+
+    uintptr_t sink = 0;
+    bench_samples_start(&samples, ops);
+    for (size_t i = 0; i < ops; i += BENCH_BATCH)
+    {
+        const size_t end = i + BENCH_BATCH < ops ? i + BENCH_BATCH : ops;
+        bench_batch_begin(&samples);
+        for (size_t j = i; j < end; ++j)
+        {
+            const char* value = hashTableRcuVersion_search(hashTableRcu_read_lock(reader), queries[j]);
+            sink ^= (uintptr_t)value;
+            hashTableRcu_read_unlock(reader);
+        }
+        bench_batch_end(&samples, end - i);
+    }
+    bench_sink ^= sink;
+    bench_report(config, &samples, "hashTableRcu_search_hit", "uniform", ht->size, keys->keyLen, keys->elems);
+
+    const size_t updates = ops < 1024 ? ops : 1024;
+    bench_samples_start(&samples, updates);
+    for (size_t i = 0; i < updates; i += BENCH_BATCH)
+    {
+        const size_t end = i + BENCH_BATCH < updates ? i + BENCH_BATCH : updates;
+        bench_batch_begin(&samples);
+        for (size_t j = i; j < end; ++j)
+        {
+            hashTableRcu_begin(rcu);
+            hashTableRcu_insert(rcu, queries[j], "updated");
+            hashTableRcu_publish(rcu);
+        }
+        bench_batch_end(&samples, end - i);
+    }
+    bench_report(config, &samples, "hashTableRcu_update_one", "uniform", ht->size, keys->keyLen, keys->elems);
+
+    free(queries);
+    hashTableRcu_reader_unregister(reader);
+    hashTableRcu_delete(rcu);
+}
+
+static void bench_delete(const BenchConfig* config, HashTable* ht, const BenchKeys* keys, const char* dist, BenchRng* rng)
+{
+    if (ht == NULL || !bench_enabled(config, "hashTable_delete_record"))
+    {
+        return;
+    }
+
+    size_t* order = malloc(keys->elems * sizeof(*order));
+    if (order == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < keys->elems; ++i)
+    {
+        order[i] = i;
+    }
+    bench_shuffle(rng, order, keys->elems);
+
+    BenchSamples samples;
+    bench_samples_start(&samples, keys->elems);
+
+    for (size_t i = 0; i < keys->elems; i += BENCH_BATCH)
+    {
+        const size_t end = i + BENCH_BATCH < keys->elems ? i + BENCH_BATCH : keys->elems;
+        bench_batch_begin(&samples);
+        for (size_t j = i; j < end; ++j)
+        {
+            hashTable_delete_record(ht, keys->keys[order[j]]);
+        }
+        bench_batch_end(&samples, end - i);
+    }
+
+    bench_report(config, &samples, "hashTable_delete_record", dist, ht->size, keys->keyLen, keys->elems);
+    free(order);
+}
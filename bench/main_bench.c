@@ -0,0 +1,102 @@
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void usage(const char* program);
+
+/*
+    Usage: bench.out [-o results.csv] [-f filter] [-q]
+        -o  additionally write results as CSV to given file
+        -f  run only benchmarks which name contains given string (e.g. -f hashTable_search)
+        -q  quick run with small sizes only
+
+    Usage: bench.out -p workload [-s table size] [-k key length] [-n ops] [-b]
+        -p  run single workload (search_hit, search_miss, search_batch_hit, search_batch_miss)
+            without measuring, for profilers
+        -b  baseline run, same setup but the workload operations are skipped
+*/
+int main(int argc, char** argv)
+{
+    BenchConfig config = {NULL, NULL, 0};
+    BenchProfile profile = {NULL, 131072, 16, 100000, 0};
+    const char* csvPath = NULL;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            csvPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+        {
+            config.filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "-q") == 0)
+        {
+            config.quick = 1;
+        }
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+        {
+            profile.workload = argv[++i];
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            profile.tableSize = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+        {
+            profile.keyLen = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            profile.ops = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-b") == 0)
+        {
+            profile.baseline = 1;
+        }
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (profile.workload != NULL)
+    {
+        if (hashtable_profile(&profile) != 0)
+        {
+            fprintf(stderr, "Unknown workload or invalid parameters: %s\n", profile.workload);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (csvPath != NULL)
+    {
+        config.csv = fopen(csvPath, "w");
+        if (config.csv == NULL)
+        {
+            fprintf(stderr, "Cannot open %s\n", csvPath);
+            return 1;
+        }
+    }
+
+    bench_report_header(&config);
+    hashtable_bench(&config);
+    nodelist_bench(&config);
+
+    if (config.csv != NULL)
+    {
+        fclose(config.csv);
+    }
+
+    return 0;
+}
+
+static void usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [-o results.csv] [-f filter] [-q]\n", program);
+    fprintf(stderr, "       %s -p search_hit|search_miss|search_batch_hit|search_batch_miss [-s table size] [-k key length] [-n ops] [-b]\n", program);
+}
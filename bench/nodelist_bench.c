@@ -0,0 +1,281 @@
+#include "bench.h"
+#include <nodelist_module/nodelist.h>
+#include <nodelist_module/unrolledlist.h>
+#include <stdlib.h>
+
+static void bench_list(const BenchConfig* config, size_t length, BenchRng* rng);
+static void bench_unrolled_list(const BenchConfig* config, size_t length, BenchRng* rng);
+static void bench_traverse(const BenchConfig* config, size_t length);
+
+/*
+    Function: void nodelist_bench(const BenchConfig* config)
+        Measures building a list with nodeList_insert and tearing it down with nodeList_node_delete,
+        both from the head (best case) and in random order (walks half of the list on average).
+        The same is measured for UnrolledList, together with a full walk over both lists.
+*/
+void nodelist_bench(const BenchConfig* config)
+{
+    static const size_t fullLengths[] = {16, 256, 4096};
+    static const size_t quickLengths[] = {16, 256};
+
+    const size_t* lengths = config->quick ? quickLengths : fullLengths;
+    const size_t noOfLengths = config->quick ? sizeof(quickLengths) / sizeof(*quickLengths)
+                                             : sizeof(fullLengths) / sizeof(*fullLengths);
+    BenchRng rng;
+    bench_rng_seed(&rng, 7);
+
+    for (size_t i = 0; i < noOfLengths; ++i)
+    {
+        bench_list(config, lengths[i], &rng);
+        bench_unrolled_list(config, lengths[i], &rng);
+        bench_traverse(config, lengths[i]);
+    }
+}
+
+static void bench_list(const BenchConfig* config, size_t length, BenchRng* rng)
+{
+    // Lists are rebuilt several times, so short lists give enough samples as well
+    const size_t rounds = length < 4096 ? 4096 / length : 1;
+    size_t* data = malloc(length * sizeof(*data));
+    size_t* order = malloc(length * sizeof(*order));
+    if (data == NULL || order == NULL)
+    {
+        free(data);
+        free(order);
+        return;
+    }
+
+    BenchSamples samples;
+    NodeList* head = NULL;
+
+    if (bench_enabled(config, "nodeList_insert"))
+    {
+        bench_samples_start(&samples, rounds * length);
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            head = nodeList_new(&data[0]);
+            for (size_t i = 1; i < length; i += BENCH_BATCH)
+            {
+                const size_t end = i + BENCH_BATCH < length ? i + BENCH_BATCH : length;
+                bench_batch_begin(&samples);
+                for (size_t j = i; j < end; ++j)
+                {
+                    nodeList_insert(&head, &data[j]);
+                }
+                bench_batch_end(&samples, end - i);
+            }
+            nodeList_delete(&head);
+        }
+        bench_report(config, &samples, "nodeList_insert", "head", length, 0, length);
+    }
+
+    // Delete in the reverse order of insertion, so the deleted node is always the head,
+    // then in random order, which walks half of the list on average
+    for (int random = 0; random < 2; ++random)
+    {
+        const char* name = random ? "nodeList_node_delete" : "nodeList_node_delete_head";
+        if (!bench_enabled(config, name))
+        {
+            continue;
+        }
+
+        bench_samples_start(&samples, rounds * length);
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            head = nodeList_new(&data[0]);
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (i > 0)
+                {
+                    nodeList_insert(&head, &data[i]);
+                }
+                order[i] = length - 1 - i;
+            }
+
+            if (random)
+            {
+                bench_shuffle(rng, order, length);
+            }
+
+            for (size_t i = 0; i < length; i += BENCH_BATCH)
+            {
+                const size_t end = i + BENCH_BATCH < length ? i + BENCH_BATCH : length;
+                bench_batch_begin(&samples);
+                for (size_t j = i; j < end; ++j)
+                {
+                    nodeList_node_delete(&head, &data[order[j]]);
+                }
+                bench_batch_end(&samples, end - i);
+            }
+        }
+        bench_report(config, &samples, name, random ? "random" : "head", length, 0, length);
+    }
+
+    free(data);
+    free(order);
+}
+
+/*
+    static void bench_unrolled_list(const BenchConfig* config, size_t length, BenchRng* rng)
+        Same workloads as bench_list for UnrolledList, reported under unrolledList_* names.
+*/
+static void bench_unrolled_list(const BenchConfig* config, size_t length, BenchRng* rng)
+{
+    const size_t rounds = length < 4096 ? 4096 / length : 1;
+    size_t* data = malloc(length * sizeof(*data));
+    size_t* order = malloc(length * sizeof(*order));
+    if (data == NULL || order == NULL)
+    {
+        free(data);
+        free(order);
+        return;
+    }
+
+    BenchSamples samples;
+    UnrolledList* head = NULL;
+
+    if (bench_enabled(config, "unrolledList_insert"))
+    {
+        bench_samples_start(&samples, rounds * length);
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            head = unrolledList_new(&data[0]);
+            for (size_t i = 1; i < length; i += BENCH_BATCH)
+            {
+                const size_t end = i + BENCH_BATCH < length ? i + BENCH_BATCH : length;
+                bench_batch_begin(&samples);
+                for (size_t j = i; j < end; ++j)
+                {
+                    unrolledList_insert(&head, &data[j]);
+                }
+                bench_batch_end(&samples, end - i);
+            }
+            unrolledList_delete(&head);
+        }
+        bench_report(config, &samples, "unrolledList_insert", "head", length, 0, length);
+    }
+
+    for (int random = 0; random < 2; ++random)
+    {
+        const char* name = random ? "unrolledList_node_delete" : "unrolledList_node_delete_head";
+        if (!bench_enabled(config, name))
+        {
+            continue;
+        }
+
+        bench_samples_start(&samples, rounds * length);
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            head = unrolledList_new(&data[0]);
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (i > 0)
+                {
+                    unrolledList_insert(&head, &data[i]);
+                }
+                order[i] = length - 1 - i;
+            }
+
+            if (random)
+            {
+                bench_shuffle(rng, order, length);
+            }
+
+            for (size_t i = 0; i < length; i += BENCH_BATCH)
+            {
+                const size_t end = i + BENCH_BATCH < length ? i + BENCH_BATCH : length;
+                bench_batch_begin(&samples);
+                for (size_t j = i; j < end; ++j)
+                {
+                    unrolledList_node_delete(&head, &data[order[j]]);
+                }
+                bench_batch_end(&samples, end - i);
+            }
+        }
+        bench_report(config, &samples, name, random ? "random" : "head", length, 0, length);
+    }
+
+    free(data);
+    free(order);
+}
+
+/*
+    static void bench_traverse(const BenchConfig* config, size_t length)
+        Walks whole NodeList and UnrolledList of the same elements, reported per visited element.
+        Lists are built with other allocations interleaved, so list nodes are not adjacent in memory
+        like in a long running program.
+*/
+static void bench_traverse(const BenchConfig* config, size_t length)
+{
+    const int nodeListEnabled = bench_enabled(config, "nodeList_traverse");
+    const int unrolledEnabled = bench_enabled(config, "unrolledList_traverse");
+    if (!nodeListEnabled && !unrolledEnabled)
+    {
+        return;
+    }
+
+    const size_t rounds = length < 4096 ? 65536 / length : 16;
+    size_t* data = malloc(length * sizeof(*data));
+    void** fillers = malloc(length * sizeof(*fillers));
+    if (data == NULL || fillers == NULL)
+    {
+        free(data);
+        free(fillers);
+        return;
+    }
+
+    NodeList* nodeHead = nodeList_new(&data[0]);
+    UnrolledList* unrolledHead = unrolledList_new(&data[0]);
+    for (size_t i = 1; i < length; ++i)
+    {
+        nodeList_insert(&nodeHead, &data[i]);
+        unrolledList_insert(&unrolledHead, &data[i]);
+        fillers[i] = malloc(48);
+    }
+
+    BenchSamples samples;
+    uintptr_t sink = 0;
+
+    if (nodeListEnabled)
+    {
+        bench_samples_start(&samples, rounds * BENCH_BATCH);
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            bench_batch_begin(&samples);
+            for (const NodeList* node = nodeHead; node != NULL; node = node->next)
+            {
+                sink += (uintptr_t)node->data;
+            }
+            bench_batch_end(&samples, length);
+        }
+        bench_report(config, &samples, "nodeList_traverse", "all", length, 0, length);
+    }
+
+    if (unrolledEnabled)
+    {
+        bench_samples_start(&samples, rounds * BENCH_BATCH);
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            bench_batch_begin(&samples);
+            for (const UnrolledList* node = unrolledHead; node != NULL; node = node->next)
+            {
+                for (size_t i = 0; i < node->count; ++i)
+                {
+                    sink += (uintptr_t)node->data[i];
+                }
+            }
+            bench_batch_end(&samples, length);
+        }
+        bench_report(config, &samples, "unrolledList_traverse", "all", length, 0, length);
+    }
+
+    bench_sink ^= sink;
+    for (size_t i = 1; i < length; ++i)
+    {
+        free(fillers[i]);
+    }
+    nodeList_delete(&nodeHead);
+    unrolledList_delete(&unrolledHead);
+    free(fillers);
+    free(data);
+}
@@ -2,32 +2,226 @@
 #define HASHTABLE_H
 
 #include <stddef.h>
-#include <nodelist_module/nodelist.h>
+#include <stdint.h>
+
+// Record flags, set parts are not released by record_delete
+#define RECORD_KEY_BORROWED 0x1u // key memory is not owned by the record
+#define RECORD_VALUE_BORROWED 0x2u // value memory is not owned by the record
+#define RECORD_BORROWED 0x4u // Record structure itself is a part of a bigger block
+#define RECORD_REFERENCED 0x8u // looked up since the CLOCK hand of cache mode passed it
+#define RECORD_KEY_INLINE 0x10u // key is stored in the record itself
+#define RECORD_VALUE_INLINE 0x20u // value is stored in the record itself
+
+// Inline string buffers, strings shorter than RECORD_INLINE_SIZE are not allocated separately
+#define RECORD_INLINE_WORDS 3
+#define RECORD_INLINE_SIZE (RECORD_INLINE_WORDS * sizeof(uint64_t))
+
+// String of a record, the RECORD_*_INLINE flag tells which member is used
+typedef union RecordString
+{
+    char* ptr; // string stored outside of the record
+    uint64_t words[RECORD_INLINE_WORDS]; // short string stored in the record, padded with zeros
+} RecordString;
 
 typedef struct Record
 {
-    char* key;
-    char* value;
+    RecordString key; // read by record_key
+    RecordString value; // read by record_value
+    uint64_t hash; // full hash of the key, compared before the key itself
+    struct HashTableTimer* timer; // expiry of the record, NULL if it never expires
+    struct Record* next; // next record of the same bucket chain
+    unsigned int flags; // RECORD_* flags
 } Record;
 
+/*
+    Function: const char* record_key(const Record* record)
+        Returns the key of the record, wherever it is stored.
+*/
+static inline const char* record_key(const Record* record)
+{
+    return (record->flags & RECORD_KEY_INLINE) ? (const char*)record->key.words : record->key.ptr;
+}
+
+/*
+    Function: const char* record_value(const Record* record)
+        Returns the value of the record, wherever it is stored.
+*/
+static inline const char* record_value(const Record* record)
+{
+    return (record->flags & RECORD_VALUE_INLINE) ? (const char*)record->value.words : record->value.ptr;
+}
+
+// Chains longer than HASHTABLE_TREEIFY_THRESHOLD get a sorted index searched by bisection,
+// it is dropped again when the chain shrinks to HASHTABLE_UNTREEIFY_THRESHOLD.
+// Lookups of an indexed chain take O(log n) compares. Inserts and deletes find their position
+// the same way but shift the rest of the array, so filling one bucket with n keys is O(n^2) moves.
+#define HASHTABLE_TREEIFY_THRESHOLD 8
+#define HASHTABLE_UNTREEIFY_THRESHOLD 4
+
+// Sorted index of one long chain, the chain itself is linked in the same order
+typedef struct HashTableSortedBucket
+{
+    size_t count; // number of records in the chain
+    size_t capacity; // allocated slots of records
+    Record* records[]; // records ordered by hash, then by key
+} HashTableSortedBucket;
+
+// Number of keys hashed and prefetched together by hashTable_search_batch
+#define HASHTABLE_BATCH_GROUP 16
+// Pipeline stages of hashTable_search_batch, each step works on this many groups at once
+#define HASHTABLE_BATCH_STAGES 4
+
+// Number of chain length histogram bins, the last bin collects all longer chains
+#define HASHTABLE_STATS_BINS 8
+
+// Lookup counters, allocated and updated only when the module is compiled with HASHTABLE_COUNTERS
+typedef struct HashTableCounters
+{
+    size_t lookups; // number of hashTable_search calls
+    size_t probes; // number of records compared during these lookups
+    size_t filtered; // lookups rejected by the Bloom filter without touching buckets
+} HashTableCounters;
+
+// Bloom filter modes of hashTable_bloom_enable
+#define HASHTABLE_BLOOM_PLAIN 0 // one bit per position, deleted keys stay set until hashTable_bloom_rebuild
+#define HASHTABLE_BLOOM_COUNTING 1 // 4-bit counter per position, hashTable_delete_record removes the key
+
+// Positions set per key, all of them in the one cache line block selected by the key hash
+#define HASHTABLE_BLOOM_PROBES 6
+// Positions per key used when hashTable_bloom_enable gets 0
+#define HASHTABLE_BLOOM_BITS_PER_KEY 10
+
+// Bounded cache mode state, separately allocated, so lookups can record hits through const HashTable*
+typedef struct HashTableCache
+{
+    size_t maxElems; // entry budget, 0 for the table size
+    size_t maxBytes; // budget of records and their strings, 0 for unlimited
+    size_t bytes; // records and strings currently held
+    size_t hand; // bucket the CLOCK hand points to
+    size_t hits; // lookups which found the key
+    size_t misses; // lookups which didn't find the key
+    size_t evictions; // records evicted to make room for inserts
+} HashTableCache;
+
+// Timing wheel levels, every level is indexed by next HASHTABLE_WHEEL_BITS bits of the expiry time
+#define HASHTABLE_WHEEL_LEVELS 4
+#define HASHTABLE_WHEEL_BITS 6
+#define HASHTABLE_WHEEL_SLOTS (1u << HASHTABLE_WHEEL_BITS)
+// Pseudo levels of timers beyond the range of the wheel and of expired timers waiting for reclaim
+#define HASHTABLE_WHEEL_FAR HASHTABLE_WHEEL_LEVELS
+#define HASHTABLE_WHEEL_DUE (HASHTABLE_WHEEL_LEVELS + 1)
+
+typedef struct HashTableTimer
+{
+    Record* record; // expiring record, its timer points back here
+    uint64_t expiresAt; // time (in units of hashTable_expire) when the record expires
+    unsigned int level; // wheel level, HASHTABLE_WHEEL_FAR or HASHTABLE_WHEEL_DUE
+    struct HashTableTimer* next;
+    struct HashTableTimer** pprev; // slot head or next pointer of the previous timer, for O(1) unlink
+} HashTableTimer;
+
+// Hierarchical timing wheel of expiring records, allocated by the first TTL operation
+typedef struct HashTableWheel
+{
+    uint64_t now; // time of the table, advanced by hashTable_expire
+    size_t pending[HASHTABLE_WHEEL_DUE + 1]; // number of timers per level
+    HashTableTimer* slots[HASHTABLE_WHEEL_LEVELS][HASHTABLE_WHEEL_SLOTS];
+    HashTableTimer* far; // timers expiring beyond the range of the top level
+    HashTableTimer* due; // expired timers, reclaimed in bounded batches
+} HashTableWheel;
+
+// Blocked Bloom filter of the keys present in the table
+typedef struct HashTableBloom
+{
+    size_t blocks; // number of 64 byte blocks, power of two
+    size_t bitsPerKey; // positions per key the filter was sized for
+    int mode; // HASHTABLE_BLOOM_PLAIN or HASHTABLE_BLOOM_COUNTING
+    void* memory; // allocated block, words are its cache line aligned part
+    uint64_t* words; // blocks * 8 words of bits or 4-bit counters
+} HashTableBloom;
+
 typedef struct HashTable
 {
     size_t size; // size of the hash table
     size_t noOfElems; // number of elements in hash table
-    Record** records; // array of pointers to records
-    NodeList** collisionList; // array of pointers to heads of the node lists
+    Record** records; // array of chain heads, colliding records are linked through Record::next
+    HashTableSortedBucket** sortedBuckets; // sorted index of every long chain, NULL until the first one
+    void* bulkBlock; // records and strings placed by hashTable_new_from_arrays, NULL otherwise
+    HashTableBloom* bloom; // optional filter checked before buckets, NULL if disabled
+    HashTableCache* cache; // bounded cache mode, NULL if disabled
+    HashTableWheel* wheel; // expiry of records inserted with TTL, NULL until first used
+    HashTableCounters* counters; // updated by lookups through const HashTable* with relaxed atomics, NULL without HASHTABLE_COUNTERS
 } HashTable;
 
+// Allocation free traversal of all records, see hashTable_iterator_next
+typedef struct HashTableIterator
+{
+    const HashTable* hashTable;
+    size_t index; // bucket of the next record
+    const Record* next; // record returned by the next call, NULL at the end
+} HashTableIterator;
+
+// Called by hashTable_scan for every visited record
+typedef void (*HashTableScanCallback)(const char* key, const char* value, void* context);
+
+// Capacity of the buffer hashTable_merge passes to the combine callback
+#define HASHTABLE_COMBINE_BUFFER 64
+
+// Called by hashTable_merge for a key present in both tables. Returns the value to keep: present, incoming,
+// buffer (of capacity bytes) filled with the combined value, or NULL to keep the present one.
+// Calls for different keys may run in parallel, for the same key they come in the order of the sources.
+typedef const char* (*HashTableCombineCallback)(const char* key, const char* present, const char* incoming,
+                                                char* buffer, size_t capacity, void* context);
+
+typedef struct HashTableStats
+{
+    size_t size; // number of buckets
+    size_t noOfElems; // number of records
+    double loadFactor; // noOfElems / size
+    size_t occupiedBuckets; // buckets with at least one record
+    size_t longestChain; // the most records under one index
+    double meanChain; // mean number of records in occupied buckets
+    size_t chainHistogram[HASHTABLE_STATS_BINS]; // number of buckets with chain of length 0, 1, ..., BINS-1 or longer
+    size_t sortedBuckets; // buckets whose chain is indexed by a sorted array
+    size_t bytesAllocated; // memory held by the table, records, Bloom filter and timers
+    HashTableCounters counters; // all zeros unless compiled with HASHTABLE_COUNTERS
+    HashTableCache cache; // all zeros unless cache mode is enabled
+} HashTableStats;
+
 
 Record* record_new(const char* key, const char* value);
 void record_delete(Record* record);
 
 HashTable* hashTable_new(const size_t size);
+HashTable* hashTable_new_from_arrays(const char* const* keys, const char* const* values, size_t count, size_t threads);
 void hashTable_delete(HashTable* hashTable);
+void hashTable_delete_parallel(HashTable* hashTable, size_t threads);
+void hashTable_clear(HashTable* hashTable, size_t threads);
+int hashTable_merge(HashTable* destination, const HashTable* const* sources, size_t count,
+                    HashTableCombineCallback combine, void* context, size_t threads);
 
 void hashTable_print(const HashTable* hashTable);
 void hashTable_insert(HashTable* hashTable, const char* key, const char* value);
+int hashTable_insert_owned(HashTable* hashTable, char* key, char* value);
+int hashTable_insert_borrowed(HashTable* hashTable, const char* key, const char* value);
+void hashTable_insert_ttl(HashTable* hashTable, const char* key, const char* value, uint64_t ttl);
+size_t hashTable_expire(HashTable* hashTable, uint64_t now, size_t maxWork);
 void hashTable_delete_record(HashTable* hashTable, const char* key);
 const char* hashTable_search(const HashTable* hashTable, const char* key);
+void hashTable_search_batch(const HashTable* hashTable, const char* const* keys, const char** values, size_t count);
+
+void hashTable_iterator_init(HashTableIterator* iterator, const HashTable* hashTable);
+const Record* hashTable_iterator_next(HashTableIterator* iterator);
+size_t hashTable_scan(const HashTable* hashTable, size_t cursor, size_t count, HashTableScanCallback callback, void* context);
+
+void hashTable_stats(const HashTable* hashTable, HashTableStats* stats);
+void hashTable_reset_counters(const HashTable* hashTable);
+
+int hashTable_bloom_enable(HashTable* hashTable, size_t bitsPerKey, int mode);
+int hashTable_bloom_rebuild(HashTable* hashTable);
+void hashTable_bloom_disable(HashTable* hashTable);
+
+int hashTable_cache_enable(HashTable* hashTable, size_t maxElems, size_t maxBytes);
+void hashTable_cache_disable(HashTable* hashTable);
 
 #endif // HASHTABLE_H
\ No newline at end of file
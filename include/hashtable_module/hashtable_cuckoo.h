@@ -0,0 +1,48 @@
+#ifndef HASHTABLE_CUCKOO_H
+#define HASHTABLE_CUCKOO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <hashtable_module/hashtable.h>
+
+// Slots of one bucket, hashes and record pointers of a bucket fill one 64 byte cache line
+#define HASHTABLE_CUCKOO_SLOTS 4
+// Records which found no slot during insertion, searched only when not empty
+#define HASHTABLE_CUCKOO_STASH 8
+// Displacements tried by one insertion before the record goes to the stash
+#define HASHTABLE_CUCKOO_MAX_KICKS 128
+// Table grows when the buckets would be filled over this percentage
+#define HASHTABLE_CUCKOO_LOAD_PERCENT 90
+// Doublings tried by one insertion (and by one growth) before it fails. Only keys sharing both buckets
+// at every size need more, e.g. over 2 * HASHTABLE_CUCKOO_SLOTS + HASHTABLE_CUCKOO_STASH keys of one 64-bit hash
+#define HASHTABLE_CUCKOO_MAX_GROWS 3
+
+typedef struct HashTableCuckooBucket
+{
+    uint64_t hashes[HASHTABLE_CUCKOO_SLOTS]; // full key hashes of occupied slots
+    Record* records[HASHTABLE_CUCKOO_SLOTS]; // NULL for free slots
+} HashTableCuckooBucket;
+
+// Bucketized cuckoo table: every key lives in one of its two buckets or in the small stash,
+// so a lookup reads at most two buckets (and the stash if some insertion overflowed)
+typedef struct HashTableCuckoo
+{
+    size_t noOfBuckets; // power of two, at least 2
+    size_t noOfElems; // number of records including the stash
+    void* memory; // allocated block, buckets are its cache line aligned part
+    HashTableCuckooBucket* buckets;
+    size_t stashCount;
+    uint64_t stashHashes[HASHTABLE_CUCKOO_STASH];
+    Record* stash[HASHTABLE_CUCKOO_STASH];
+    uint64_t seed; // state of the generator choosing displaced slots
+} HashTableCuckoo;
+
+
+HashTableCuckoo* hashTableCuckoo_new(size_t size);
+void hashTableCuckoo_delete(HashTableCuckoo* hashTable);
+void hashTableCuckoo_print(const HashTableCuckoo* hashTable);
+int hashTableCuckoo_insert(HashTableCuckoo* hashTable, const char* key, const char* value);
+void hashTableCuckoo_delete_record(HashTableCuckoo* hashTable, const char* key);
+const char* hashTableCuckoo_search(const HashTableCuckoo* hashTable, const char* key);
+
+#endif // HASHTABLE_CUCKOO_H
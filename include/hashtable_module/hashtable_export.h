@@ -0,0 +1,19 @@
+#ifndef HASHTABLE_EXPORT_H
+#define HASHTABLE_EXPORT_H
+
+#include <stddef.h>
+#include <hashtable_module/hashtable.h>
+
+// Export formats, one line per record
+#define HASHTABLE_EXPORT_TEXT 0 // Key: <key>, Value: <value>, same as hashTable_print writes records
+#define HASHTABLE_EXPORT_TSV 1 // <key>\t<value>, tab, newline, carriage return and backslash escaped by backslash
+#define HASHTABLE_EXPORT_JSONL 2 // {"key":"<key>","value":"<value>"}, strings escaped as JSON requires
+
+// Size of the block allocated by hashTable_export_fd when no buffer is given
+#define HASHTABLE_EXPORT_BLOCK (64 * 1024)
+
+
+int hashTable_export_fd(const HashTable* hashTable, int fd, int format, char* buffer, size_t capacity);
+char* hashTable_export_string(const HashTable* hashTable, int format, size_t* length);
+
+#endif // HASHTABLE_EXPORT_H
@@ -0,0 +1,33 @@
+#ifndef HASHTABLE_FROZEN_H
+#define HASHTABLE_FROZEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <hashtable_module/hashtable.h>
+
+// Average number of keys per displacement bucket of the perfect hash
+#define HASHTABLE_FROZEN_BUCKET_KEYS 4
+
+// Slot of the frozen table, both strings are stored in the block behind all entries
+typedef struct HashTableFrozenEntry
+{
+    const char* key;
+    const char* value;
+} HashTableFrozenEntry;
+
+// Read only table with minimal perfect hash (hash and displace), every lookup checks exactly one record.
+// Slots are told apart only by the 64-bit key hash, so keys of equal hash can't be frozen together.
+typedef struct HashTableFrozen
+{
+    size_t size; // number of records, equal to number of slots
+    size_t noOfBuckets; // number of displacement buckets
+    uint32_t* seeds; // per bucket displacement seed, or slot index with FROZEN_DIRECT flag for one key buckets
+    HashTableFrozenEntry* entries; // entries in slot order, strings are stored in the same block
+} HashTableFrozen;
+
+
+HashTableFrozen* hashTable_freeze(const HashTable* hashTable);
+void hashTableFrozen_delete(HashTableFrozen* frozen);
+const char* hashTableFrozen_search(const HashTableFrozen* frozen, const char* key);
+
+#endif // HASHTABLE_FROZEN_H
@@ -0,0 +1,45 @@
+#ifndef HASHTABLE_INTERN_H
+#define HASHTABLE_INTERN_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <hashtable_module/hashtable_typed.h>
+
+// Strings are copied into chunks of this size, longer strings get a chunk of their own
+#define HASHTABLE_INTERN_CHUNK (64 * 1024)
+
+// Set of canonical strings, every canonical pointer is both key and value
+HASHTABLE_TYPED_DECLARE(InternSet, const char*, const char*)
+
+typedef struct HashTableInternChunk
+{
+    struct HashTableInternChunk* next;
+    size_t used; // bytes of data taken by strings
+    size_t capacity;
+    char data[];
+} HashTableInternChunk;
+
+/*
+    String interning pool: one canonical copy of every distinct string, which lives until the pool is deleted.
+    Canonical pointers of equal strings are equal, so they can be compared by pointer and shared by many
+    tables without copies: hashTable_insert_borrowed stores them as they are and lookups by canonical pointer
+    skip the key compare of the found record.
+*/
+typedef struct HashTableInternPool
+{
+    HashTableInternSet* set;
+    HashTableInternChunk* chunks; // the newest chunk first, strings are appended to it
+    size_t noOfStrings;
+    size_t bytes; // bytes of interned strings including their NULs
+    int threadSafe; // set operations are guarded by lock
+    pthread_rwlock_t lock;
+} HashTableInternPool;
+
+
+HashTableInternPool* hashTableIntern_new(size_t size, int threadSafe);
+void hashTableIntern_delete(HashTableInternPool* pool);
+const char* hashTableIntern_get(HashTableInternPool* pool, const char* str);
+const char* hashTableIntern_find(HashTableInternPool* pool, const char* str);
+HashTableInternPool* hashTableIntern_global(void);
+
+#endif // HASHTABLE_INTERN_H
@@ -0,0 +1,44 @@
+#ifndef HASHTABLE_RADIX_H
+#define HASHTABLE_RADIX_H
+
+#include <stddef.h>
+
+// Separator of hierarchy levels in category names, "net.http.client" is a child of "net.http"
+#define HASHTABLE_RADIX_SEPARATOR '.'
+
+/*
+    Node of the category tree. Its label is one or more whole segments of the name (path compressed),
+    the full category is the concatenation of labels on the path from the root.
+    Nodes are never released before the tree, so their pointers are stable handles.
+*/
+typedef struct HashTableRadixNode
+{
+    struct HashTableRadixNode* parent; // NULL for the root
+    struct HashTableRadixNode** children; // sorted by their first segments, which are distinct
+    size_t noOfChildren;
+    size_t capacity; // of children
+    int level; // resolved level: own if configured, otherwise inherited from the parent
+    int configured; // level was set for this category
+    size_t labelLen;
+    size_t segmentLen; // length of the first segment of label, children are searched by it
+    char label[]; // segments without separators at the ends, NUL terminated
+} HashTableRadixNode;
+
+// Tree of hierarchical category names, the root is the empty category holding the default level
+typedef struct HashTableRadix
+{
+    HashTableRadixNode* root;
+    size_t noOfNodes; // including the root and nodes created by splits
+    size_t noOfConfigured; // categories with own level, the root included
+} HashTableRadix;
+
+
+HashTableRadix* hashTableRadix_new(int defaultLevel);
+void hashTableRadix_delete(HashTableRadix* tree);
+const HashTableRadixNode* hashTableRadix_get(HashTableRadix* tree, const char* category);
+int hashTableRadix_resolve(const HashTableRadix* tree, const char* category);
+int hashTableRadix_set(HashTableRadix* tree, const char* category, int level);
+int hashTableRadix_set_subtree(HashTableRadix* tree, const char* category, int level);
+int hashTableRadix_unset(HashTableRadix* tree, const char* category);
+
+#endif // HASHTABLE_RADIX_H
@@ -0,0 +1,93 @@
+#ifndef HASHTABLE_RCU_H
+#define HASHTABLE_RCU_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <hashtable_module/hashtable.h>
+
+typedef struct HashTableRcuEntry
+{
+    uint64_t hash; // full hash of the key, compared before the key itself
+    const char* key;
+    const char* value;
+} HashTableRcuEntry;
+
+// Bucket index bits consumed by one level of the bucket trie
+#define HASHTABLE_RCU_FANOUT_BITS 6
+#define HASHTABLE_RCU_FANOUT (1u << HASHTABLE_RCU_FANOUT_BITS)
+
+// Immutable bucket, shared by all versions in which it didn't change
+typedef struct HashTableRcuBucket
+{
+    size_t refs; // trie nodes holding the bucket, changed by the writer only
+    size_t count;
+    HashTableRcuEntry entries[]; // strings of the entries are stored behind them in the same block
+} HashTableRcuBucket;
+
+// Node of the bucket trie, nodes of the lowest level hold buckets, the others hold nodes of the level below.
+// Node shared by more versions (or parents) is copied before it is changed.
+typedef struct HashTableRcuNode
+{
+    size_t refs; // versions and nodes holding the node, changed by the writer only
+    union
+    {
+        struct HashTableRcuNode* nodes[HASHTABLE_RCU_FANOUT];
+        HashTableRcuBucket* buckets[HASHTABLE_RCU_FANOUT];
+    } slots; // NULL for empty subtrees and buckets
+} HashTableRcuNode;
+
+// Published versions are never modified, readers see all of one version or all of another
+typedef struct HashTableRcuVersion
+{
+    size_t size; // number of buckets, power of two
+    size_t depth; // levels of the trie, every level is indexed by next HASHTABLE_RCU_FANOUT_BITS of the bucket
+    size_t noOfElems;
+    uint64_t retiredAt; // epoch in which the version was replaced
+    struct HashTableRcuVersion* nextRetired; // replaced versions waiting until no reader can hold them
+    HashTableRcuNode* root; // NULL for an empty version
+} HashTableRcuVersion;
+
+// Reader registered by one thread, its epoch tells the writer which versions it may hold
+typedef struct HashTableRcuReader
+{
+    struct HashTableRcu* rcu;
+    uint64_t epoch; // epoch entered by hashTableRcu_read_lock, 0 outside of read sections
+    struct HashTableRcuReader* next;
+} HashTableRcuReader;
+
+/*
+    Read-copy-update table: readers take the current version without any lock, a single writer builds
+    a draft version (sharing the bucket trie of the current one, changed buckets and trie nodes on their path
+    copied on write) and publishes it by one atomic pointer swap. Replaced versions are released when every
+    reader left the read section in which it could have taken them (epoch based reclamation).
+*/
+typedef struct HashTableRcu
+{
+    HashTableRcuVersion* current; // read and swapped atomically
+    uint64_t epoch; // incremented by every publish, starts at 1
+    HashTableRcuVersion* draft; // version being built between hashTableRcu_begin and publish or abort
+    HashTableRcuVersion* retired; // replaced versions, the newest first
+    HashTableRcuReader* readers;
+    size_t noOfRetired;
+    pthread_mutex_t lock; // held by the writer from begin to publish or abort, guards readers and retired
+} HashTableRcu;
+
+
+HashTableRcu* hashTableRcu_new(size_t size);
+void hashTableRcu_delete(HashTableRcu* rcu);
+HashTableRcuReader* hashTableRcu_reader_register(HashTableRcu* rcu);
+void hashTableRcu_reader_unregister(HashTableRcuReader* reader);
+const HashTableRcuVersion* hashTableRcu_read_lock(HashTableRcuReader* reader);
+void hashTableRcu_read_unlock(HashTableRcuReader* reader);
+const char* hashTableRcuVersion_search(const HashTableRcuVersion* version, const char* key);
+int hashTableRcu_begin(HashTableRcu* rcu);
+int hashTableRcu_insert(HashTableRcu* rcu, const char* key, const char* value);
+int hashTableRcu_delete_record(HashTableRcu* rcu, const char* key);
+int hashTableRcu_load(HashTableRcu* rcu, const HashTable* hashTable);
+int hashTableRcu_publish(HashTableRcu* rcu);
+void hashTableRcu_abort(HashTableRcu* rcu);
+size_t hashTableRcu_reclaim(HashTableRcu* rcu);
+void hashTableRcu_synchronize(HashTableRcu* rcu);
+
+#endif // HASHTABLE_RCU_H
@@ -0,0 +1,59 @@
+#ifndef HASHTABLE_SNAPSHOT_H
+#define HASHTABLE_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <hashtable_module/hashtable.h>
+
+/*
+    Snapshot file layout (native byte order, all offsets are from the start of the file):
+        header   - HashTableSnapshotHeader
+        buckets  - uint64_t[size + 1], entries of bucket i are entries[buckets[i] .. buckets[i + 1])
+        entries  - HashTableSnapshotEntry[noOfElems]
+        strings  - NUL terminated keys and values
+    There are no pointers in the file, so it can be mapped at any address and shared between processes.
+    Entries are bucketed by hashTableTyped_hash_str, the format depends on it and changes the magic with it.
+*/
+
+#define HASHTABLE_SNAPSHOT_MAGIC "HTSNAP2"
+
+typedef struct HashTableSnapshotHeader
+{
+    char magic[8];
+    uint64_t size; // number of buckets, power of two
+    uint64_t noOfElems;
+    uint64_t bucketsOffset;
+    uint64_t entriesOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t fileSize;
+    uint64_t checksum; // of all the fields above
+} HashTableSnapshotHeader;
+
+typedef struct HashTableSnapshotEntry
+{
+    uint64_t hash; // full hash of the key, compared before the key itself
+    uint64_t keyOffset; // offset of the key in strings
+    uint64_t valueOffset; // offset of the value in strings
+} HashTableSnapshotEntry;
+
+typedef struct HashTableSnapshot
+{
+    void* mapping; // read only mapping of the whole file
+    size_t mappingSize;
+    size_t size; // number of buckets
+    size_t noOfElems;
+    const uint64_t* buckets;
+    const HashTableSnapshotEntry* entries;
+    const char* strings;
+    size_t stringsSize; // offsets read from entries must be below it
+} HashTableSnapshot;
+
+
+int hashTable_snapshot_write(const HashTable* hashTable, const char* path);
+
+HashTableSnapshot* hashTableSnapshot_open(const char* path);
+void hashTableSnapshot_close(HashTableSnapshot* snapshot);
+const char* hashTableSnapshot_search(const HashTableSnapshot* snapshot, const char* key);
+
+#endif // HASHTABLE_SNAPSHOT_H
@@ -0,0 +1,255 @@
+#ifndef HASHTABLE_TYPED_H
+#define HASHTABLE_TYPED_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+    Type specialized hash tables generated by macros (klib/stb style).
+
+    HASHTABLE_TYPED_INIT(Name, KeyType, ValueType, hashFn, equalFn) generates in the current translation unit:
+        typedef struct HashTableName {...} HashTableName;
+        HashTableName* hashTableName_new(size_t size);
+        void hashTableName_delete(HashTableName* hashTable);
+        int hashTableName_insert(HashTableName* hashTable, KeyType key, ValueType value);
+        ValueType* hashTableName_search(const HashTableName* hashTable, KeyType key);
+        void hashTableName_delete_record(HashTableName* hashTable, KeyType key);
+
+    hashFn(key) returns uint64_t and equalFn(a, b) returns non zero for equal keys. Both are expanded
+    directly into the generated code, so they can be macros or inline functions and get inlined.
+    Keys and values are stored by value in flat arrays (open addressing, linear probing), nothing is
+    copied to the heap on insert. Pointer keys (e.g. strings) are not copied either, the caller keeps them alive.
+
+    For use from more translation units, HASHTABLE_TYPED_DECLARE(Name, KeyType, ValueType) goes to a header
+    and HASHTABLE_TYPED_INIT2(Name, , KeyType, ValueType, hashFn, equalFn) to exactly one source file.
+*/
+
+// Table grows when more than NUM/DEN of slots would be used
+#define HASHTABLE_TYPED_LOAD_NUM 3
+#define HASHTABLE_TYPED_LOAD_DEN 4
+#define HASHTABLE_TYPED_MIN_SIZE 8
+
+// 64-bit finalizer, spreads sequential integers and aligned addresses over all bits
+static inline uint64_t hashTableTyped_hash_u64(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDu;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53u;
+    key ^= key >> 33;
+    return key;
+}
+
+static inline uint64_t hashTableTyped_hash_ptr(const void* key)
+{
+    return hashTableTyped_hash_u64((uint64_t)(uintptr_t)key);
+}
+
+// 64-bit FNV-1a with the finalizer. The only string hash of the module: records of HashTable, cuckoo,
+// frozen, snapshot and RCU tables all store or derive their slots from it
+static inline uint64_t hashTableTyped_hash_str(const char* key)
+{
+    uint64_t hash = 14695981039346656037u;
+
+    for (size_t i = 0; key[i]; ++i)
+    {
+        hash ^= (unsigned char)key[i];
+        hash *= 1099511628211u;
+    }
+
+    return hashTableTyped_hash_u64(hash);
+}
+
+#define HASHTABLE_TYPED_EQUAL_SCALAR(a, b) ((a) == (b))
+#define HASHTABLE_TYPED_EQUAL_STR(a, b) (strcmp((a), (b)) == 0)
+
+#define HASHTABLE_TYPED_TYPE(Name, KeyType, ValueType)                                                  \
+    typedef struct HashTable##Name                                                                      \
+    {                                                                                                   \
+        size_t size; /* number of slots, power of two */                                                \
+        size_t noOfElems; /* number of used slots */                                                    \
+        unsigned char* used; /* 1 for used slots */                                                     \
+        KeyType* keys;                                                                                  \
+        ValueType* values;                                                                              \
+    } HashTable##Name;
+
+#define HASHTABLE_TYPED_PROTOTYPES(Name, scope, KeyType, ValueType)                                     \
+    scope HashTable##Name* hashTable##Name##_new(size_t size);                                          \
+    scope void hashTable##Name##_delete(HashTable##Name* hashTable);                                    \
+    scope int hashTable##Name##_insert(HashTable##Name* hashTable, KeyType key, ValueType value);       \
+    scope ValueType* hashTable##Name##_search(const HashTable##Name* hashTable, KeyType key);           \
+    scope void hashTable##Name##_delete_record(HashTable##Name* hashTable, KeyType key);
+
+#define HASHTABLE_TYPED_IMPL(Name, scope, KeyType, ValueType, hashFn, equalFn)                          \
+    /* Allocates slot arrays of given power of two size, returns -1 if allocation fails */              \
+    static inline int hashTable##Name##_alloc_slots(HashTable##Name* hashTable, size_t size)            \
+    {                                                                                                   \
+        hashTable->used = calloc(size, sizeof(*hashTable->used));                                       \
+        hashTable->keys = malloc(size * sizeof(*hashTable->keys));                                      \
+        hashTable->values = malloc(size * sizeof(*hashTable->values));                                  \
+        if (hashTable->used == NULL || hashTable->keys == NULL || hashTable->values == NULL)            \
+        {                                                                                               \
+            free(hashTable->used);                                                                      \
+            free(hashTable->keys);                                                                      \
+            free(hashTable->values);                                                                    \
+            return -1;                                                                                  \
+        }                                                                                               \
+        hashTable->size = size;                                                                         \
+        return 0;                                                                                       \
+    }                                                                                                   \
+                                                                                                        \
+    /* Index of the slot holding the key, or of the free slot ending its probe sequence */              \
+    static inline size_t hashTable##Name##_find_slot(const HashTable##Name* hashTable, KeyType key)     \
+    {                                                                                                   \
+        const size_t mask = hashTable->size - 1;                                                        \
+        size_t index = (size_t)(hashFn(key)) & mask;                                                    \
+        while (hashTable->used[index] && !(equalFn(hashTable->keys[index], key)))                       \
+        {                                                                                               \
+            index = (index + 1) & mask;                                                                 \
+        }                                                                                               \
+        return index;                                                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    /* Rehashes all entries into twice as many slots, returns -1 if allocation fails */                 \
+    static inline int hashTable##Name##_grow(HashTable##Name* hashTable)                                \
+    {                                                                                                   \
+        HashTable##Name old = *hashTable;                                                               \
+        if (hashTable##Name##_alloc_slots(hashTable, old.size * 2) != 0)                                \
+        {                                                                                               \
+            *hashTable = old;                                                                           \
+            return -1;                                                                                  \
+        }                                                                                               \
+        for (size_t i = 0; i < old.size; ++i)                                                           \
+        {                                                                                               \
+            if (old.used[i])                                                                            \
+            {                                                                                           \
+                const size_t index = hashTable##Name##_find_slot(hashTable, old.keys[i]);               \
+                hashTable->used[index] = 1;                                                             \
+                hashTable->keys[index] = old.keys[i];                                                   \
+                hashTable->values[index] = old.values[i];                                               \
+            }                                                                                           \
+        }                                                                                               \
+        free(old.used);                                                                                 \
+        free(old.keys);                                                                                 \
+        free(old.values);                                                                               \
+        return 0;                                                                                       \
+    }                                                                                                   \
+                                                                                                        \
+    /* Table with room for size entries before the first growth, NULL if allocation fails */            \
+    scope HashTable##Name* hashTable##Name##_new(size_t size)                                           \
+    {                                                                                                   \
+        HashTable##Name* hashTable = malloc(sizeof(*hashTable));                                        \
+        if (hashTable == NULL)                                                                          \
+        {                                                                                               \
+            return NULL;                                                                                \
+        }                                                                                               \
+        size_t slots = HASHTABLE_TYPED_MIN_SIZE;                                                        \
+        while (slots * HASHTABLE_TYPED_LOAD_NUM < size * HASHTABLE_TYPED_LOAD_DEN)                      \
+        {                                                                                               \
+            slots <<= 1;                                                                                \
+        }                                                                                               \
+        hashTable->noOfElems = 0;                                                                       \
+        if (hashTable##Name##_alloc_slots(hashTable, slots) != 0)                                       \
+        {                                                                                               \
+            free(hashTable);                                                                            \
+            return NULL;                                                                                \
+        }                                                                                               \
+        return hashTable;                                                                               \
+    }                                                                                                   \
+                                                                                                        \
+    scope void hashTable##Name##_delete(HashTable##Name* hashTable)                                     \
+    {                                                                                                   \
+        if (hashTable == NULL)                                                                          \
+        {                                                                                               \
+            return;                                                                                     \
+        }                                                                                               \
+        free(hashTable->used);                                                                          \
+        free(hashTable->keys);                                                                          \
+        free(hashTable->values);                                                                        \
+        free(hashTable);                                                                                \
+    }                                                                                                   \
+                                                                                                        \
+    /* Inserts or updates the value of the key, returns 0 on success, -1 if growth fails */             \
+    scope int hashTable##Name##_insert(HashTable##Name* hashTable, KeyType key, ValueType value)        \
+    {                                                                                                   \
+        if (hashTable == NULL)                                                                          \
+        {                                                                                               \
+            return -1;                                                                                  \
+        }                                                                                               \
+        size_t index = hashTable##Name##_find_slot(hashTable, key);                                     \
+        if (!hashTable->used[index])                                                                    \
+        {                                                                                               \
+            if ((hashTable->noOfElems + 1) * HASHTABLE_TYPED_LOAD_DEN >                                 \
+                hashTable->size * HASHTABLE_TYPED_LOAD_NUM)                                             \
+            {                                                                                           \
+                if (hashTable##Name##_grow(hashTable) != 0)                                             \
+                {                                                                                       \
+                    return -1;                                                                          \
+                }                                                                                       \
+                index = hashTable##Name##_find_slot(hashTable, key);                                    \
+            }                                                                                           \
+            hashTable->used[index] = 1;                                                                 \
+            hashTable->keys[index] = key;                                                               \
+            hashTable->noOfElems++;                                                                     \
+        }                                                                                               \
+        hashTable->values[index] = value;                                                               \
+        return 0;                                                                                       \
+    }                                                                                                   \
+                                                                                                        \
+    /* Pointer to the stored value (valid until next insert or delete), NULL if key is not present */   \
+    scope ValueType* hashTable##Name##_search(const HashTable##Name* hashTable, KeyType key)            \
+    {                                                                                                   \
+        if (hashTable == NULL)                                                                          \
+        {                                                                                               \
+            return NULL;                                                                                \
+        }                                                                                               \
+        const size_t index = hashTable##Name##_find_slot(hashTable, key);                               \
+        return hashTable->used[index] ? &hashTable->values[index] : NULL;                               \
+    }                                                                                                   \
+                                                                                                        \
+    /* Backward shift deletion: following entries of the probe sequence move to the freed slot */       \
+    /* if it lies between their home slot and their current slot, so no tombstones are needed */         \
+    scope void hashTable##Name##_delete_record(HashTable##Name* hashTable, KeyType key)                 \
+    {                                                                                                   \
+        if (hashTable == NULL)                                                                          \
+        {                                                                                               \
+            return;                                                                                     \
+        }                                                                                               \
+        const size_t mask = hashTable->size - 1;                                                        \
+        size_t hole = hashTable##Name##_find_slot(hashTable, key);                                      \
+        if (!hashTable->used[hole])                                                                     \
+        {                                                                                               \
+            return;                                                                                     \
+        }                                                                                               \
+        for (size_t next = (hole + 1) & mask; hashTable->used[next]; next = (next + 1) & mask)          \
+        {                                                                                               \
+            const size_t home = (size_t)(hashFn(hashTable->keys[next])) & mask;                         \
+            if (((next - home) & mask) >= ((next - hole) & mask))                                       \
+            {                                                                                           \
+                hashTable->keys[hole] = hashTable->keys[next];                                          \
+                hashTable->values[hole] = hashTable->values[next];                                      \
+                hole = next;                                                                            \
+            }                                                                                           \
+        }                                                                                               \
+        hashTable->used[hole] = 0;                                                                      \
+        hashTable->noOfElems--;                                                                         \
+    }
+
+// Type and prototypes, for a header shared by translation units using table defined by HASHTABLE_TYPED_INIT2
+#define HASHTABLE_TYPED_DECLARE(Name, KeyType, ValueType)                                               \
+    HASHTABLE_TYPED_TYPE(Name, KeyType, ValueType)                                                      \
+    HASHTABLE_TYPED_PROTOTYPES(Name, extern, KeyType, ValueType)
+
+// Type and definitions with given scope of public functions (empty for external linkage)
+#define HASHTABLE_TYPED_INIT2(Name, scope, KeyType, ValueType, hashFn, equalFn)                         \
+    HASHTABLE_TYPED_TYPE(Name, KeyType, ValueType)                                                      \
+    HASHTABLE_TYPED_PROTOTYPES(Name, scope, KeyType, ValueType)                                         \
+    HASHTABLE_TYPED_IMPL(Name, scope, KeyType, ValueType, hashFn, equalFn)
+
+// Table private to the translation unit
+#define HASHTABLE_TYPED_INIT(Name, KeyType, ValueType, hashFn, equalFn)                                 \
+    HASHTABLE_TYPED_INIT2(Name, static inline, KeyType, ValueType, hashFn, equalFn)
+
+#endif // HASHTABLE_TYPED_H
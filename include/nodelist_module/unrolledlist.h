@@ -0,0 +1,30 @@
+#ifndef UNROLLEDLIST_H
+#define UNROLLEDLIST_H
+
+#include <stddef.h>
+
+// Data pointers held by one node, with next and count the node takes 128 bytes (two cache lines)
+#define UNROLLED_LIST_NODE_CAPACITY 14
+
+/*
+    Unrolled variant of NodeList: every node holds up to UNROLLED_LIST_NODE_CAPACITY data pointers,
+    so walking the list reads mostly sequential memory. Only the head node can be partially filled,
+    all following nodes are always full. Order of the elements is not preserved by deletes.
+    Iteration: for each node from head through next, data[0] .. data[count - 1].
+*/
+typedef struct UnrolledList
+{
+    struct UnrolledList* next;
+    size_t count; // used slots of data
+    void* data[UNROLLED_LIST_NODE_CAPACITY];
+} UnrolledList;
+
+
+UnrolledList* unrolledList_new(void* data);
+void unrolledList_delete(UnrolledList** head);
+void unrolledList_insert(UnrolledList** restrict head, void* restrict data);
+void unrolledList_node_delete(UnrolledList** restrict head, void* restrict data);
+size_t unrolledList_size(const UnrolledList* head);
+
+
+#endif // UNROLLEDLIST_H
@@ -0,0 +1,73 @@
+#!/bin/sh
+# Reports cache and branch events per single operation of one benchmark workload.
+# The workload is run twice under the profiler: a baseline run (-b) which does the whole
+# setup (keys, table filling, query generation) and skips the operations, and a full run.
+# The difference of the two runs divided by the number of operations is reported.
+#
+# Usage: scripts/profile_ops.sh cachegrind|perf <bench binary> <workload> <table size> <key length> <ops> [valgrind command]
+
+set -e
+
+if [ $# -lt 6 ]; then
+    echo "Usage: $0 cachegrind|perf <bench binary> <workload> <table size> <key length> <ops> [valgrind command]" >&2
+    exit 1
+fi
+
+tool=$1
+bench=$2
+workload=$3
+size=$4
+keylen=$5
+ops=$6
+shift 6
+args="-p $workload -s $size -k $keylen -n $ops"
+
+echo "Workload: $workload, table size: $size, key length: $keylen, operations: $ops"
+
+case $tool in
+cachegrind)
+    valgrind_cmd=${*:-valgrind --tool=cachegrind --cache-sim=yes --branch-sim=yes}
+    $valgrind_cmd --cachegrind-out-file=cachegrind.out.base $bench $args -b > /dev/null 2>&1
+    $valgrind_cmd --cachegrind-out-file=cachegrind.out.bench $bench $args > /dev/null 2>&1
+
+    awk -v ops="$ops" '
+        /^events:/  { for (i = 2; i <= NF; i++) name[i - 1] = $i; n = NF - 1 }
+        /^summary:/ { for (i = 2; i <= NF; i++) { if (FNR == NR) base[i - 1] = $i; else run[i - 1] = $i } }
+        END {
+            for (i = 1; i <= n; i++) { d[name[i]] = run[i] - base[i]; printf "%-28s %14.0f %12.3f\n", name[i], d[name[i]], d[name[i]] / ops }
+            printf "%-28s %14.0f %12.3f\n", "D1 misses (D1mr+D1mw)", d["D1mr"] + d["D1mw"], (d["D1mr"] + d["D1mw"]) / ops
+            printf "%-28s %14.0f %12.3f\n", "LL misses (ILmr+DLmr+DLmw)", d["ILmr"] + d["DLmr"] + d["DLmw"], (d["ILmr"] + d["DLmr"] + d["DLmw"]) / ops
+            printf "%-28s %14.0f %12.3f\n", "Branch mispredicts (Bcm+Bim)", d["Bcm"] + d["Bim"], (d["Bcm"] + d["Bim"]) / ops
+        }' cachegrind.out.base cachegrind.out.bench | { printf "%-28s %14s %12s\n" "event" "total" "per op"; cat; }
+
+    echo "Per-function details: cg_annotate cachegrind.out.bench"
+    ;;
+perf)
+    if ! command -v perf > /dev/null 2>&1; then
+        echo "perf not found, skipping"
+        exit 0
+    fi
+
+    events=cycles,instructions,cache-references,cache-misses,branches,branch-misses,L1-dcache-load-misses,LLC-load-misses
+    if ! perf stat -x, -e $events -o perf.out.base $bench $args -b > /dev/null 2>&1; then
+        echo "perf stat is not usable here (missing permissions or counters), skipping"
+        exit 0
+    fi
+    perf stat -x, -e $events -o perf.out.bench $bench $args > /dev/null 2>&1
+
+    # perf CSV line: value,unit,event,... - counters which are not supported have non-numeric value
+    awk -F, -v ops="$ops" '
+        /^#/ || NF < 3 { next }
+        FNR == NR { base[$3] = $1; next }
+        {
+            if ($1 ~ /^[0-9.]+$/ && base[$3] ~ /^[0-9.]+$/)
+                printf "%-28s %14.0f %12.3f\n", $3, $1 - base[$3], ($1 - base[$3]) / ops
+            else
+                printf "%-28s %14s %12s\n", $3, "n/a", "n/a"
+        }' perf.out.base perf.out.bench | { printf "%-28s %14s %12s\n" "event" "total" "per op"; cat; }
+    ;;
+*)
+    echo "Unknown tool: $tool" >&2
+    exit 1
+    ;;
+esac
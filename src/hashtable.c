@@ -1,16 +1,156 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // pthreads
+#endif
+
 #include <hashtable_module/hashtable.h>
-#include <nodelist_module/nodelist.h>
+#include <hashtable_module/hashtable_typed.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
+// Lookups only read the table, their counters are relaxed atomics so concurrent lookups are safe
+#ifdef HASHTABLE_COUNTERS
+#define COUNT_LOOKUP(hashTable) ((void)__atomic_fetch_add(&(hashTable)->counters->lookups, 1, __ATOMIC_RELAXED))
+#define COUNT_PROBE(hashTable) ((void)__atomic_fetch_add(&(hashTable)->counters->probes, 1, __ATOMIC_RELAXED))
+#define COUNT_PROBES(hashTable, n) ((void)__atomic_fetch_add(&(hashTable)->counters->probes, (n), __ATOMIC_RELAXED))
+#define COUNT_FILTERED(hashTable) ((void)__atomic_fetch_add(&(hashTable)->counters->filtered, 1, __ATOMIC_RELAXED))
+#else
+#define COUNT_LOOKUP(hashTable) ((void)0)
+#define COUNT_PROBE(hashTable) ((void)0)
+#define COUNT_PROBES(hashTable, n) ((void)(n))
+#define COUNT_FILTERED(hashTable) ((void)0)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define HASHTABLE_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define HASHTABLE_PREFETCH(address) ((void)(address))
+#endif
+
+// One Bloom filter block is a single cache line
+#define BLOOM_BLOCK_BYTES 64
+#define BLOOM_BLOCK_WORDS (BLOOM_BLOCK_BYTES / sizeof(uint64_t))
+// Low bits of the key hash select the block, HASHTABLE_BLOOM_PROBES slices of the remixed hash select
+// positions within it (9 bits for 512 bits of plain block, 7 bits for 128 counters of counting block)
+#define BLOOM_BLOCK(bloom, hash) (&(bloom)->words[((hash) & ((bloom)->blocks - 1)) * BLOOM_BLOCK_WORDS])
+#define BLOOM_REMIX(hash) ((hash) * 0x9E3779B97F4A7C15u)
+
+// Buckets visited by one hashTable_scan call per requested record, bounds the work over empty buckets
+#define SCAN_BUCKETS_PER_RECORD 10
+
+// String of given length (without terminating zero) can be stored in the record itself
+#define RECORD_FITS_INLINE(len) ((len) < RECORD_INLINE_SIZE)
+
+// Part of hashTable_new_from_arrays work, places entries of one bucket range
+typedef struct BulkLoadJob
+{
+    HashTable* hashTable;
+    Record* records; // records of all entries, already pointing to their string slots
+    const char* const* keys;
+    const char* const* values;
+    const size_t* indexes; // bucket index of every entry
+    const size_t* order; // entries grouped by bucket, in input order within a bucket
+    size_t first; // position in order of the first entry of this job's bucket range
+    size_t end; // position in order one past the last entry of this job's bucket range
+    size_t placed;
+} BulkLoadJob;
+
+// Keys of hashTable_search_batch looked up together, moving through the stages of its pipeline
+typedef struct BatchGroup
+{
+    size_t start; // position of the first key of the group in the batch
+    size_t n; // number of keys, at most HASHTABLE_BATCH_GROUP
+    size_t indexes[HASHTABLE_BATCH_GROUP]; // bucket of every key, (size_t)-1 if it is not looked up
+    uint64_t hashes[HASHTABLE_BATCH_GROUP];
+    Record* heads[HASHTABLE_BATCH_GROUP]; // first record of the bucket, read by the second stage
+} BatchGroup;
+
+// Part of hashTable_clear and hashTable_delete_parallel work, releases records of one bucket range
+typedef struct ClearJob
+{
+    HashTable* hashTable;
+    size_t firstBucket;
+    size_t endBucket;
+} ClearJob;
+
+// Part of hashTable_merge work, merges source records hashed into one bucket range of the destination
+typedef struct MergeJob
+{
+    HashTable* destination;
+    const HashTable* const* sources;
+    size_t count; // number of sources
+    HashTableCombineCallback combine;
+    void* context;
+    int parallel; // destination is shared with other jobs, noOfElems is updated after them
+    size_t* slots; // free entries shared by parallel jobs, NULL if all source records fit
+    size_t firstBucket;
+    size_t endBucket;
+    size_t placed; // new records linked by parallel job, not counted in noOfElems yet
+    size_t dropped; // records which didn't fit or couldn't be allocated
+} MergeJob;
+
+static void run_jobs(void* jobs, size_t jobSize, size_t threads, void* (*work)(void*));
+static void* bulk_load_job(void* arg);
+static void* clear_job(void* arg);
+static void* merge_job(void* arg);
+static void merge_record(MergeJob* job, size_t index, const Record* record, char* buffer);
+static int merge_reserve(size_t* slots);
+static void release_records(HashTable* hashTable, size_t threads);
 static size_t hash_function(const char* key, size_t hashTableSize);
+static size_t bucket_index(uint64_t hash, size_t hashTableSize);
+static uint64_t key_hash(const char* key);
+static int key_equals(const Record* record, const char* key, uint64_t hash);
+static char* record_key_buffer(Record* record);
+static char* record_value_buffer(Record* record);
+static unsigned int lookup_flags(const Record* record);
+static const char* lookup_key(const Record* record);
+static const char* lookup_value(const Record* record);
+static size_t record_heap_bytes(const Record* record);
+static Record* search_bucket(const HashTable* hashTable, const char* key, uint64_t hash, size_t index);
+static void batch_hash(const HashTable* hashTable, BatchGroup* group, const char* const* keys);
+static void batch_load_heads(const HashTable* hashTable, BatchGroup* group);
+static void batch_prefetch_keys(const BatchGroup* group);
+static void batch_resolve(const HashTable* hashTable, const BatchGroup* group, const char* const* keys, const char** values);
+static Record* find_record(const HashTable* hashTable, const char* key, uint64_t hash, size_t index);
+static Record** find_link(const HashTable* hashTable, const char* key, uint64_t hash, size_t index);
+static void remove_record(HashTable* hashTable, size_t index, Record** link);
+static int record_compare(const Record* record, uint64_t hash, const char* key);
+static int record_order(const void* a, const void* b);
+static int chain_longer(const Record* head, size_t limit);
+static int sorted_find(const HashTableSortedBucket* sorted, uint64_t hash, const char* key, size_t* position, size_t* compares);
+static void sorted_add(HashTable* hashTable, size_t index, Record* record);
+static void sorted_remove(HashTable* hashTable, size_t index, const Record* record);
+static void bucket_treeify(HashTable* hashTable, size_t index);
+static void bucket_untreeify(HashTable* hashTable, size_t index);
+static size_t record_bytes(const char* key, const char* value);
+static int cache_make_room(HashTable* hashTable, const char* key, const char* value);
+static int cache_evict(HashTable* hashTable);
+static void cache_lookup(HashTableCache* cache, Record* record);
+static void record_set_value(HashTable* hashTable, Record* record, const char* value);
+static int record_expired(const HashTable* hashTable, const Record* record);
+static const Record* iterator_skip(const HashTable* hashTable, size_t* index, const Record* record);
+static HashTableWheel* wheel_get(HashTable* hashTable);
+static void wheel_add(HashTableWheel* wheel, HashTableTimer* timer);
+static void wheel_unlink(HashTableWheel* wheel, HashTableTimer* timer);
+static void wheel_readd(HashTableWheel* wheel, HashTableTimer** head);
+static uint64_t wheel_far_window(const HashTableWheel* wheel);
+static void wheel_advance(HashTableWheel* wheel, uint64_t now);
+static void timer_cancel(HashTable* hashTable, Record* record);
+static HashTableBloom* bloom_new(size_t capacity, size_t bitsPerKey, int mode);
+static void bloom_delete(HashTableBloom* bloom);
+static void bloom_add(HashTableBloom* bloom, uint64_t hash);
+static void bloom_remove(HashTableBloom* bloom, uint64_t hash);
+static int bloom_may_contain(const HashTableBloom* bloom, uint64_t hash);
 static void handle_collision(HashTable* hashTable, size_t index, Record* record);
+static void link_record(HashTable* hashTable, size_t index, Record* record);
+static int insert_record(HashTable* hashTable, char* key, char* value, unsigned int flags);
 
 /*
     Function: Record* record_new(const char* key, const char* value)
-        Allocates memory for Record structure and two char* chains within this.
-        Then copy key and value to just allocated memory and return pointer to Record.
+        Allocates memory for Record structure and copies key and value into it.
+        Strings shorter than RECORD_INLINE_SIZE are kept in the inline buffers of the record,
+        only longer ones get their own allocation. Returns pointer to the Record.
 */
 Record* record_new(const char* key, const char* value)
 {
@@ -25,23 +165,48 @@ Record* record_new(const char* key, const char* value)
         return NULL;
     }
 
-    record->key = malloc(strlen(key) + 1);
-    if (record->key == NULL)
+    const size_t keyLen = strlen(key);
+    const size_t valueLen = strlen(value);
+    record->flags = 0;
+
+    if (RECORD_FITS_INLINE(keyLen))
     {
-        free(record);
-        return NULL;
+        memset(record->key.words, 0, sizeof(record->key.words)); // padding is compared by key_equals
+        record->flags |= RECORD_KEY_INLINE;
+    }
+    else
+    {
+        record->key.ptr = malloc(keyLen + 1);
+        if (record->key.ptr == NULL)
+        {
+            free(record);
+            return NULL;
+        }
     }
 
-    record->value = malloc(strlen(value) + 1);
-    if (record->value == NULL)
+    if (RECORD_FITS_INLINE(valueLen))
     {
-        free(record->key);
-        free(record);
-        return NULL;
+        record->flags |= RECORD_VALUE_INLINE;
+    }
+    else
+    {
+        record->value.ptr = malloc(valueLen + 1);
+        if (record->value.ptr == NULL)
+        {
+            if (!(record->flags & RECORD_KEY_INLINE))
+            {
+                free(record->key.ptr);
+            }
+            free(record);
+            return NULL;
+        }
     }
 
-    strcpy(record->key, key);
-    strcpy(record->value, value);
+    memcpy(record_key_buffer(record), key, keyLen + 1);
+    memcpy(record_value_buffer(record), value, valueLen + 1);
+    record->hash = key_hash(key);
+    record->timer = NULL;
+    record->next = NULL;
     
     return record;
 }
@@ -49,6 +214,8 @@ Record* record_new(const char* key, const char* value)
 /*
     Function: void record_delete(Record* record)
         Frees the key, value and whole Record instance.
+        Parts marked by RECORD_*_BORROWED flags are owned by someone else and are left untouched,
+        inline strings are released together with the record.
 */
 void record_delete(Record* record)
 {
@@ -57,23 +224,26 @@ void record_delete(Record* record)
         return;
     }
 
-    if (record->key != NULL)
+    if (!(record->flags & (RECORD_KEY_BORROWED | RECORD_KEY_INLINE)))
     {
-        free(record->key);
+        free(record->key.ptr);
     }
 
-    if (record->value != NULL)
+    if (!(record->flags & (RECORD_VALUE_BORROWED | RECORD_VALUE_INLINE)))
     {
-        free(record->value);
+        free(record->value.ptr);
     }
 
-    free(record);
+    if (!(record->flags & RECORD_BORROWED))
+    {
+        free(record);
+    }
 }
 
 /*
     Function: HashTable* hashTable_new(const size_t size)
         Allocates the memory for HashTable structure instance.
-        Dependend on given size, it creates array of records and collision lists for new hash table.
+        Dependend on given size, it creates array of record chains for new hash table.
         Finally returns the pointer to just created hash table.
 */
 HashTable* hashTable_new(const size_t size)
@@ -91,6 +261,12 @@ HashTable* hashTable_new(const size_t size)
 
     hashTable->size = size;
     hashTable->noOfElems = 0;
+    hashTable->bulkBlock = NULL;
+    hashTable->sortedBuckets = NULL;
+    hashTable->bloom = NULL;
+    hashTable->cache = NULL;
+    hashTable->wheel = NULL;
+    hashTable->counters = NULL;
 
     hashTable->records = calloc(hashTable->size, sizeof(*hashTable->records));
     if (hashTable->records == NULL)
@@ -99,318 +275,2453 @@ HashTable* hashTable_new(const size_t size)
         return NULL;
     }
 
-    hashTable->collisionList = calloc(hashTable->size, sizeof(*hashTable->collisionList));
-    if (hashTable->collisionList == NULL)
+#ifdef HASHTABLE_COUNTERS
+    hashTable->counters = calloc(1, sizeof(*hashTable->counters));
+    if (hashTable->counters == NULL)
     {
         free(hashTable->records);
         free(hashTable);
         return NULL;
     }
+#endif
 
     return hashTable;
 }
 
 /*
-    Function: void hashTable_delete(HashTable* hashTable)
-        Function is resbonsible for releasing whole memory related with given hash table.
-        It frees all records , collision lists (and its nodes if exists) and hash table itself.
+    Function: HashTable* hashTable_new_from_arrays(const char* const* keys, const char* const* values, size_t count, size_t threads)
+        Builds a hash table of exactly count size from arrays of keys and values.
+        All records and strings are copied into one contiguous block owned by the table,
+        instead of three allocations per hashTable_insert. Colliding records are linked through their next pointers.
+        Duplicate keys are merged like by repeated hashTable_insert, the last value is kept. The block is sized
+        for all count entries, so the record and strings of every replaced duplicate stay unused in it
+        until the table is deleted.
+        With threads > 1 buckets are split into ranges placed by separate threads. Entries are grouped
+        by bucket once (counting sort), so every thread visits only the entries of its own range.
+        Returns NULL if any key or value is NULL or the allocation fails.
 */
-void hashTable_delete(HashTable* hashTable)
+HashTable* hashTable_new_from_arrays(const char* const* keys, const char* const* values, size_t count, size_t threads)
 {
-    if (hashTable == NULL)
+    if (keys == NULL || values == NULL || count < 1)
     {
-        return;
+        return NULL;
     }
 
-    for (size_t i = 0; i < hashTable->size; ++i)
+    size_t* indexes = malloc(count * sizeof(*indexes));
+    size_t* order = malloc(count * sizeof(*order));
+    size_t* bucketStart = calloc(count + 1, sizeof(*bucketStart));
+    if (indexes == NULL || order == NULL || bucketStart == NULL)
     {
-        if (hashTable->collisionList[i] != NULL)
-        {
-            NodeList* current = hashTable->collisionList[i];
-            while (current != NULL)
-            {
-                Record* rec = (Record*)current->data;
-                record_delete(rec);
-                current = current->next;
-            }
-            nodeList_delete(&hashTable->collisionList[i]);
-        }
+        free(indexes);
+        free(order);
+        free(bucketStart);
+        return NULL;
+    }
 
-        if (hashTable->records[i] != NULL)
+    // Hash all keys and compute the size of the strings block
+    size_t stringsSize = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (keys[i] == NULL || values[i] == NULL)
         {
-            record_delete(hashTable->records[i]);
+            free(indexes);
+            free(order);
+            free(bucketStart);
+            return NULL;
         }
+
+        const size_t keyLen = strlen(keys[i]);
+        const size_t valueLen = strlen(values[i]);
+        stringsSize += (RECORD_FITS_INLINE(keyLen) ? 0 : keyLen + 1) + (RECORD_FITS_INLINE(valueLen) ? 0 : valueLen + 1);
+        indexes[i] = hash_function(keys[i], count);
+        bucketStart[indexes[i] + 1]++;
     }
 
-    if (hashTable->collisionList != NULL)
+    // Entries grouped by bucket: prefix sum of the counts, stable fill, shift back to the starts
+    for (size_t b = 0; b < count; ++b)
+    {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    for (size_t i = 0; i < count; ++i)
     {
-        free(hashTable->collisionList);
+        order[bucketStart[indexes[i]]++] = i;
     }
+    memmove(bucketStart + 1, bucketStart, count * sizeof(*bucketStart));
+    bucketStart[0] = 0;
 
-    if (hashTable->records != NULL)
+    HashTable* hashTable = hashTable_new(count);
+    if (hashTable == NULL)
     {
-        free(hashTable->records);
+        free(indexes);
+        free(order);
+        free(bucketStart);
+        return NULL;
     }
 
-    free(hashTable);
-}
+    hashTable->bulkBlock = malloc(count * sizeof(Record) + stringsSize);
+    if (hashTable->bulkBlock == NULL)
+    {
+        free(indexes);
+        free(order);
+        free(bucketStart);
+        hashTable_delete(hashTable);
+        return NULL;
+    }
 
-/*
-    Function: void hashTable_print(const HashTable* hashTable)
-        This function prints all existing records (and collision lists if exists) within 
-        given hash table. Firstly it prints current index (only if there is a content
-        under that index), and then all data related with this index.
-*/
-void hashTable_print(const HashTable* hashTable)
-{
-    if (hashTable == NULL)
+    // Assign string slots (inline or in the block), strings are copied later by the jobs
+    Record* records = hashTable->bulkBlock;
+    char* strings = (char*)(records + count);
+    for (size_t i = 0; i < count; ++i)
     {
-        return;
+        const size_t keyLen = strlen(keys[i]);
+        const size_t valueLen = strlen(values[i]);
+        records[i].flags = RECORD_BORROWED;
+
+        if (RECORD_FITS_INLINE(keyLen))
+        {
+            memset(records[i].key.words, 0, sizeof(records[i].key.words));
+            records[i].flags |= RECORD_KEY_INLINE;
+        }
+        else
+        {
+            records[i].key.ptr = strings;
+            strings += keyLen + 1;
+            records[i].flags |= RECORD_KEY_BORROWED;
+        }
+
+        if (RECORD_FITS_INLINE(valueLen))
+        {
+            records[i].flags |= RECORD_VALUE_INLINE;
+        }
+        else
+        {
+            records[i].value.ptr = strings;
+            strings += valueLen + 1;
+            records[i].flags |= RECORD_VALUE_BORROWED;
+        }
     }
 
-    for (size_t i = 0; i < hashTable->size; i++)
+    if (threads < 1)
     {
-        if (hashTable->records[i] != NULL)
+        threads = 1;
+    }
+    else if (threads > count)
+    {
+        threads = count;
+    }
+
+    BulkLoadJob* jobs = malloc(threads * sizeof(*jobs));
+    const int failed = jobs == NULL;
+
+    if (!failed)
+    {
+        for (size_t t = 0; t < threads; ++t)
         {
-            printf("Index=%zu\tKey: %s, Value: %s\n",
-                    i, 
-                    hashTable->records[i]->key,
-                    hashTable->records[i]->value);
+            BulkLoadJob job = {hashTable, records, keys, values, indexes, order,
+                               bucketStart[count * t / threads], bucketStart[count * (t + 1) / threads], 0};
+            jobs[t] = job;
+        }
+
+        run_jobs(jobs, sizeof(*jobs), threads, bulk_load_job);
+
+        for (size_t t = 0; t < threads; ++t)
+        {
+            hashTable->noOfElems += jobs[t].placed;
         }
 
-        if (hashTable->collisionList[i] != NULL)
+        for (size_t i = 0; i < hashTable->size; ++i)
         {
-            NodeList* current = hashTable->collisionList[i];
-            while (current != NULL)
+            if (chain_longer(hashTable->records[i], HASHTABLE_TREEIFY_THRESHOLD))
             {
-                Record* rec = (Record*)current->data;
-                printf("\tKey: %s, Value: %s\n", rec->key, rec->value);
-                current = current->next;
+                bucket_treeify(hashTable, i);
             }
         }
     }
+
+    free(jobs);
+    free(indexes);
+    free(order);
+    free(bucketStart);
+
+    if (failed)
+    {
+        hashTable_delete(hashTable);
+        return NULL;
+    }
+
+    return hashTable;
 }
 
 /*
-    Function: void hashTable_insert(HashTable* hashTable, const char* key, const char* value)
-        This function prints all existing records (and collision lists) within given hash table.
-        Firstly it prints current index (only if there is a content under that index),
-        and then all data related with this index.
+    Function: void hashTable_delete(HashTable* hashTable)
+        Function is resbonsible for releasing whole memory related with given hash table.
+        It frees all records (whole chains of colliding records) and hash table itself.
 */
-void hashTable_insert(HashTable* hashTable, const char* key, const char* value)
+void hashTable_delete(HashTable* hashTable)
 {
-    if (hashTable == NULL || key == NULL || value == NULL)
+    hashTable_delete_parallel(hashTable, 1);
+}
+
+/*
+    Function: void hashTable_delete_parallel(HashTable* hashTable, size_t threads)
+        Same as hashTable_delete, but with threads > 1 records of separate bucket ranges
+        are released by separate threads, so the teardown of a big table doesn't keep one core busy.
+*/
+void hashTable_delete_parallel(HashTable* hashTable, size_t threads)
+{
+    if (hashTable == NULL)
     {
         return;
     }
 
-    // hashTable is full
-    if (hashTable->size == hashTable->noOfElems)
+    release_records(hashTable, threads);
+
+    if (hashTable->records != NULL)
     {
-        return;
+        free(hashTable->records);
     }
 
-    Record* record = record_new(key, value);
-    if (record == NULL)
+    free(hashTable->sortedBuckets);
+    free(hashTable->counters);
+
+    bloom_delete(hashTable->bloom);
+    free(hashTable->cache);
+    free(hashTable->wheel);
+    free(hashTable->bulkBlock);
+    free(hashTable);
+}
+
+/*
+    Function: void hashTable_clear(HashTable* hashTable, size_t threads)
+        Removes all records, the table keeps its size, Bloom filter mode, cache budgets and time of the wheel.
+        With threads > 1 separate bucket ranges are released by separate threads.
+*/
+void hashTable_clear(HashTable* hashTable, size_t threads)
+{
+    if (hashTable == NULL)
     {
         return;
     }
 
-    register const size_t index = hash_function(key, hashTable->size);
+    release_records(hashTable, threads);
+    hashTable->noOfElems = 0;
+    free(hashTable->bulkBlock);
+    hashTable->bulkBlock = NULL;
 
-    if (hashTable->records[index] == NULL)
+    if (hashTable->bloom != NULL)
     {
-        // insert new record to hashTable
-        hashTable->records[index] = record;
-        hashTable->noOfElems++;
+        memset(hashTable->bloom->words, 0, hashTable->bloom->blocks * BLOOM_BLOCK_BYTES);
     }
-    else
+
+    if (hashTable->cache != NULL)
     {
-        // if there is a same key, just update data
-        if (strcmp(key, hashTable->records[index]->key) == 0)
-        {
-            // Check if the new value has a different length than the old value, if yes change previously allocated block
-            if (strlen(value) != strlen(hashTable->records[index]->value))
-            {
-                record_delete(hashTable->records[index]);
-                hashTable->records[index] = record;
-            }
+        hashTable->cache->bytes = 0;
+        hashTable->cache->hand = 0;
+    }
 
-            strcpy(hashTable->records[index]->value, value);
-        }
-        // in other case we got the collision (different keys gives same index)
-        else
-        {
-            handle_collision(hashTable, index, record);
-            hashTable->noOfElems++;
-        }
+    if (hashTable->wheel != NULL)
+    {
+        const uint64_t now = hashTable->wheel->now;
+        memset(hashTable->wheel, 0, sizeof(*hashTable->wheel));
+        hashTable->wheel->now = now;
     }
 }
 
 /*
-    void hashTable_delete_record(HashTable* hashTable, const char* key)
-        Delete single record which refers to the given key.
-        If the key refers to the record in collision list, delete also a related node.
+    Function: int hashTable_merge(HashTable* destination, const HashTable* const* sources, size_t count,
+                                  HashTableCombineCallback combine, void* context, size_t threads)
+        Merges not expired records of all sources into the destination, e.g. per-thread counters into global ones.
+        New keys are copied, for a present key combine gets both values and returns the one to keep
+        (without combine the incoming value replaces the present one, as hashTable_insert does).
+        Updated record never expires. Sources are only read, but must not be changed during the merge.
+        With threads > 1 destination buckets are split into ranges merged by separate threads, each of them
+        visits only its range of the sources of the same size as the destination. Destination with a Bloom filter,
+        in cache mode or with expiring records is merged by the calling thread only.
+        Returns 0 if all records were merged, -1 on incorrect arguments or if some of them didn't fit
+        or couldn't be allocated (the others are merged anyway).
 */
-void hashTable_delete_record(HashTable* hashTable, const char* key)
+int hashTable_merge(HashTable* destination, const HashTable* const* sources, size_t count,
+                    HashTableCombineCallback combine, void* context, size_t threads)
 {
-    if (hashTable == NULL || key == NULL || hashTable->noOfElems < 1)
+    if (destination == NULL || sources == NULL)
     {
-        return;
+        return -1;
     }
 
-    register const size_t index = hash_function(key, hashTable->size);
-    if (hashTable->records[index] == NULL)
+    for (size_t s = 0; s < count; ++s)
     {
-        return;
+        if (sources[s] == NULL || sources[s] == destination)
+        {
+            return -1;
+        }
     }
 
-    // Record with given key has been found in the main hashtable records array
-    if (strcmp(hashTable->records[index]->key, key) == 0)
+    // Filter, cache and wheel are shared by all buckets
+    if (threads < 1 || destination->bloom != NULL || destination->cache != NULL || destination->wheel != NULL)
     {
-        record_delete(hashTable->records[index]);
-        hashTable->records[index] = NULL;
-        hashTable->noOfElems--;
-        return;
+        threads = 1;
     }
-    // Index generated from key exists, but the key doesn't match.
-    // Check if we have a collision list.
-    else if (hashTable->collisionList[index] != NULL)
+    else if (threads > destination->size)
     {
-        NodeList* head = hashTable->collisionList[index];
-        NodeList* current = head;
-        Record* record = current->data;
+        threads = destination->size;
+    }
 
-        // Search until the element is found or the list ends
-        while (current != NULL && strcmp(record->key, key) != 0)
-        {
-            current = current->next;
-            if (current != NULL)
-            {
-                record = current->data;
-            }
-        }
+    // Parallel jobs index long chains of their ranges, the array of indexes must not be allocated by one of them
+    if (threads > 1 && destination->sortedBuckets == NULL)
+    {
+        destination->sortedBuckets = calloc(destination->size, sizeof(*destination->sortedBuckets));
+    }
 
-        // Element not found
-        if (current == NULL)
-        {
-            return;
-        }
-        // If deleted element is the head of the list
-        else if (current == head)
-        {
-            hashTable->collisionList[index] = current->next;
-            nodeList_node_delete(&head, record);
-            record_delete(record);
-            hashTable->noOfElems--;
-        }
-        // If deleted element is not the head of the list
-        else
-        {
-            nodeList_node_delete(&head, record);
-            record_delete(record);
-            hashTable->noOfElems--;
-        }
+    MergeJob* jobs = threads > 1 && destination->sortedBuckets != NULL ? malloc(threads * sizeof(*jobs)) : NULL;
+    MergeJob single;
+    if (jobs == NULL)
+    {
+        jobs = &single;
+        threads = 1;
     }
-    // Key not found
-    else
+
+    // Free entries are counted by parallel jobs only if the sources may not fit, it's one more shared cache line
+    size_t slots = destination->size - destination->noOfElems;
+    size_t incoming = 0;
+    for (size_t s = 0; s < count; ++s)
     {
-        return;
+        incoming += sources[s]->noOfElems;
     }
-}
 
-/*
-    const char* hashTable_search(const HashTable* hashTable, const char* key)
-        Search hashtable to find record related with given key.
-        Returns the value of found record.
-*/
-const char* hashTable_search(const HashTable* hashTable, const char* key)
-{
-    if (hashTable == NULL || key == NULL)
+    for (size_t t = 0; t < threads; ++t)
     {
-        return NULL;
+        MergeJob job = {destination, sources, count, combine, context, threads > 1, incoming > slots ? &slots : NULL,
+                        destination->size * t / threads, destination->size * (t + 1) / threads, 0, 0};
+        jobs[t] = job;
     }
 
-    register const size_t index = hash_function(key, hashTable->size);
+    run_jobs(jobs, sizeof(*jobs), threads, merge_job);
 
-    if (index == (size_t)-1)
+    size_t dropped = 0;
+    for (size_t t = 0; t < threads; ++t)
     {
-        return NULL;
+        destination->noOfElems += jobs[t].placed;
+        dropped += jobs[t].dropped;
     }
 
-    if (hashTable->records[index] == NULL)
+    if (jobs != &single)
     {
-        return NULL;
+        free(jobs);
     }
 
-    if (strcmp(hashTable->records[index]->key, key) == 0)
+    return dropped == 0 ? 0 : -1;
+}
+
+/*
+    Function: void hashTable_print(const HashTable* hashTable)
+        This function prints all existing records (and colliding records if exists) within 
+        given hash table. Firstly it prints current index (only if there is a content
+        under that index), and then all data related with this index.
+*/
+void hashTable_print(const HashTable* hashTable)
+{
+    if (hashTable == NULL)
     {
-        return hashTable->records[index]->value;
+        return;
     }
-    else // collision case
+
+    for (size_t i = 0; i < hashTable->size; i++)
     {
-        NodeList* head = hashTable->collisionList[index];
-        Record* record = NULL;
-        while (head != NULL)
+        if (hashTable->records[i] != NULL)
         {
-            record = head->data;
-            if (strcmp(record->key, key) == 0)
+            printf("Index=%zu\tKey: %s, Value: %s\n",
+                    i, 
+                    record_key(hashTable->records[i]),
+                    record_value(hashTable->records[i]));
+
+            for (const Record* rec = hashTable->records[i]->next; rec != NULL; rec = rec->next)
             {
-                return (char*) record->value;
+                printf("\tKey: %s, Value: %s\n", record_key(rec), record_value(rec));
             }
-            head = head->next;
         }
-        return NULL;
     }
 }
 
 /*
-    static size_t hash_function(const char* key, size_t hashTableSize)
-        The algorithm of generating index based on given key.
-        Should not be used by user.
+    Function: void hashTable_insert(HashTable* hashTable, const char* key, const char* value)
+        Inserts copy of the key and value. If the key is already present (also further in the chain),
+        only its value is replaced, so the update works in a full table too and the record
+        keeps its identity. Updated record never expires, even if it was inserted with TTL.
+        New keys are refused when the table is full, unless the table is in cache mode.
 */
-static size_t hash_function(const char* key, size_t hashTableSize)
+void hashTable_insert(HashTable* hashTable, const char* key, const char* value)
 {
-    if (key == NULL)
+    if (hashTable == NULL || key == NULL || value == NULL)
     {
-        return (size_t)-1; // todo think about it could be better
+        return;
     }
 
-    size_t i = 0;
+    // In cache mode old records are evicted instead of refusing the insert
+    if (hashTable->cache != NULL && cache_make_room(hashTable, key, value) != 0)
+    {
+        return;
+    }
+
+    register const uint64_t hash = key_hash(key);
+    register const size_t index = bucket_index(hash, hashTable->size);
+
+    // if there is a same key, just update data
+    Record* present = find_record(hashTable, key, hash, index);
+    if (present != NULL)
+    {
+        timer_cancel(hashTable, present);
+        record_set_value(hashTable, present, value);
+        return;
+    }
+
+    // hashTable is full
+    if (hashTable->size == hashTable->noOfElems)
+    {
+        return;
+    }
 
-    for (size_t j = 0; key[j]; j++)
+    Record* record = record_new(key, value);
+    if (record == NULL)
     {
-        i += (size_t)key[j];
+        return;
     }
 
-    return i % hashTableSize;
+    link_record(hashTable, index, record);
 }
 
 /*
-    static void handle_collision(HashTable* hashTable, size_t index, Record* record)
-        Helper function to handles the collision case.
-        Should not be used by user.
+    Function: int hashTable_insert_owned(HashTable* hashTable, char* key, char* value)
+        Zero-copy insert of heap buffers allocated by malloc: on success the table takes ownership
+        of both and frees them when the record is deleted (on update the key buffer is freed right away,
+        the present key is kept). Only the Record structure (and a collision node) is allocated.
+        Returns 0 on success, -1 if the insert is refused, then the buffers still belong to the caller.
 */
-static void handle_collision(HashTable* hashTable, size_t index, Record* record)
+int hashTable_insert_owned(HashTable* hashTable, char* key, char* value)
 {
-    if (hashTable == NULL || record == NULL)
+    return insert_record(hashTable, key, value, 0);
+}
+
+/*
+    Function: int hashTable_insert_borrowed(HashTable* hashTable, const char* key, const char* value)
+        Zero-copy insert storing the caller's pointers (e.g. string literals), which must stay valid
+        and unchanged while they are in the table. They are never written or freed by the table.
+        Returns 0 on success, -1 if the insert is refused.
+*/
+int hashTable_insert_borrowed(HashTable* hashTable, const char* key, const char* value)
+{
+    // Borrowed strings are only read, RECORD_*_BORROWED flags protect them from writes and free
+    return insert_record(hashTable, (char*)(uintptr_t)key, (char*)(uintptr_t)value,
+                         RECORD_KEY_BORROWED | RECORD_VALUE_BORROWED);
+}
+
+/*
+    Function: void hashTable_insert_ttl(HashTable* hashTable, const char* key, const char* value, uint64_t ttl)
+        Same as hashTable_insert, but the record expires ttl units after the current time of the table
+        (the last now given to hashTable_expire since the first TTL record was inserted, 0 before). Expired records are not found
+        by lookups any more and they are deleted by hashTable_expire.
+        The wheel is allocated by the first TTL record actually inserted, a refused insert leaves the table untouched.
+        If the timer can't be allocated, nothing is inserted. If the wheel can't be allocated,
+        the just inserted record is deleted again, as if it expired at once.
+*/
+void hashTable_insert_ttl(HashTable* hashTable, const char* key, const char* value, uint64_t ttl)
+{
+    if (hashTable == NULL || key == NULL || value == NULL)
+    {
+        return;
+    }
+
+    HashTableTimer* timer = malloc(sizeof(*timer));
+    if (timer == NULL)
     {
         return;
     }
 
-    NodeList* head = hashTable->collisionList[index];
+    hashTable_insert(hashTable, key, value);
 
-    // if list does not exist yet
-    if (head == NULL)
+    const uint64_t hash = key_hash(key);
+    const size_t index = bucket_index(hash, hashTable->size);
+    Record* record = find_record(hashTable, key, hash, index);
+    if (record == NULL)
+    {
+        // Insert refused
+        free(timer);
+        return;
+    }
+
+    HashTableWheel* wheel = wheel_get(hashTable);
+    if (wheel == NULL)
     {
-        // Creates the list.
-        head = nodeList_new(record);
-        hashTable->collisionList[index] = head;
+        free(timer);
+        remove_record(hashTable, index, find_link(hashTable, key, hash, index));
         return;
     }
 
-    // Insert to the list.
-    nodeList_insert(&head, record);
-    hashTable->collisionList[index] = head;
+    timer->record = record;
+    timer->expiresAt = ttl < UINT64_MAX - wheel->now ? wheel->now + ttl : UINT64_MAX;
+    record->timer = timer;
+    wheel_add(wheel, timer);
 }
 
+/*
+    Function: size_t hashTable_expire(HashTable* hashTable, uint64_t now, size_t maxWork)
+        Advances the time of the table to now (in the same units as TTL, time never goes back) and deletes
+        at most maxWork expired records. Only the wheel slots passed since the previous call are visited,
+        the record chains are never scanned. Records expired over the maxWork limit
+        are already hidden from lookups and are deleted by following calls. A table which never had
+        a TTL record is left untouched.
+        Returns number of deleted records.
+*/
+size_t hashTable_expire(HashTable* hashTable, uint64_t now, size_t maxWork)
+{
+    if (hashTable == NULL)
+    {
+        return 0;
+    }
+
+    // Table without TTL records has nothing to expire, don't allocate a wheel for it
+    HashTableWheel* wheel = hashTable->wheel;
+    if (wheel == NULL)
+    {
+        return 0;
+    }
+
+    wheel_advance(wheel, now);
+
+    size_t deleted = 0;
+    while (deleted < maxWork && wheel->due != NULL)
+    {
+        Record* record = wheel->due->record;
+        const size_t index = bucket_index(record->hash, hashTable->size);
+        remove_record(hashTable, index, find_link(hashTable, record_key(record), record->hash, index));
+        deleted++;
+    }
+
+    return deleted;
+}
+
+/*
+    void hashTable_delete_record(HashTable* hashTable, const char* key)
+        Delete single record which refers to the given key.
+        The chain under the index is walked once (bisected if it is indexed), the link pointing
+        to the found record is redirected to the next record of the chain.
+*/
+void hashTable_delete_record(HashTable* hashTable, const char* key)
+{
+    if (hashTable == NULL || key == NULL || hashTable->noOfElems < 1)
+    {
+        return;
+    }
+
+    register const uint64_t hash = key_hash(key);
+    register const size_t index = bucket_index(hash, hashTable->size);
+    Record** link = find_link(hashTable, key, hash, index);
+
+    // Key not found
+    if (link == NULL)
+    {
+        return;
+    }
+
+    remove_record(hashTable, index, link);
+}
+
+/*
+    const char* hashTable_search(const HashTable* hashTable, const char* key)
+        Search hashtable to find record related with given key.
+        Returns the value of found record.
+        Any number of threads may search the same table at once while no thread modifies it.
+        The only writes of a lookup, the reference bit and hit/miss counts of cache mode and
+        the HASHTABLE_COUNTERS counters, are relaxed atomic updates.
+*/
+const char* hashTable_search(const HashTable* hashTable, const char* key)
+{
+    if (hashTable == NULL || key == NULL)
+    {
+        return NULL;
+    }
+
+    COUNT_LOOKUP(hashTable);
+
+    register const uint64_t hash = key_hash(key);
+    register const size_t index = bucket_index(hash, hashTable->size);
+    Record* record = NULL;
+    if (hashTable->bloom != NULL && !bloom_may_contain(hashTable->bloom, hash))
+    {
+        COUNT_FILTERED(hashTable);
+    }
+    else
+    {
+        record = search_bucket(hashTable, key, hash, index);
+    }
+
+    // Lazy expiry, the record is deleted later by hashTable_expire
+    if (record != NULL && record_expired(hashTable, record))
+    {
+        record = NULL;
+    }
+
+    if (hashTable->cache != NULL)
+    {
+        cache_lookup(hashTable->cache, record);
+    }
+
+    return record != NULL ? lookup_value(record) : NULL;
+}
+
+/*
+    void hashTable_search_batch(const HashTable* hashTable, const char* const* keys, const char** values, size_t count)
+        Searches values for count keys at once, values[i] is set the same way as hashTable_search(keys[i]) would return.
+        Keys go in groups of HASHTABLE_BATCH_GROUP through a software pipeline of HASHTABLE_BATCH_STAGES stages:
+        hash the keys and prefetch their bucket slots (and Bloom filter blocks), read the slots and
+        prefetch the first records, prefetch the keys of records whose key is not inline, compare.
+        Every step works on a different group, so a line prefetched by one stage had the work
+        of a whole group to arrive before the next stage reads it, and cache misses of different
+        keys overlap instead of being paid one after another. Keys rejected by the Bloom filter
+        skip the remaining stages.
+        Concurrent calls are safe under the same conditions as hashTable_search.
+*/
+void hashTable_search_batch(const HashTable* hashTable, const char* const* keys, const char** values, size_t count)
+{
+    if (hashTable == NULL || keys == NULL || values == NULL)
+    {
+        return;
+    }
+
+    BatchGroup groups[HASHTABLE_BATCH_STAGES];
+    const size_t noOfGroups = (count + HASHTABLE_BATCH_GROUP - 1) / HASHTABLE_BATCH_GROUP;
+
+    // Step s starts group s and moves the groups started before it one stage further
+    for (size_t step = 0; step < noOfGroups + HASHTABLE_BATCH_STAGES - 1; ++step)
+    {
+        if (step < noOfGroups)
+        {
+            const size_t start = step * HASHTABLE_BATCH_GROUP;
+            BatchGroup* group = &groups[step % HASHTABLE_BATCH_STAGES];
+            group->start = start;
+            group->n = count - start < HASHTABLE_BATCH_GROUP ? count - start : HASHTABLE_BATCH_GROUP;
+            batch_hash(hashTable, group, keys + start);
+        }
+
+        if (step >= 1 && step - 1 < noOfGroups)
+        {
+            batch_load_heads(hashTable, &groups[(step - 1) % HASHTABLE_BATCH_STAGES]);
+        }
+
+        if (step >= 2 && step - 2 < noOfGroups)
+        {
+            batch_prefetch_keys(&groups[(step - 2) % HASHTABLE_BATCH_STAGES]);
+        }
+
+        if (step >= 3)
+        {
+            const BatchGroup* group = &groups[(step - 3) % HASHTABLE_BATCH_STAGES];
+            batch_resolve(hashTable, group, keys + group->start, values + group->start);
+        }
+    }
+}
+
+/*
+    static void batch_hash(const HashTable* hashTable, BatchGroup* group, const char* const* keys)
+        First stage of hashTable_search_batch: hashes the keys of the group and prefetches their
+        bucket slots and Bloom filter blocks. NULL keys get no index and are not looked up.
+        Should not be used by user.
+*/
+static void batch_hash(const HashTable* hashTable, BatchGroup* group, const char* const* keys)
+{
+    for (size_t i = 0; i < group->n; ++i)
+    {
+        group->indexes[i] = (size_t)-1;
+        if (keys[i] == NULL)
+        {
+            continue;
+        }
+
+        group->hashes[i] = key_hash(keys[i]);
+        group->indexes[i] = bucket_index(group->hashes[i], hashTable->size);
+        if (hashTable->bloom != NULL)
+        {
+            HASHTABLE_PREFETCH(BLOOM_BLOCK(hashTable->bloom, group->hashes[i]));
+        }
+        HASHTABLE_PREFETCH(&hashTable->records[group->indexes[i]]);
+    }
+}
+
+/*
+    static void batch_load_heads(const HashTable* hashTable, BatchGroup* group)
+        Second stage of hashTable_search_batch: drops keys rejected by the Bloom filter, reads the
+        bucket slots prefetched by the first stage and prefetches the first record of every chain.
+        Should not be used by user.
+*/
+static void batch_load_heads(const HashTable* hashTable, BatchGroup* group)
+{
+    for (size_t i = 0; i < group->n; ++i)
+    {
+        group->heads[i] = NULL;
+        if (group->indexes[i] == (size_t)-1)
+        {
+            continue;
+        }
+
+        if (hashTable->bloom != NULL && !bloom_may_contain(hashTable->bloom, group->hashes[i]))
+        {
+            COUNT_FILTERED(hashTable);
+            group->indexes[i] = (size_t)-1;
+            continue;
+        }
+
+        group->heads[i] = hashTable->records[group->indexes[i]];
+        if (group->heads[i] != NULL)
+        {
+            HASHTABLE_PREFETCH(group->heads[i]);
+        }
+    }
+}
+
+/*
+    static void batch_prefetch_keys(const BatchGroup* group)
+        Third stage of hashTable_search_batch: reads the first records prefetched a group ago and
+        prefetches their keys stored outside of the record. Inline keys came with the record already.
+        Should not be used by user.
+*/
+static void batch_prefetch_keys(const BatchGroup* group)
+{
+    for (size_t i = 0; i < group->n; ++i)
+    {
+        if (group->heads[i] != NULL && !(lookup_flags(group->heads[i]) & RECORD_KEY_INLINE))
+        {
+            HASHTABLE_PREFETCH(group->heads[i]->key.ptr);
+        }
+    }
+}
+
+/*
+    static void batch_resolve(const HashTable* hashTable, const BatchGroup* group, const char* const* keys, const char** values)
+        Last stage of hashTable_search_batch: looks up every key of the group like hashTable_search,
+        the first probe of each key should hit the cache now.
+        Should not be used by user.
+*/
+static void batch_resolve(const HashTable* hashTable, const BatchGroup* group, const char* const* keys, const char** values)
+{
+    for (size_t i = 0; i < group->n; ++i)
+    {
+        COUNT_LOOKUP(hashTable);
+        Record* record = group->indexes[i] != (size_t)-1 ? search_bucket(hashTable, keys[i], group->hashes[i], group->indexes[i]) : NULL;
+        if (record != NULL && record_expired(hashTable, record))
+        {
+            record = NULL;
+        }
+        if (hashTable->cache != NULL && keys[i] != NULL)
+        {
+            cache_lookup(hashTable->cache, record);
+        }
+        values[i] = record != NULL ? lookup_value(record) : NULL;
+    }
+}
+
+/*
+    void hashTable_iterator_init(HashTableIterator* iterator, const HashTable* hashTable)
+        Positions the iterator before the first record of the table, nothing is allocated.
+*/
+void hashTable_iterator_init(HashTableIterator* iterator, const HashTable* hashTable)
+{
+    if (iterator == NULL)
+    {
+        return;
+    }
+
+    iterator->hashTable = hashTable;
+    iterator->index = 0;
+    iterator->next = hashTable != NULL ? iterator_skip(hashTable, &iterator->index, hashTable->records[0]) : NULL;
+}
+
+/*
+    const Record* hashTable_iterator_next(HashTableIterator* iterator)
+        Returns the next record in bucket order, NULL after the last one. Expired records
+        are skipped as lookups skip them. The following record is found before returning,
+        so the returned one can be deleted (hashTable_delete_record) before the next call.
+        Any other change of the table invalidates the iterator.
+*/
+const Record* hashTable_iterator_next(HashTableIterator* iterator)
+{
+    if (iterator == NULL || iterator->next == NULL)
+    {
+        return NULL;
+    }
+
+    const Record* record = iterator->next;
+    iterator->next = iterator_skip(iterator->hashTable, &iterator->index, record->next);
+    return record;
+}
+
+/*
+    size_t hashTable_scan(const HashTable* hashTable, size_t cursor, size_t count, HashTableScanCallback callback, void* context)
+        Incremental traversal in the manner of Redis SCAN: start with cursor 0 and pass the returned
+        cursor to the next call until it returns 0 again. Every call passes about count records
+        to the callback (whole buckets, so a long chain can exceed it) and visits at most
+        SCAN_BUCKETS_PER_RECORD * count buckets. The table can be modified freely between calls:
+        every key present during the whole scan is passed exactly once, keys inserted or deleted
+        meanwhile may or may not be. The callback itself must not modify the table.
+        The table never resizes, so the cursor is simply the next bucket index
+        (the reverse binary order of Redis is needed only for tables which grow).
+*/
+size_t hashTable_scan(const HashTable* hashTable, size_t cursor, size_t count, HashTableScanCallback callback, void* context)
+{
+    if (hashTable == NULL || callback == NULL || cursor >= hashTable->size)
+    {
+        return 0;
+    }
+
+    if (count < 1)
+    {
+        count = 1;
+    }
+
+    size_t passed = 0;
+    for (size_t visited = 0; cursor < hashTable->size && passed < count && visited < SCAN_BUCKETS_PER_RECORD * count;
+         ++visited, ++cursor)
+    {
+        for (const Record* record = hashTable->records[cursor]; record != NULL; record = record->next)
+        {
+            if (!record_expired(hashTable, record))
+            {
+                callback(record_key(record), record_value(record), context);
+                passed++;
+            }
+        }
+    }
+
+    return cursor < hashTable->size ? cursor : 0;
+}
+
+/*
+    void hashTable_stats(const HashTable* hashTable, HashTableStats* stats)
+        Fills stats with the shape of given hash table: load factor, bucket occupancy,
+        collision chain lengths and memory usage. It walks every bucket once and prints nothing,
+        so it can be called periodically on a live table. Lookup counters are copied only
+        when the module is compiled with HASHTABLE_COUNTERS, otherwise they stay zero.
+*/
+void hashTable_stats(const HashTable* hashTable, HashTableStats* stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+
+    if (hashTable == NULL)
+    {
+        return;
+    }
+
+    stats->size = hashTable->size;
+    stats->noOfElems = hashTable->noOfElems;
+    stats->loadFactor = (double)hashTable->noOfElems / (double)hashTable->size;
+    stats->bytesAllocated = sizeof(*hashTable) + hashTable->size * sizeof(*hashTable->records);
+
+    size_t chained = 0;
+
+    if (hashTable->sortedBuckets != NULL)
+    {
+        stats->bytesAllocated += hashTable->size * sizeof(*hashTable->sortedBuckets);
+    }
+
+    for (size_t i = 0; i < hashTable->size; ++i)
+    {
+        size_t chain = 0;
+
+        const HashTableSortedBucket* sorted = hashTable->sortedBuckets != NULL ? hashTable->sortedBuckets[i] : NULL;
+        if (sorted != NULL)
+        {
+            stats->sortedBuckets++;
+            stats->bytesAllocated += sizeof(*sorted) + sorted->capacity * sizeof(*sorted->records);
+        }
+
+        for (const Record* record = hashTable->records[i]; record != NULL; record = record->next)
+        {
+            stats->bytesAllocated += sizeof(*record) + record_heap_bytes(record);
+            chain++;
+        }
+
+        if (chain > 0)
+        {
+            stats->occupiedBuckets++;
+            chained += chain;
+        }
+
+        if (chain > stats->longestChain)
+        {
+            stats->longestChain = chain;
+        }
+
+        stats->chainHistogram[chain < HASHTABLE_STATS_BINS ? chain : HASHTABLE_STATS_BINS - 1]++;
+    }
+
+    if (stats->occupiedBuckets > 0)
+    {
+        stats->meanChain = (double)chained / (double)stats->occupiedBuckets;
+    }
+
+    if (hashTable->bloom != NULL)
+    {
+        stats->bytesAllocated += sizeof(*hashTable->bloom) + (hashTable->bloom->blocks + 1) * BLOOM_BLOCK_BYTES;
+    }
+
+    if (hashTable->cache != NULL)
+    {
+        stats->bytesAllocated += sizeof(*hashTable->cache);
+        stats->cache = *hashTable->cache;
+    }
+
+    if (hashTable->wheel != NULL)
+    {
+        stats->bytesAllocated += sizeof(*hashTable->wheel);
+        for (size_t level = 0; level <= HASHTABLE_WHEEL_DUE; ++level)
+        {
+            stats->bytesAllocated += hashTable->wheel->pending[level] * sizeof(HashTableTimer);
+        }
+    }
+
+    if (hashTable->counters != NULL)
+    {
+        stats->bytesAllocated += sizeof(*hashTable->counters);
+        stats->counters = *hashTable->counters;
+    }
+}
+
+/*
+    void hashTable_reset_counters(const HashTable* hashTable)
+        Zeroes the lookup counters, does nothing when compiled without HASHTABLE_COUNTERS.
+*/
+void hashTable_reset_counters(const HashTable* hashTable)
+{
+    if (hashTable == NULL || hashTable->counters == NULL)
+    {
+        return;
+    }
+
+    memset(hashTable->counters, 0, sizeof(*hashTable->counters));
+}
+
+/*
+    int hashTable_bloom_enable(HashTable* hashTable, size_t bitsPerKey, int mode)
+        Builds a blocked Bloom filter of all keys in the table, after that hashTable_search and
+        hashTable_search_batch reject most absent keys by reading a single cache line, without
+        touching buckets or comparing any key. Filter is sized for the table size (the most keys
+        the table can hold) with bitsPerKey positions per key, HASHTABLE_BLOOM_BITS_PER_KEY if 0.
+        HASHTABLE_BLOOM_PLAIN keeps bits of deleted keys until hashTable_bloom_rebuild,
+        HASHTABLE_BLOOM_COUNTING uses 4-bit counters (four times the memory) and forgets deleted keys.
+        Previously enabled filter is replaced. Returns 0 on success, -1 otherwise (the table is not changed).
+*/
+int hashTable_bloom_enable(HashTable* hashTable, size_t bitsPerKey, int mode)
+{
+    if (hashTable == NULL || (mode != HASHTABLE_BLOOM_PLAIN && mode != HASHTABLE_BLOOM_COUNTING))
+    {
+        return -1;
+    }
+
+    const size_t capacity = hashTable->size > hashTable->noOfElems ? hashTable->size : hashTable->noOfElems;
+    HashTableBloom* bloom = bloom_new(capacity, bitsPerKey > 0 ? bitsPerKey : HASHTABLE_BLOOM_BITS_PER_KEY, mode);
+    if (bloom == NULL)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < hashTable->size; ++i)
+    {
+        for (const Record* record = hashTable->records[i]; record != NULL; record = record->next)
+        {
+            bloom_add(bloom, record->hash);
+        }
+    }
+
+    bloom_delete(hashTable->bloom);
+    hashTable->bloom = bloom;
+    return 0;
+}
+
+/*
+    int hashTable_cache_enable(HashTable* hashTable, size_t maxElems, size_t maxBytes)
+        Turns the table into a bounded cache: instead of refusing inserts when full, hashTable_insert
+        evicts old records (CLOCK, approximation of LRU) until the new one fits into at most maxElems
+        records (0 or more than the table size means the table size) and maxBytes of records and
+        their strings (0 means unlimited). Lookups mark found records as referenced, which protects
+        them from the next pass of the eviction hand, and count hits and misses.
+        Records over the budget are evicted immediately. Calling it again changes the budgets and keeps counters.
+        Returns 0 on success, -1 otherwise.
+*/
+int hashTable_cache_enable(HashTable* hashTable, size_t maxElems, size_t maxBytes)
+{
+    if (hashTable == NULL)
+    {
+        return -1;
+    }
+
+    if (hashTable->cache == NULL)
+    {
+        hashTable->cache = calloc(1, sizeof(*hashTable->cache));
+        if (hashTable->cache == NULL)
+        {
+            return -1;
+        }
+
+        for (size_t i = 0; i < hashTable->size; ++i)
+        {
+            for (const Record* record = hashTable->records[i]; record != NULL; record = record->next)
+            {
+                hashTable->cache->bytes += record_bytes(record_key(record), record_value(record));
+            }
+        }
+    }
+
+    HashTableCache* cache = hashTable->cache;
+    cache->maxElems = maxElems;
+    cache->maxBytes = maxBytes;
+
+    const size_t limit = maxElems > 0 && maxElems < hashTable->size ? maxElems : hashTable->size;
+    while (hashTable->noOfElems > limit || (maxBytes > 0 && cache->bytes > maxBytes))
+    {
+        if (!cache_evict(hashTable))
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/*
+    void hashTable_cache_disable(HashTable* hashTable)
+        Leaves cache mode, records stay in the table and inserts are refused again when it is full.
+*/
+void hashTable_cache_disable(HashTable* hashTable)
+{
+    if (hashTable == NULL)
+    {
+        return;
+    }
+
+    free(hashTable->cache);
+    hashTable->cache = NULL;
+}
+
+/*
+    int hashTable_bloom_rebuild(HashTable* hashTable)
+        Builds the filter again with its current settings, resized if the table holds more keys than
+        it was sized for. Clears positions left by deleted keys in HASHTABLE_BLOOM_PLAIN mode
+        and counters saturated in HASHTABLE_BLOOM_COUNTING mode.
+        Returns 0 on success, -1 if the filter is not enabled or allocation fails (the old filter stays).
+*/
+int hashTable_bloom_rebuild(HashTable* hashTable)
+{
+    if (hashTable == NULL || hashTable->bloom == NULL)
+    {
+        return -1;
+    }
+
+    return hashTable_bloom_enable(hashTable, hashTable->bloom->bitsPerKey, hashTable->bloom->mode);
+}
+
+/*
+    void hashTable_bloom_disable(HashTable* hashTable)
+        Releases the filter, lookups go directly to buckets again.
+*/
+void hashTable_bloom_disable(HashTable* hashTable)
+{
+    if (hashTable == NULL)
+    {
+        return;
+    }
+
+    bloom_delete(hashTable->bloom);
+    hashTable->bloom = NULL;
+}
+
+/*
+    static int key_equals(const Record* record, const char* key, uint64_t hash)
+        Checks whether the record holds given key of given full hash. The stored hash is compared first,
+        so the strings are read only on a hash match, i.e. about once per lookup.
+        Inline keys are padded with zeros, the probe is copied into the same padded form and both are
+        compared as RECORD_INLINE_WORDS words. For the others the same pointer (e.g. canonical string
+        of an interning pool inserted by hashTable_insert_borrowed) is equal without reading the strings,
+        different ones are compared by strcmp.
+        Should not be used by user.
+*/
+static int key_equals(const Record* record, const char* key, uint64_t hash)
+{
+    if (record->hash != hash)
+    {
+        return 0;
+    }
+
+    if (!(lookup_flags(record) & RECORD_KEY_INLINE))
+    {
+        return record->key.ptr == key || strcmp(record->key.ptr, key) == 0;
+    }
+
+    const size_t len = strlen(key);
+    if (!RECORD_FITS_INLINE(len))
+    {
+        return 0;
+    }
+
+    uint64_t probe[RECORD_INLINE_WORDS] = {0};
+    memcpy(probe, key, len);
+
+    uint64_t diff = 0;
+    for (size_t i = 0; i < RECORD_INLINE_WORDS; ++i)
+    {
+        diff |= probe[i] ^ record->key.words[i];
+    }
+
+    return diff == 0;
+}
+
+/*
+    static char* record_key_buffer(Record* record)
+        Writable key of the record, inline buffer or the separate string.
+        Should not be used by user.
+*/
+static char* record_key_buffer(Record* record)
+{
+    return (record->flags & RECORD_KEY_INLINE) ? (char*)record->key.words : record->key.ptr;
+}
+
+/*
+    static char* record_value_buffer(Record* record)
+        Writable value of the record, inline buffer or the separate string.
+        Should not be used by user.
+*/
+static char* record_value_buffer(Record* record)
+{
+    return (record->flags & RECORD_VALUE_INLINE) ? (char*)record->value.words : record->value.ptr;
+}
+
+/*
+    static unsigned int lookup_flags(const Record* record)
+        Flags of a record read by a lookup. Concurrent lookups of cache mode set RECORD_REFERENCED
+        by cache_lookup at the same time, so the flags are read by the matching relaxed atomic load.
+        Should not be used by user.
+*/
+static unsigned int lookup_flags(const Record* record)
+{
+    return __atomic_load_n(&record->flags, __ATOMIC_RELAXED);
+}
+
+/*
+    static const char* lookup_key(const Record* record)
+        record_key for the lookup paths, flags are read by lookup_flags.
+        Should not be used by user.
+*/
+static const char* lookup_key(const Record* record)
+{
+    return (lookup_flags(record) & RECORD_KEY_INLINE) ? (const char*)record->key.words : record->key.ptr;
+}
+
+/*
+    static const char* lookup_value(const Record* record)
+        record_value for the lookup paths, flags are read by lookup_flags.
+        Should not be used by user.
+*/
+static const char* lookup_value(const Record* record)
+{
+    return (lookup_flags(record) & RECORD_VALUE_INLINE) ? (const char*)record->value.words : record->value.ptr;
+}
+
+/*
+    static size_t record_heap_bytes(const Record* record)
+        Size of the strings of the record stored outside of the Record structure.
+        Should not be used by user.
+*/
+static size_t record_heap_bytes(const Record* record)
+{
+    size_t bytes = 0;
+
+    if (!(record->flags & RECORD_KEY_INLINE))
+    {
+        bytes += strlen(record->key.ptr) + 1;
+    }
+    if (!(record->flags & RECORD_VALUE_INLINE))
+    {
+        bytes += strlen(record->value.ptr) + 1;
+    }
+
+    return bytes;
+}
+
+/*
+    static Record* search_bucket(const HashTable* hashTable, const char* key, uint64_t hash, size_t index)
+        Looks for the key in the chain of records under given index, counting the probes.
+        Keys are compared only for records with the same full hash.
+        Long chains are bisected through their sorted index, so a lookup takes O(log n) compares.
+        Should not be used by user.
+*/
+static Record* search_bucket(const HashTable* hashTable, const char* key, uint64_t hash, size_t index)
+{
+    const HashTableSortedBucket* sorted = hashTable->sortedBuckets != NULL ? hashTable->sortedBuckets[index] : NULL;
+    if (sorted != NULL)
+    {
+        size_t position = 0;
+        size_t compares = 0;
+        const int found = sorted_find(sorted, hash, key, &position, &compares);
+        COUNT_PROBES(hashTable, compares);
+        return found ? sorted->records[position] : NULL;
+    }
+
+    for (Record* record = hashTable->records[index]; record != NULL; record = record->next)
+    {
+        COUNT_PROBE(hashTable);
+        if (key_equals(record, key, hash))
+        {
+            return record;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    static Record* find_record(const HashTable* hashTable, const char* key, uint64_t hash, size_t index)
+        Same as search_bucket, but doesn't count the probes. Used by modifying operations.
+        Should not be used by user.
+*/
+static Record* find_record(const HashTable* hashTable, const char* key, uint64_t hash, size_t index)
+{
+    Record** link = find_link(hashTable, key, hash, index);
+    return link != NULL ? *link : NULL;
+}
+
+/*
+    static Record** find_link(const HashTable* hashTable, const char* key, uint64_t hash, size_t index)
+        Finds the link pointing to the record of given key: the slot of the records array
+        or the next pointer of the previous record in the chain. Returns NULL if key is not present.
+        Indexed chains are linked in sorted order, so the previous record is the previous slot of the index.
+        Should not be used by user.
+*/
+static Record** find_link(const HashTable* hashTable, const char* key, uint64_t hash, size_t index)
+{
+    const HashTableSortedBucket* sorted = hashTable->sortedBuckets != NULL ? hashTable->sortedBuckets[index] : NULL;
+    if (sorted != NULL)
+    {
+        size_t position = 0;
+        size_t compares = 0;
+        if (!sorted_find(sorted, hash, key, &position, &compares))
+        {
+            return NULL;
+        }
+        return position == 0 ? &hashTable->records[index] : &sorted->records[position - 1]->next;
+    }
+
+    for (Record** link = &hashTable->records[index]; *link != NULL; link = &(*link)->next)
+    {
+        if (key_equals(*link, key, hash))
+        {
+            return link;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    static void remove_record(HashTable* hashTable, size_t index, Record** link)
+        Unlinks the record the link points to (from the sorted index of the bucket too),
+        updates the filter and cache accounting and deletes the record.
+        Should not be used by user.
+*/
+static void remove_record(HashTable* hashTable, size_t index, Record** link)
+{
+    Record* record = *link;
+    *link = record->next;
+
+    if (hashTable->sortedBuckets != NULL && hashTable->sortedBuckets[index] != NULL)
+    {
+        sorted_remove(hashTable, index, record);
+    }
+
+    if (hashTable->bloom != NULL)
+    {
+        bloom_remove(hashTable->bloom, record->hash);
+    }
+
+    if (hashTable->cache != NULL)
+    {
+        hashTable->cache->bytes -= record_bytes(record_key(record), record_value(record));
+    }
+
+    timer_cancel(hashTable, record);
+    record_delete(record);
+    hashTable->noOfElems--;
+}
+
+/*
+    static size_t record_bytes(const char* key, const char* value)
+        Memory charged to the cache budget for one record: the structure and both strings.
+        Should not be used by user.
+*/
+static size_t record_bytes(const char* key, const char* value)
+{
+    return sizeof(Record) + strlen(key) + strlen(value) + 2;
+}
+
+/*
+    static int cache_make_room(HashTable* hashTable, const char* key, const char* value)
+        Evicts records until inserting the key fits into the entry and memory budgets.
+        Update of present key needs no entry and only the growth of its value.
+        Returns 0 if there is room, -1 if the record alone exceeds the memory budget.
+        Should not be used by user.
+*/
+static int cache_make_room(HashTable* hashTable, const char* key, const char* value)
+{
+    HashTableCache* cache = hashTable->cache;
+    const uint64_t hash = key_hash(key);
+    const size_t index = bucket_index(hash, hashTable->size);
+    const size_t maxElems = cache->maxElems > 0 && cache->maxElems < hashTable->size ? cache->maxElems
+                                                                                     : hashTable->size;
+
+    if (cache->maxBytes > 0 && record_bytes(key, value) > cache->maxBytes)
+    {
+        return -1;
+    }
+
+    for (;;)
+    {
+        // Checked again after every eviction, the present key may be the evicted one
+        const Record* present = find_record(hashTable, key, hash, index);
+        const size_t entries = hashTable->noOfElems + (present == NULL ? 1 : 0);
+        const size_t bytes = present == NULL ? cache->bytes + record_bytes(key, value)
+                                             : cache->bytes - strlen(record_value(present)) + strlen(value);
+
+        if (entries <= maxElems && (cache->maxBytes == 0 || bytes <= cache->maxBytes))
+        {
+            return 0;
+        }
+
+        if (!cache_evict(hashTable))
+        {
+            return -1;
+        }
+    }
+}
+
+/*
+    static int cache_evict(HashTable* hashTable)
+        CLOCK eviction: the hand walks buckets (whole chain of each) and clears reference bits
+        of recently looked up records until it finds one without the bit, which is removed.
+        Two rounds over the table are enough, since the first one clears all bits.
+        Returns 1 if a record was evicted, 0 if the table is empty.
+        Should not be used by user.
+*/
+static int cache_evict(HashTable* hashTable)
+{
+    HashTableCache* cache = hashTable->cache;
+
+    for (size_t step = 0; hashTable->noOfElems > 0 && step <= 2 * hashTable->size; ++step)
+    {
+        const size_t index = cache->hand < hashTable->size ? cache->hand : 0;
+        cache->hand = index + 1 < hashTable->size ? index + 1 : 0;
+
+        for (Record** link = &hashTable->records[index]; *link != NULL; link = &(*link)->next)
+        {
+            if ((*link)->flags & RECORD_REFERENCED)
+            {
+                (*link)->flags &= ~RECORD_REFERENCED;
+            }
+            else
+            {
+                remove_record(hashTable, index, link);
+                cache->evictions++;
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+    static void cache_lookup(HashTableCache* cache, Record* record)
+        Records the lookup result. A hit only sets the reference bit of the found record,
+        so there is no list to update and no extra cache line touched. Updates are relaxed atomics,
+        lookups of other threads may run at the same time.
+        Should not be used by user.
+*/
+static void cache_lookup(HashTableCache* cache, Record* record)
+{
+    if (record != NULL)
+    {
+        __atomic_fetch_add(&cache->hits, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_or(&record->flags, RECORD_REFERENCED, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_fetch_add(&cache->misses, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/*
+    static void record_set_value(HashTable* hashTable, Record* record, const char* value)
+        Replaces the value of a record present in the table. Value of the same length is overwritten
+        in place, otherwise (or if the old one is borrowed) it is copied to the inline buffer if it fits,
+        or to a new allocation.
+        On allocation failure the old value is kept.
+        Should not be used by user.
+*/
+static void record_set_value(HashTable* hashTable, Record* record, const char* value)
+{
+    const size_t oldLen = strlen(record_value(record));
+    const size_t newLen = strlen(value);
+
+    if (oldLen == newLen && !(record->flags & RECORD_VALUE_BORROWED))
+    {
+        strcpy(record_value_buffer(record), value);
+        return;
+    }
+
+    char* copy = NULL;
+    if (!RECORD_FITS_INLINE(newLen))
+    {
+        copy = malloc(newLen + 1);
+        if (copy == NULL)
+        {
+            return;
+        }
+    }
+
+    if (!(record->flags & (RECORD_VALUE_BORROWED | RECORD_VALUE_INLINE)))
+    {
+        free(record->value.ptr);
+    }
+    record->flags &= ~(RECORD_VALUE_BORROWED | RECORD_VALUE_INLINE);
+    if (copy == NULL)
+    {
+        record->flags |= RECORD_VALUE_INLINE;
+    }
+    else
+    {
+        record->value.ptr = copy;
+    }
+    strcpy(record_value_buffer(record), value);
+
+    if (hashTable->cache != NULL)
+    {
+        hashTable->cache->bytes += newLen;
+        hashTable->cache->bytes -= oldLen;
+    }
+}
+
+/*
+    static int insert_record(HashTable* hashTable, char* key, char* value, unsigned int flags)
+        Common part of zero-copy inserts, flags tell which of the strings are borrowed.
+        Present key gets the new value pointer, otherwise a Record is allocated around given strings.
+        Returns 0 on success, -1 if the insert is refused and nothing was taken over.
+        Should not be used by user.
+*/
+static int insert_record(HashTable* hashTable, char* key, char* value, unsigned int flags)
+{
+    if (hashTable == NULL || key == NULL || value == NULL)
+    {
+        return -1;
+    }
+
+    // In cache mode old records are evicted instead of refusing the insert
+    if (hashTable->cache != NULL && cache_make_room(hashTable, key, value) != 0)
+    {
+        return -1;
+    }
+
+    const uint64_t hash = key_hash(key);
+    register const size_t index = bucket_index(hash, hashTable->size);
+
+    Record* present = find_record(hashTable, key, hash, index);
+    if (present != NULL)
+    {
+        timer_cancel(hashTable, present);
+        if (hashTable->cache != NULL)
+        {
+            hashTable->cache->bytes += strlen(value);
+            hashTable->cache->bytes -= strlen(record_value(present));
+        }
+        if (!(present->flags & (RECORD_VALUE_BORROWED | RECORD_VALUE_INLINE)) && present->value.ptr != value)
+        {
+            free(present->value.ptr);
+        }
+        present->value.ptr = value;
+        present->flags = (present->flags & ~(RECORD_VALUE_BORROWED | RECORD_VALUE_INLINE)) | (flags & RECORD_VALUE_BORROWED);
+
+        // Present key is kept, the new one is released if it was handed over
+        if (key != record_key(present) && !(flags & RECORD_KEY_BORROWED))
+        {
+            free(key);
+        }
+        return 0;
+    }
+
+    // hashTable is full
+    if (hashTable->size == hashTable->noOfElems)
+    {
+        return -1;
+    }
+
+    Record* record = malloc(sizeof(*record));
+    if (record == NULL)
+    {
+        return -1;
+    }
+
+    record->key.ptr = key;
+    record->value.ptr = value;
+    record->hash = hash;
+    record->timer = NULL;
+    record->flags = flags;
+
+    link_record(hashTable, index, record);
+    return 0;
+}
+
+/*
+    static const Record* iterator_skip(const HashTable* hashTable, size_t* index, const Record* record)
+        Returns the first not expired record from the given one on, continuing through the following
+        buckets. Index is moved to the bucket of the returned record, past the last bucket at the end.
+        Should not be used by user.
+*/
+static const Record* iterator_skip(const HashTable* hashTable, size_t* index, const Record* record)
+{
+    for (;;)
+    {
+        for (; record != NULL; record = record->next)
+        {
+            if (!record_expired(hashTable, record))
+            {
+                return record;
+            }
+        }
+
+        if (++(*index) >= hashTable->size)
+        {
+            return NULL;
+        }
+        record = hashTable->records[*index];
+    }
+}
+
+/*
+    static int record_expired(const HashTable* hashTable, const Record* record)
+        Returns 1 if the record has TTL which has already passed, 0 otherwise.
+        Should not be used by user.
+*/
+static int record_expired(const HashTable* hashTable, const Record* record)
+{
+    return record->timer != NULL && record->timer->expiresAt <= hashTable->wheel->now;
+}
+
+/*
+    static HashTableWheel* wheel_get(HashTable* hashTable)
+        Returns the timing wheel of the table, allocates it on first use.
+        Should not be used by user.
+*/
+static HashTableWheel* wheel_get(HashTable* hashTable)
+{
+    if (hashTable->wheel == NULL)
+    {
+        hashTable->wheel = calloc(1, sizeof(*hashTable->wheel));
+    }
+
+    return hashTable->wheel;
+}
+
+/*
+    static void wheel_add(HashTableWheel* wheel, HashTableTimer* timer)
+        Links the timer into the level of the highest bit group in which its expiry time differs from now,
+        to the slot of its expiry time digit of that level. The slot is reached exactly when all higher
+        digits of now are equal to the expiry time, then the timer is moved one level lower (cascade).
+        Already expired timers go to the due list, timers beyond the top level to the far list.
+        Should not be used by user.
+*/
+static void wheel_add(HashTableWheel* wheel, HashTableTimer* timer)
+{
+    const uint64_t diff = timer->expiresAt ^ wheel->now;
+    HashTableTimer** head = NULL;
+    unsigned int level = 0;
+
+    if (timer->expiresAt <= wheel->now)
+    {
+        level = HASHTABLE_WHEEL_DUE;
+        head = &wheel->due;
+    }
+    else
+    {
+        while (level < HASHTABLE_WHEEL_LEVELS && (diff >> (HASHTABLE_WHEEL_BITS * (level + 1))) != 0)
+        {
+            level++;
+        }
+
+        head = level == HASHTABLE_WHEEL_FAR
+                   ? &wheel->far
+                   : &wheel->slots[level][(timer->expiresAt >> (HASHTABLE_WHEEL_BITS * level)) & (HASHTABLE_WHEEL_SLOTS - 1)];
+    }
+
+    timer->level = level;
+    timer->next = *head;
+    timer->pprev = head;
+    if (timer->next != NULL)
+    {
+        timer->next->pprev = &timer->next;
+    }
+    *head = timer;
+    wheel->pending[level]++;
+}
+
+static void wheel_unlink(HashTableWheel* wheel, HashTableTimer* timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next != NULL)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+    wheel->pending[timer->level]--;
+}
+
+/*
+    static void wheel_readd(HashTableWheel* wheel, HashTableTimer** head)
+        Empties given slot and adds all its timers again relatively to the current time.
+        Should not be used by user.
+*/
+static void wheel_readd(HashTableWheel* wheel, HashTableTimer** head)
+{
+    HashTableTimer* timer = *head;
+    *head = NULL;
+
+    while (timer != NULL)
+    {
+        HashTableTimer* next = timer->next;
+        wheel->pending[timer->level]--;
+        wheel_add(wheel, timer);
+        timer = next;
+    }
+}
+
+/*
+    static uint64_t wheel_far_window(const HashTableWheel* wheel)
+        Returns start of the top level range holding the earliest far timer, the first time at which
+        re-adding the far list moves any timer into the wheel. The far list must not be empty.
+        Should not be used by user.
+*/
+static uint64_t wheel_far_window(const HashTableWheel* wheel)
+{
+    uint64_t earliest = UINT64_MAX;
+    for (const HashTableTimer* timer = wheel->far; timer != NULL; timer = timer->next)
+    {
+        if (timer->expiresAt < earliest)
+        {
+            earliest = timer->expiresAt;
+        }
+    }
+
+    const unsigned int shift = HASHTABLE_WHEEL_BITS * HASHTABLE_WHEEL_LEVELS;
+    return (earliest >> shift) << shift;
+}
+
+/*
+    static void wheel_advance(HashTableWheel* wheel, uint64_t now)
+        Moves the time forward, cascading slots whose time has come and moving expired timers to the due list.
+        Time jumps directly to the next boundary of the lowest non-empty level, so the cost depends on
+        the number of timers, not on the length of the time step. With only far timers left it jumps to
+        the range of the earliest one, so the far list is re-added once per range holding a far timer.
+        Should not be used by user.
+*/
+static void wheel_advance(HashTableWheel* wheel, uint64_t now)
+{
+    while (wheel->now < now)
+    {
+        unsigned int level = 0;
+        while (level <= HASHTABLE_WHEEL_FAR && wheel->pending[level] == 0)
+        {
+            level++;
+        }
+
+        // No slot below this level has a timer, nothing can happen before its next boundary
+        const unsigned int shift = HASHTABLE_WHEEL_BITS * level;
+        uint64_t boundary = now;
+        if (level == HASHTABLE_WHEEL_FAR)
+        {
+            boundary = wheel_far_window(wheel);
+        }
+        else if (level < HASHTABLE_WHEEL_FAR)
+        {
+            boundary = ((wheel->now >> shift) + 1) << shift;
+        }
+        if (boundary == 0 || boundary >= now)
+        {
+            wheel->now = now;
+            // Boundary hit exactly still has to be processed
+            if (boundary != now)
+            {
+                break;
+            }
+        }
+        else
+        {
+            wheel->now = boundary;
+        }
+
+        // Far timers and higher levels first, so their timers land in lower levels processed right after
+        if ((wheel->now & ((UINT64_C(1) << (HASHTABLE_WHEEL_BITS * HASHTABLE_WHEEL_LEVELS)) - 1)) == 0)
+        {
+            wheel_readd(wheel, &wheel->far);
+        }
+
+        for (unsigned int l = HASHTABLE_WHEEL_LEVELS; l-- > 0;)
+        {
+            const unsigned int bits = HASHTABLE_WHEEL_BITS * l;
+            if ((wheel->now & ((UINT64_C(1) << bits) - 1)) == 0)
+            {
+                wheel_readd(wheel, &wheel->slots[l][(wheel->now >> bits) & (HASHTABLE_WHEEL_SLOTS - 1)]);
+            }
+        }
+    }
+}
+
+/*
+    static void timer_cancel(HashTable* hashTable, Record* record)
+        Removes the TTL of the record, if it has one.
+        Should not be used by user.
+*/
+static void timer_cancel(HashTable* hashTable, Record* record)
+{
+    if (record->timer == NULL)
+    {
+        return;
+    }
+
+    wheel_unlink(hashTable->wheel, record->timer);
+    free(record->timer);
+    record->timer = NULL;
+}
+
+/*
+    static void run_jobs(void* jobs, size_t jobSize, size_t threads, void* (*work)(void*))
+        Does work for each of threads jobs (array of jobSize bytes elements). Job 0 is done by the calling thread,
+        others by started threads, or inline if the thread can't be started. Returns when all jobs are done.
+        Should not be used by user.
+*/
+static void run_jobs(void* jobs, size_t jobSize, size_t threads, void* (*work)(void*))
+{
+    char* job = jobs;
+    pthread_t* workers = threads > 1 ? malloc(threads * sizeof(*workers)) : NULL;
+    int* started = threads > 1 ? calloc(threads, sizeof(*started)) : NULL;
+
+    for (size_t t = 1; workers != NULL && started != NULL && t < threads; ++t)
+    {
+        started[t] = pthread_create(&workers[t], NULL, work, job + t * jobSize) == 0;
+    }
+
+    work(job);
+    for (size_t t = 1; t < threads; ++t)
+    {
+        if (started != NULL && started[t])
+        {
+            pthread_join(workers[t], NULL);
+        }
+        else
+        {
+            work(job + t * jobSize);
+        }
+    }
+
+    free(started);
+    free(workers);
+}
+
+/*
+    static void* bulk_load_job(void* arg)
+        Copies strings and places records of the entries grouped into the bucket range of given job.
+        Ranges of different jobs don't overlap, so jobs can run in parallel without locking.
+        Entries of one bucket are placed in input order, a repeated key replaces the record of its earlier entry
+        in the chain (the replaced one stays unused in the block).
+        Should not be used by user.
+*/
+static void* bulk_load_job(void* arg)
+{
+    BulkLoadJob* job = arg;
+    HashTable* hashTable = job->hashTable;
+
+    for (size_t position = job->first; position < job->end; ++position)
+    {
+        const size_t i = job->order[position];
+        const size_t index = job->indexes[i];
+        Record* record = &job->records[i];
+        strcpy(record_key_buffer(record), job->keys[i]);
+        strcpy(record_value_buffer(record), job->values[i]);
+        record->hash = key_hash(job->keys[i]);
+        record->timer = NULL;
+
+        Record** link = &hashTable->records[index];
+        while (*link != NULL && !key_equals(*link, job->keys[i], record->hash))
+        {
+            link = &(*link)->next;
+        }
+
+        if (*link != NULL)
+        {
+            record->next = (*link)->next;
+            *link = record;
+            continue;
+        }
+
+        handle_collision(hashTable, index, record);
+        job->placed++;
+    }
+
+    return NULL;
+}
+
+/*
+    static void* clear_job(void* arg)
+        Releases records, their timers and sorted indexes of the bucket range of given job.
+        Should not be used by user.
+*/
+static void* clear_job(void* arg)
+{
+    ClearJob* job = arg;
+    HashTable* hashTable = job->hashTable;
+
+    for (size_t i = job->firstBucket; i < job->endBucket; ++i)
+    {
+        Record* current = hashTable->records[i];
+        while (current != NULL)
+        {
+            Record* next = current->next;
+            free(current->timer);
+            record_delete(current);
+            current = next;
+        }
+        hashTable->records[i] = NULL;
+
+        if (hashTable->sortedBuckets != NULL)
+        {
+            free(hashTable->sortedBuckets[i]);
+            hashTable->sortedBuckets[i] = NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    static void release_records(HashTable* hashTable, size_t threads)
+        Releases all records of the table by clear jobs of threads bucket ranges, buckets are left empty.
+        Should not be used by user.
+*/
+static void release_records(HashTable* hashTable, size_t threads)
+{
+    if (hashTable->records == NULL)
+    {
+        return;
+    }
+
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+    else if (threads > hashTable->size)
+    {
+        threads = hashTable->size;
+    }
+
+    ClearJob* jobs = threads > 1 ? malloc(threads * sizeof(*jobs)) : NULL;
+    ClearJob single;
+    if (jobs == NULL)
+    {
+        jobs = &single;
+        threads = 1;
+    }
+
+    for (size_t t = 0; t < threads; ++t)
+    {
+        ClearJob job = {hashTable, hashTable->size * t / threads, hashTable->size * (t + 1) / threads};
+        jobs[t] = job;
+    }
+
+    run_jobs(jobs, sizeof(*jobs), threads, clear_job);
+
+    if (jobs != &single)
+    {
+        free(jobs);
+    }
+}
+
+/*
+    static void* merge_job(void* arg)
+        Merges records of all sources hashed into the bucket range of given job. Bucket of a source
+        of the destination size is the bucket of the destination too, so only the range is visited in such source.
+        Ranges of different jobs don't overlap, so jobs can run in parallel without locking.
+        Should not be used by user.
+*/
+static void* merge_job(void* arg)
+{
+    MergeJob* job = arg;
+    char buffer[HASHTABLE_COMBINE_BUFFER];
+
+    for (size_t s = 0; s < job->count; ++s)
+    {
+        const HashTable* source = job->sources[s];
+        const int aligned = source->size == job->destination->size;
+        const size_t first = aligned ? job->firstBucket : 0;
+        const size_t end = aligned ? job->endBucket : source->size;
+
+        for (size_t i = first; i < end; ++i)
+        {
+            for (const Record* record = source->records[i]; record != NULL; record = record->next)
+            {
+                if (record_expired(source, record))
+                {
+                    continue;
+                }
+
+                const size_t index = aligned ? i : bucket_index(record->hash, job->destination->size);
+                if (index >= job->firstBucket && index < job->endBucket)
+                {
+                    merge_record(job, index, record, buffer);
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    static void merge_record(MergeJob* job, size_t index, const Record* record, char* buffer)
+        Combines the source record with the present one, or links its copy under given index.
+        Single job uses the same path as hashTable_insert. Parallel jobs reserve the entry in the shared
+        slots (if they are counted) and leave the update of noOfElems to hashTable_merge.
+        Should not be used by user.
+*/
+static void merge_record(MergeJob* job, size_t index, const Record* record, char* buffer)
+{
+    HashTable* destination = job->destination;
+
+    // In cache mode old records are evicted instead of refusing the insert
+    if (destination->cache != NULL && cache_make_room(destination, record_key(record), record_value(record)) != 0)
+    {
+        job->dropped++;
+        return;
+    }
+
+    Record* present = find_record(destination, record_key(record), record->hash, index);
+    if (present != NULL)
+    {
+        const char* value = record_value(record);
+        if (job->combine != NULL && !record_expired(destination, present))
+        {
+            value = job->combine(record_key(record), record_value(present), record_value(record), buffer, HASHTABLE_COMBINE_BUFFER, job->context);
+        }
+
+        if (value != NULL && value != record_value(present))
+        {
+            timer_cancel(destination, present);
+            record_set_value(destination, present, value);
+        }
+        return;
+    }
+
+    if (!job->parallel ? destination->size == destination->noOfElems : job->slots != NULL && !merge_reserve(job->slots))
+    {
+        job->dropped++;
+        return;
+    }
+
+    Record* copy = record_new(record_key(record), record_value(record));
+    if (copy == NULL)
+    {
+        if (job->slots != NULL)
+        {
+            __atomic_fetch_add(job->slots, 1, __ATOMIC_RELAXED);
+        }
+        job->dropped++;
+        return;
+    }
+
+    if (!job->parallel)
+    {
+        link_record(destination, index, copy);
+        return;
+    }
+
+    if (destination->sortedBuckets[index] != NULL)
+    {
+        sorted_add(destination, index, copy);
+    }
+    else
+    {
+        handle_collision(destination, index, copy);
+        if (chain_longer(destination->records[index], HASHTABLE_TREEIFY_THRESHOLD))
+        {
+            bucket_treeify(destination, index);
+        }
+    }
+    job->placed++;
+}
+
+// Takes one of the free entries shared by parallel merge jobs, returns 0 if there is none left
+static int merge_reserve(size_t* slots)
+{
+    size_t left = __atomic_load_n(slots, __ATOMIC_RELAXED);
+
+    while (left > 0)
+    {
+        if (__atomic_compare_exchange_n(slots, &left, left - 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+    static size_t hash_function(const char* key, size_t hashTableSize)
+        The algorithm of generating index based on given key, the bucket_index of its key_hash.
+        Should not be used by user.
+*/
+static size_t hash_function(const char* key, size_t hashTableSize)
+{
+    if (key == NULL)
+    {
+        return (size_t)-1; // todo think about it could be better
+    }
+
+    return bucket_index(key_hash(key), hashTableSize);
+}
+
+/*
+    static size_t bucket_index(uint64_t hash, size_t hashTableSize)
+        Bucket of the key with given full hash (Record::hash), every operation places and finds
+        records by it. All bits of key_hash are mixed, so similar keys (e.g. anagrams) are spread
+        over the whole table.
+        Should not be used by user.
+*/
+static size_t bucket_index(uint64_t hash, size_t hashTableSize)
+{
+    return (size_t)(hash % hashTableSize);
+}
+
+/*
+    static uint64_t key_hash(const char* key)
+        Full hash of the key stored in every record, the shared hashTableTyped_hash_str.
+        It picks the bucket (bucket_index), skips key compares and feeds the Bloom filter.
+        Should not be used by user.
+*/
+static uint64_t key_hash(const char* key)
+{
+    return hashTableTyped_hash_str(key);
+}
+
+/*
+    static HashTableBloom* bloom_new(size_t capacity, size_t bitsPerKey, int mode)
+        Allocates zeroed filter of at least capacity * bitsPerKey positions, rounded up to a power of two
+        number of cache line aligned blocks. Block holds 512 bits or 128 4-bit counters.
+        Should not be used by user.
+*/
+static HashTableBloom* bloom_new(size_t capacity, size_t bitsPerKey, int mode)
+{
+    HashTableBloom* bloom = malloc(sizeof(*bloom));
+    if (bloom == NULL)
+    {
+        return NULL;
+    }
+
+    const size_t positionsPerBlock = mode == HASHTABLE_BLOOM_COUNTING ? BLOOM_BLOCK_BYTES * 2 : BLOOM_BLOCK_BYTES * 8;
+    const size_t needed = (capacity * bitsPerKey + positionsPerBlock - 1) / positionsPerBlock;
+
+    bloom->blocks = 1;
+    while (bloom->blocks < needed)
+    {
+        bloom->blocks <<= 1;
+    }
+    bloom->bitsPerKey = bitsPerKey;
+    bloom->mode = mode;
+
+    // One spare block to align the words to a cache line
+    bloom->memory = calloc(bloom->blocks + 1, BLOOM_BLOCK_BYTES);
+    if (bloom->memory == NULL)
+    {
+        free(bloom);
+        return NULL;
+    }
+
+    const uintptr_t address = (uintptr_t)bloom->memory;
+    bloom->words = (uint64_t*)(void*)((unsigned char*)bloom->memory +
+                                      (BLOOM_BLOCK_BYTES - address % BLOOM_BLOCK_BYTES) % BLOOM_BLOCK_BYTES);
+
+    return bloom;
+}
+
+static void bloom_delete(HashTableBloom* bloom)
+{
+    if (bloom == NULL)
+    {
+        return;
+    }
+
+    free(bloom->memory);
+    free(bloom);
+}
+
+/*
+    static void bloom_add(HashTableBloom* bloom, uint64_t hash)
+        Sets the positions of given hash. Counters saturate at 15 and are never decremented afterwards.
+        Should not be used by user.
+*/
+static void bloom_add(HashTableBloom* bloom, uint64_t hash)
+{
+    uint64_t* block = BLOOM_BLOCK(bloom, hash);
+    uint64_t bits = BLOOM_REMIX(hash);
+
+    for (size_t i = 0; i < HASHTABLE_BLOOM_PROBES; ++i)
+    {
+        if (bloom->mode == HASHTABLE_BLOOM_COUNTING)
+        {
+            const unsigned int position = (unsigned int)(bits >> 57);
+            const unsigned int shift = (position & 15u) * 4u;
+            if (((block[position >> 4] >> shift) & 0xFu) != 0xFu)
+            {
+                block[position >> 4] += (uint64_t)1 << shift;
+            }
+            bits <<= 7;
+        }
+        else
+        {
+            const unsigned int position = (unsigned int)(bits >> 55);
+            block[position >> 6] |= (uint64_t)1 << (position & 63u);
+            bits <<= 9;
+        }
+    }
+}
+
+/*
+    static void bloom_remove(HashTableBloom* bloom, uint64_t hash)
+        Decrements the counters of given hash, saturated counters are kept. Does nothing for plain filter.
+        Should not be used by user.
+*/
+static void bloom_remove(HashTableBloom* bloom, uint64_t hash)
+{
+    if (bloom->mode != HASHTABLE_BLOOM_COUNTING)
+    {
+        return;
+    }
+
+    uint64_t* block = BLOOM_BLOCK(bloom, hash);
+    uint64_t bits = BLOOM_REMIX(hash);
+
+    for (size_t i = 0; i < HASHTABLE_BLOOM_PROBES; ++i)
+    {
+        const unsigned int position = (unsigned int)(bits >> 57);
+        const unsigned int shift = (position & 15u) * 4u;
+        const uint64_t counter = (block[position >> 4] >> shift) & 0xFu;
+        if (counter != 0 && counter != 0xFu)
+        {
+            block[position >> 4] -= (uint64_t)1 << shift;
+        }
+        bits <<= 7;
+    }
+}
+
+/*
+    static int bloom_may_contain(const HashTableBloom* bloom, uint64_t hash)
+        Returns 0 if the key of given hash is certainly not in the table, 1 if it may be.
+        Should not be used by user.
+*/
+static int bloom_may_contain(const HashTableBloom* bloom, uint64_t hash)
+{
+    const uint64_t* block = BLOOM_BLOCK(bloom, hash);
+    uint64_t bits = BLOOM_REMIX(hash);
+
+    for (size_t i = 0; i < HASHTABLE_BLOOM_PROBES; ++i)
+    {
+        if (bloom->mode == HASHTABLE_BLOOM_COUNTING)
+        {
+            const unsigned int position = (unsigned int)(bits >> 57);
+            if (((block[position >> 4] >> ((position & 15u) * 4u)) & 0xFu) == 0)
+            {
+                return 0;
+            }
+            bits <<= 7;
+        }
+        else
+        {
+            const unsigned int position = (unsigned int)(bits >> 55);
+            if (!(block[position >> 6] & ((uint64_t)1 << (position & 63u))))
+            {
+                return 0;
+            }
+            bits <<= 9;
+        }
+    }
+
+    return 1;
+}
+
+/*
+    static void handle_collision(HashTable* hashTable, size_t index, Record* record)
+        Links the record into the chain under given index through its next pointer, nothing is allocated.
+        First record of the chain stays in the records array and newer ones follow it (newest first),
+        so the head of a bucket doesn't change while the bucket only grows.
+        Should not be used by user.
+*/
+static void handle_collision(HashTable* hashTable, size_t index, Record* record)
+{
+    if (hashTable == NULL || record == NULL)
+    {
+        return;
+    }
+
+    Record* head = hashTable->records[index];
+
+    // if chain does not exist yet
+    if (head == NULL)
+    {
+        record->next = NULL;
+        hashTable->records[index] = record;
+        return;
+    }
+
+    record->next = head->next;
+    head->next = record;
+}
+
+/*
+    static void link_record(HashTable* hashTable, size_t index, Record* record)
+        Places new record under given index and accounts it in the filter and cache.
+        Indexed chain gets the record at its sorted position, chain growing over
+        HASHTABLE_TREEIFY_THRESHOLD is indexed.
+        Should not be used by user.
+*/
+static void link_record(HashTable* hashTable, size_t index, Record* record)
+{
+    if (hashTable->sortedBuckets != NULL && hashTable->sortedBuckets[index] != NULL)
+    {
+        sorted_add(hashTable, index, record);
+    }
+    else
+    {
+        handle_collision(hashTable, index, record);
+        if (chain_longer(hashTable->records[index], HASHTABLE_TREEIFY_THRESHOLD))
+        {
+            bucket_treeify(hashTable, index);
+        }
+    }
+
+    hashTable->noOfElems++;
+    if (hashTable->bloom != NULL)
+    {
+        bloom_add(hashTable->bloom, record->hash);
+    }
+    if (hashTable->cache != NULL)
+    {
+        hashTable->cache->bytes += record_bytes(record_key(record), record_value(record));
+    }
+}
+
+
+/*
+    static int record_compare(const Record* record, uint64_t hash, const char* key)
+        Order of sorted buckets: by the full hash, records with equal hashes by the key.
+        Returns negative, zero or positive value as strcmp does.
+        Should not be used by user.
+*/
+static int record_compare(const Record* record, uint64_t hash, const char* key)
+{
+    if (record->hash != hash)
+    {
+        return record->hash < hash ? -1 : 1;
+    }
+
+    return strcmp(lookup_key(record), key);
+}
+
+// qsort comparator of Record pointers, same order as record_compare
+static int record_order(const void* a, const void* b)
+{
+    const Record* second = *(const Record* const*)b;
+    return record_compare(*(const Record* const*)a, second->hash, record_key(second));
+}
+
+// Checks whether the chain has more than limit records, without walking the rest of it
+static int chain_longer(const Record* head, size_t limit)
+{
+    size_t length = 0;
+
+    for (const Record* record = head; record != NULL; record = record->next)
+    {
+        if (++length > limit)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+    static int sorted_find(const HashTableSortedBucket* sorted, uint64_t hash, const char* key, size_t* position, size_t* compares)
+        Bisects the sorted index for the key. Sets position to the slot of the key, or to the slot
+        it would be inserted to, and compares to the number of records compared.
+        Returns 1 if the key is present, 0 otherwise.
+        Should not be used by user.
+*/
+static int sorted_find(const HashTableSortedBucket* sorted, uint64_t hash, const char* key, size_t* position, size_t* compares)
+{
+    size_t low = 0;
+    size_t high = sorted->count;
+
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        const int order = record_compare(sorted->records[middle], hash, key);
+        (*compares)++;
+
+        if (order == 0)
+        {
+            *position = middle;
+            return 1;
+        }
+
+        if (order < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    *position = low;
+    return 0;
+}
+
+/*
+    static void sorted_add(HashTable* hashTable, size_t index, Record* record)
+        Inserts new record into the sorted index of the bucket and links it into the chain
+        behind its predecessor in the index. If the index can't grow, it is dropped and the record
+        is linked as to a plain chain. The position is found by bisection, but the later entries
+        are shifted by memmove, so the insert is O(n) pointer moves (only lookups are O(log n)).
+        Should not be used by user.
+*/
+static void sorted_add(HashTable* hashTable, size_t index, Record* record)
+{
+    HashTableSortedBucket* sorted = hashTable->sortedBuckets[index];
+
+    if (sorted->count == sorted->capacity)
+    {
+        const size_t capacity = 2 * sorted->capacity;
+        HashTableSortedBucket* grown = realloc(sorted, sizeof(*sorted) + capacity * sizeof(*sorted->records));
+        if (grown == NULL)
+        {
+            bucket_untreeify(hashTable, index);
+            handle_collision(hashTable, index, record);
+            return;
+        }
+
+        grown->capacity = capacity;
+        sorted = grown;
+        hashTable->sortedBuckets[index] = sorted;
+    }
+
+    size_t position = 0;
+    size_t compares = 0;
+    sorted_find(sorted, record->hash, record_key(record), &position, &compares);
+
+    memmove(&sorted->records[position + 1], &sorted->records[position],
+            (sorted->count - position) * sizeof(*sorted->records));
+    sorted->records[position] = record;
+    sorted->count++;
+
+    Record** link = position == 0 ? &hashTable->records[index] : &sorted->records[position - 1]->next;
+    record->next = *link;
+    *link = record;
+}
+
+/*
+    static void sorted_remove(HashTable* hashTable, size_t index, const Record* record)
+        Removes already unlinked record from the sorted index of the bucket, shifting the later
+        entries (O(n) pointer moves), index of a chain shrunk to HASHTABLE_UNTREEIFY_THRESHOLD is dropped.
+        Should not be used by user.
+*/
+static void sorted_remove(HashTable* hashTable, size_t index, const Record* record)
+{
+    HashTableSortedBucket* sorted = hashTable->sortedBuckets[index];
+    size_t position = 0;
+    size_t compares = 0;
+
+    if (sorted_find(sorted, record->hash, record_key(record), &position, &compares))
+    {
+        sorted->count--;
+        memmove(&sorted->records[position], &sorted->records[position + 1],
+                (sorted->count - position) * sizeof(*sorted->records));
+    }
+
+    if (sorted->count <= HASHTABLE_UNTREEIFY_THRESHOLD)
+    {
+        bucket_untreeify(hashTable, index);
+    }
+}
+
+/*
+    static void bucket_treeify(HashTable* hashTable, size_t index)
+        Builds the sorted index of the chain under given index and relinks the chain in its order.
+        If allocation fails, the bucket stays a plain chain.
+        Should not be used by user.
+*/
+static void bucket_treeify(HashTable* hashTable, size_t index)
+{
+    if (hashTable->sortedBuckets == NULL)
+    {
+        hashTable->sortedBuckets = calloc(hashTable->size, sizeof(*hashTable->sortedBuckets));
+        if (hashTable->sortedBuckets == NULL)
+        {
+            return;
+        }
+    }
+
+    size_t count = 0;
+    for (const Record* record = hashTable->records[index]; record != NULL; record = record->next)
+    {
+        count++;
+    }
+
+    HashTableSortedBucket* sorted = malloc(sizeof(*sorted) + 2 * count * sizeof(*sorted->records));
+    if (sorted == NULL)
+    {
+        return;
+    }
+
+    sorted->count = count;
+    sorted->capacity = 2 * count;
+
+    size_t i = 0;
+    for (Record* record = hashTable->records[index]; record != NULL; record = record->next)
+    {
+        sorted->records[i++] = record;
+    }
+
+    qsort(sorted->records, count, sizeof(*sorted->records), record_order);
+
+    hashTable->records[index] = sorted->records[0];
+    for (i = 0; i + 1 < count; ++i)
+    {
+        sorted->records[i]->next = sorted->records[i + 1];
+    }
+    sorted->records[count - 1]->next = NULL;
+
+    hashTable->sortedBuckets[index] = sorted;
+}
+
+// Drops the sorted index of the bucket, the chain is already complete without it
+static void bucket_untreeify(HashTable* hashTable, size_t index)
+{
+    free(hashTable->sortedBuckets[index]);
+    hashTable->sortedBuckets[index] = NULL;
+}
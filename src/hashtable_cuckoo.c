@@ -0,0 +1,467 @@
+#include <hashtable_module/hashtable_cuckoo.h>
+#include <hashtable_module/hashtable_typed.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CUCKOO_BUCKET_BYTES 64
+
+static size_t cuckoo_first(uint64_t hash, size_t noOfBuckets);
+static size_t cuckoo_second(uint64_t hash, size_t noOfBuckets);
+static int cuckoo_alloc(HashTableCuckoo* hashTable, size_t noOfBuckets);
+static Record** cuckoo_find(const HashTableCuckoo* hashTable, const char* key, uint64_t hash);
+static int cuckoo_put_free(HashTableCuckoo* hashTable, Record* record, uint64_t hash);
+static int cuckoo_place(HashTableCuckoo* hashTable, Record* record, uint64_t hash);
+static int cuckoo_insert_record(HashTableCuckoo* hashTable, Record* record, uint64_t hash);
+static int cuckoo_grow(HashTableCuckoo* hashTable);
+static void cuckoo_unstash(HashTableCuckoo* hashTable, size_t bucket);
+
+/*
+    Function: HashTableCuckoo* hashTableCuckoo_new(size_t size)
+        Allocates cuckoo table with enough buckets for size records under HASHTABLE_CUCKOO_LOAD_PERCENT.
+        Unlike HashTable it is not limited by the size, it grows when needed.
+        Returns NULL if allocation fails.
+*/
+HashTableCuckoo* hashTableCuckoo_new(size_t size)
+{
+    HashTableCuckoo* hashTable = calloc(1, sizeof(*hashTable));
+    if (hashTable == NULL)
+    {
+        return NULL;
+    }
+
+    const size_t needed = size * 100 / (HASHTABLE_CUCKOO_SLOTS * HASHTABLE_CUCKOO_LOAD_PERCENT) + 1;
+    size_t noOfBuckets = 2;
+    while (noOfBuckets < needed)
+    {
+        noOfBuckets <<= 1;
+    }
+
+    if (cuckoo_alloc(hashTable, noOfBuckets) != 0)
+    {
+        free(hashTable);
+        return NULL;
+    }
+
+    hashTable->seed = 0x9E3779B97F4A7C15u;
+    return hashTable;
+}
+
+/*
+    Function: void hashTableCuckoo_delete(HashTableCuckoo* hashTable)
+        Releases all records, buckets and the table itself.
+*/
+void hashTableCuckoo_delete(HashTableCuckoo* hashTable)
+{
+    if (hashTable == NULL)
+    {
+        return;
+    }
+
+    for (size_t b = 0; b < hashTable->noOfBuckets; ++b)
+    {
+        for (size_t s = 0; s < HASHTABLE_CUCKOO_SLOTS; ++s)
+        {
+            record_delete(hashTable->buckets[b].records[s]);
+        }
+    }
+
+    for (size_t i = 0; i < hashTable->stashCount; ++i)
+    {
+        record_delete(hashTable->stash[i]);
+    }
+
+    free(hashTable->memory);
+    free(hashTable);
+}
+
+/*
+    Function: void hashTableCuckoo_print(const HashTableCuckoo* hashTable)
+        Prints all records bucket by bucket, records of the stash at the end.
+*/
+void hashTableCuckoo_print(const HashTableCuckoo* hashTable)
+{
+    if (hashTable == NULL)
+    {
+        return;
+    }
+
+    for (size_t b = 0; b < hashTable->noOfBuckets; ++b)
+    {
+        for (size_t s = 0; s < HASHTABLE_CUCKOO_SLOTS; ++s)
+        {
+            const Record* record = hashTable->buckets[b].records[s];
+            if (record != NULL)
+            {
+                printf("Bucket=%zu\tKey: %s, Value: %s\n", b, record_key(record), record_value(record));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < hashTable->stashCount; ++i)
+    {
+        printf("Stash\tKey: %s, Value: %s\n", record_key(hashTable->stash[i]), record_value(hashTable->stash[i]));
+    }
+}
+
+/*
+    Function: int hashTableCuckoo_insert(HashTableCuckoo* hashTable, const char* key, const char* value)
+        Inserts copy of the key and value, value of present key is replaced.
+        New record takes a free slot of one of its two buckets, otherwise records are displaced
+        to their other buckets (at most HASHTABLE_CUCKOO_MAX_KICKS times) and the last displaced one
+        goes to the stash. The table grows before the stash would overflow or the load limit is passed.
+        Returns 0 on success, -1 if allocation fails or the record finds no place after HASHTABLE_CUCKOO_MAX_GROWS
+        doublings (then the records of the table are unchanged).
+*/
+int hashTableCuckoo_insert(HashTableCuckoo* hashTable, const char* key, const char* value)
+{
+    if (hashTable == NULL || key == NULL || value == NULL)
+    {
+        return -1;
+    }
+
+    const uint64_t hash = hashTableTyped_hash_str(key);
+    Record** present = cuckoo_find(hashTable, key, hash);
+
+    Record* record = record_new(key, value);
+    if (record == NULL)
+    {
+        return -1;
+    }
+
+    if (present != NULL)
+    {
+        record_delete(*present);
+        *present = record;
+        return 0;
+    }
+
+    if (cuckoo_insert_record(hashTable, record, hash) != 0)
+    {
+        record_delete(record);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+    Function: void hashTableCuckoo_delete_record(HashTableCuckoo* hashTable, const char* key)
+        Deletes the record of given key. Freed bucket slot is offered to the records of the stash.
+*/
+void hashTableCuckoo_delete_record(HashTableCuckoo* hashTable, const char* key)
+{
+    if (hashTable == NULL || key == NULL)
+    {
+        return;
+    }
+
+    const uint64_t hash = hashTableTyped_hash_str(key);
+    Record** slot = cuckoo_find(hashTable, key, hash);
+    if (slot == NULL)
+    {
+        return;
+    }
+
+    record_delete(*slot);
+    *slot = NULL;
+    hashTable->noOfElems--;
+
+    // Slot of the stash is filled by its last record
+    if (slot >= hashTable->stash && slot < hashTable->stash + HASHTABLE_CUCKOO_STASH)
+    {
+        const size_t i = (size_t)(slot - hashTable->stash);
+        hashTable->stashCount--;
+        hashTable->stash[i] = hashTable->stash[hashTable->stashCount];
+        hashTable->stashHashes[i] = hashTable->stashHashes[hashTable->stashCount];
+        hashTable->stash[hashTable->stashCount] = NULL;
+        return;
+    }
+
+    const size_t first = cuckoo_first(hash, hashTable->noOfBuckets);
+    const HashTableCuckooBucket* bucket = &hashTable->buckets[first];
+    const int inFirst = slot >= bucket->records && slot < bucket->records + HASHTABLE_CUCKOO_SLOTS;
+    cuckoo_unstash(hashTable, inFirst ? first : cuckoo_second(hash, hashTable->noOfBuckets));
+}
+
+/*
+    Function: const char* hashTableCuckoo_search(const HashTableCuckoo* hashTable, const char* key)
+        Reads the two buckets of the key, the stash only if it is not empty.
+        Returns the value or NULL if key is not present.
+*/
+const char* hashTableCuckoo_search(const HashTableCuckoo* hashTable, const char* key)
+{
+    if (hashTable == NULL || key == NULL)
+    {
+        return NULL;
+    }
+
+    Record** slot = cuckoo_find(hashTable, key, hashTableTyped_hash_str(key));
+    return slot != NULL ? record_value(*slot) : NULL;
+}
+
+/*
+    static Record** cuckoo_find(const HashTableCuckoo* hashTable, const char* key, uint64_t hash)
+        Returns the slot (in a bucket or the stash) holding the key, NULL if key is not present.
+        Keys are compared only for slots with the same full hash.
+        Should not be used by user.
+*/
+static Record** cuckoo_find(const HashTableCuckoo* hashTable, const char* key, uint64_t hash)
+{
+    HashTableCuckooBucket* buckets[2] = {&hashTable->buckets[cuckoo_first(hash, hashTable->noOfBuckets)],
+                                         &hashTable->buckets[cuckoo_second(hash, hashTable->noOfBuckets)]};
+
+    for (size_t b = 0; b < 2; ++b)
+    {
+        for (size_t s = 0; s < HASHTABLE_CUCKOO_SLOTS; ++s)
+        {
+            Record* record = buckets[b]->records[s];
+            if (record != NULL && buckets[b]->hashes[s] == hash && strcmp(record_key(record), key) == 0)
+            {
+                return &buckets[b]->records[s];
+            }
+        }
+    }
+
+    for (size_t i = 0; i < hashTable->stashCount; ++i)
+    {
+        if (hashTable->stashHashes[i] == hash && strcmp(record_key(hashTable->stash[i]), key) == 0)
+        {
+            // Stash is a part of the table, only the const qualifier of the parameter is dropped
+            return (Record**)(uintptr_t)&hashTable->stash[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    static int cuckoo_put_free(HashTableCuckoo* hashTable, Record* record, uint64_t hash)
+        Stores the record to a free slot of its first or second bucket.
+        Returns 0 on success, -1 if both buckets are full.
+        Should not be used by user.
+*/
+static int cuckoo_put_free(HashTableCuckoo* hashTable, Record* record, uint64_t hash)
+{
+    const size_t candidates[2] = {cuckoo_first(hash, hashTable->noOfBuckets), cuckoo_second(hash, hashTable->noOfBuckets)};
+
+    for (size_t b = 0; b < 2; ++b)
+    {
+        HashTableCuckooBucket* bucket = &hashTable->buckets[candidates[b]];
+        for (size_t s = 0; s < HASHTABLE_CUCKOO_SLOTS; ++s)
+        {
+            if (bucket->records[s] == NULL)
+            {
+                bucket->records[s] = record;
+                bucket->hashes[s] = hash;
+                return 0;
+            }
+        }
+    }
+
+    return -1;
+}
+
+/*
+    static int cuckoo_place(HashTableCuckoo* hashTable, Record* record, uint64_t hash)
+        Places the record, displacing records of full buckets to their other bucket (random walk).
+        Record still homeless after HASHTABLE_CUCKOO_MAX_KICKS goes to the stash.
+        Returns 0 on success, -1 if the stash is full, then the table is unchanged.
+        Should not be used by user.
+*/
+static int cuckoo_place(HashTableCuckoo* hashTable, Record* record, uint64_t hash)
+{
+    if (cuckoo_put_free(hashTable, record, hash) == 0)
+    {
+        return 0;
+    }
+
+    if (hashTable->stashCount == HASHTABLE_CUCKOO_STASH)
+    {
+        return -1;
+    }
+
+    size_t bucket = cuckoo_first(hash, hashTable->noOfBuckets);
+    for (size_t kick = 0; kick < HASHTABLE_CUCKOO_MAX_KICKS; ++kick)
+    {
+        // xorshift64, only the choice of the displaced slot has to be unpredictable
+        hashTable->seed ^= hashTable->seed << 13;
+        hashTable->seed ^= hashTable->seed >> 7;
+        hashTable->seed ^= hashTable->seed << 17;
+        const size_t s = (size_t)(hashTable->seed % HASHTABLE_CUCKOO_SLOTS);
+
+        HashTableCuckooBucket* full = &hashTable->buckets[bucket];
+        Record* displaced = full->records[s];
+        const uint64_t displacedHash = full->hashes[s];
+        full->records[s] = record;
+        full->hashes[s] = hash;
+        record = displaced;
+        hash = displacedHash;
+
+        // Displaced record goes to its other bucket
+        const size_t first = cuckoo_first(hash, hashTable->noOfBuckets);
+        bucket = bucket == first ? cuckoo_second(hash, hashTable->noOfBuckets) : first;
+
+        HashTableCuckooBucket* next = &hashTable->buckets[bucket];
+        for (size_t free = 0; free < HASHTABLE_CUCKOO_SLOTS; ++free)
+        {
+            if (next->records[free] == NULL)
+            {
+                next->records[free] = record;
+                next->hashes[free] = hash;
+                return 0;
+            }
+        }
+    }
+
+    hashTable->stash[hashTable->stashCount] = record;
+    hashTable->stashHashes[hashTable->stashCount] = hash;
+    hashTable->stashCount++;
+    return 0;
+}
+
+/*
+    static int cuckoo_insert_record(HashTableCuckoo* hashTable, Record* record, uint64_t hash)
+        Places new record of given hash, growing the table when needed. The record is not released on failure.
+        Returns 0 on success, -1 if allocation fails or the record still finds no place
+        after HASHTABLE_CUCKOO_MAX_GROWS doublings, then the records of the table are unchanged.
+        Should not be used by user.
+*/
+static int cuckoo_insert_record(HashTableCuckoo* hashTable, Record* record, uint64_t hash)
+{
+    const size_t capacity = hashTable->noOfBuckets * HASHTABLE_CUCKOO_SLOTS;
+    if ((hashTable->noOfElems + 1) * 100 > capacity * HASHTABLE_CUCKOO_LOAD_PERCENT && cuckoo_grow(hashTable) != 0)
+    {
+        return -1;
+    }
+
+    // Displacement may end in the stash, so it has to have room before any record is moved.
+    // Records placed again by the growth can fill the stash too, then the table grows once more.
+    // Keys sharing both buckets at every size are not spread by any growth, so the doublings are limited.
+    size_t grows = 0;
+    while (cuckoo_place(hashTable, record, hash) != 0)
+    {
+        if (grows++ == HASHTABLE_CUCKOO_MAX_GROWS || cuckoo_grow(hashTable) != 0)
+        {
+            return -1;
+        }
+    }
+
+    hashTable->noOfElems++;
+    return 0;
+}
+
+/*
+    static int cuckoo_grow(HashTableCuckoo* hashTable)
+        Doubles the number of buckets and places all records again (stash included),
+        doubling once more if they still overflow the stash, at most HASHTABLE_CUCKOO_MAX_GROWS times.
+        Records themselves are not copied.
+        Returns 0 on success, -1 if allocation fails or the records don't fit after the last doubling,
+        then the table is unchanged.
+        Should not be used by user.
+*/
+static int cuckoo_grow(HashTableCuckoo* hashTable)
+{
+    size_t noOfBuckets = hashTable->noOfBuckets;
+
+    for (size_t round = 0; round < HASHTABLE_CUCKOO_MAX_GROWS; ++round)
+    {
+        noOfBuckets <<= 1;
+
+        HashTableCuckoo grown = *hashTable;
+        grown.stashCount = 0;
+        if (cuckoo_alloc(&grown, noOfBuckets) != 0)
+        {
+            return -1;
+        }
+
+        int failed = 0;
+        for (size_t b = 0; !failed && b < hashTable->noOfBuckets; ++b)
+        {
+            const HashTableCuckooBucket* bucket = &hashTable->buckets[b];
+            for (size_t s = 0; !failed && s < HASHTABLE_CUCKOO_SLOTS; ++s)
+            {
+                if (bucket->records[s] != NULL)
+                {
+                    failed = cuckoo_place(&grown, bucket->records[s], bucket->hashes[s]) != 0;
+                }
+            }
+        }
+
+        for (size_t i = 0; !failed && i < hashTable->stashCount; ++i)
+        {
+            failed = cuckoo_place(&grown, hashTable->stash[i], hashTable->stashHashes[i]) != 0;
+        }
+
+        if (failed)
+        {
+            free(grown.memory);
+            continue;
+        }
+
+        free(hashTable->memory);
+        *hashTable = grown;
+        return 0;
+    }
+
+    return -1;
+}
+
+/*
+    static void cuckoo_unstash(HashTableCuckoo* hashTable, size_t bucket)
+        Moves a record of the stash, which can live in given bucket, to its just freed slot.
+        Should not be used by user.
+*/
+static void cuckoo_unstash(HashTableCuckoo* hashTable, size_t bucket)
+{
+    for (size_t i = 0; i < hashTable->stashCount; ++i)
+    {
+        const uint64_t hash = hashTable->stashHashes[i];
+        if (cuckoo_first(hash, hashTable->noOfBuckets) == bucket || cuckoo_second(hash, hashTable->noOfBuckets) == bucket)
+        {
+            cuckoo_put_free(hashTable, hashTable->stash[i], hash);
+            hashTable->stashCount--;
+            hashTable->stash[i] = hashTable->stash[hashTable->stashCount];
+            hashTable->stashHashes[i] = hashTable->stashHashes[hashTable->stashCount];
+            hashTable->stash[hashTable->stashCount] = NULL;
+            return;
+        }
+    }
+}
+
+/*
+    static int cuckoo_alloc(HashTableCuckoo* hashTable, size_t noOfBuckets)
+        Allocates zeroed buckets aligned to cache lines, the previous ones are not released.
+        Returns 0 on success, -1 if allocation fails.
+        Should not be used by user.
+*/
+static int cuckoo_alloc(HashTableCuckoo* hashTable, size_t noOfBuckets)
+{
+    // One spare bucket to align the buckets to a cache line
+    void* memory = calloc(noOfBuckets + 1, CUCKOO_BUCKET_BYTES);
+    if (memory == NULL)
+    {
+        return -1;
+    }
+
+    const uintptr_t address = (uintptr_t)memory;
+    hashTable->memory = memory;
+    hashTable->buckets = (HashTableCuckooBucket*)(void*)((unsigned char*)memory +
+                         (CUCKOO_BUCKET_BYTES - address % CUCKOO_BUCKET_BYTES) % CUCKOO_BUCKET_BYTES);
+    hashTable->noOfBuckets = noOfBuckets;
+    return 0;
+}
+
+// Low and high halves of the key hash select the two buckets
+static size_t cuckoo_first(uint64_t hash, size_t noOfBuckets)
+{
+    return (size_t)hash & (noOfBuckets - 1);
+}
+
+// Second bucket always differs from the first one
+static size_t cuckoo_second(uint64_t hash, size_t noOfBuckets)
+{
+    const size_t first = cuckoo_first(hash, noOfBuckets);
+    const size_t second = (size_t)(hash >> 32) & (noOfBuckets - 1);
+    return second != first ? second : (first + 1) & (noOfBuckets - 1);
+}
@@ -0,0 +1,308 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // write
+#endif
+
+#include <hashtable_module/hashtable_export.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Output of one export: a block flushed to fd when full, or a growing string when fd is -1
+typedef struct ExportWriter
+{
+    char* data;
+    size_t length; // bytes used in data
+    size_t capacity;
+    int fd;
+    int failed; // write or allocation failed, following output is dropped
+} ExportWriter;
+
+static int export_records(const HashTable* hashTable, int format, ExportWriter* writer);
+static void writer_put(ExportWriter* writer, const char* bytes, size_t length);
+static void writer_put_escaped(ExportWriter* writer, const char* str, int format);
+static int writer_flush(ExportWriter* writer);
+static int writer_reserve(ExportWriter* writer, size_t length);
+static int fd_write_all(int fd, const char* bytes, size_t length);
+
+/*
+    Function: int hashTable_export_fd(const HashTable* hashTable, int fd, int format, char* buffer, size_t capacity)
+        Writes all records (expired ones left out) to fd in given HASHTABLE_EXPORT_* format.
+        Lines are assembled in buffer of given capacity and written by whole blocks, if buffer is NULL
+        a block of HASHTABLE_EXPORT_BLOCK bytes is allocated for the export. Strings are copied with memcpy
+        by their lengths, nothing is formatted by printf. Descriptor is left open.
+        Returns 0 on success, -1 if arguments are incorrect, allocation or write fails.
+*/
+int hashTable_export_fd(const HashTable* hashTable, int fd, int format, char* buffer, size_t capacity)
+{
+    if (hashTable == NULL || fd < 0 || (buffer != NULL && capacity < 1))
+    {
+        return -1;
+    }
+
+    ExportWriter writer = {buffer, 0, capacity, fd, 0};
+    if (buffer == NULL)
+    {
+        writer.capacity = HASHTABLE_EXPORT_BLOCK;
+        writer.data = malloc(writer.capacity);
+        if (writer.data == NULL)
+        {
+            return -1;
+        }
+    }
+
+    int result = export_records(hashTable, format, &writer);
+    if (result == 0)
+    {
+        result = writer_flush(&writer);
+    }
+
+    if (buffer == NULL)
+    {
+        free(writer.data);
+    }
+
+    return result;
+}
+
+/*
+    Function: char* hashTable_export_string(const HashTable* hashTable, int format, size_t* length)
+        Same output as hashTable_export_fd collected in one NUL terminated string, which grows as needed.
+        Length of the output (without the NUL) is stored to length if it is not NULL.
+        Returns the string to be released by free, NULL if arguments are incorrect or allocation fails.
+*/
+char* hashTable_export_string(const HashTable* hashTable, int format, size_t* length)
+{
+    if (hashTable == NULL)
+    {
+        return NULL;
+    }
+
+    ExportWriter writer = {NULL, 0, 0, -1, 0};
+    if (export_records(hashTable, format, &writer) != 0 || writer_reserve(&writer, 1) != 0)
+    {
+        free(writer.data);
+        return NULL;
+    }
+
+    writer.data[writer.length] = '\0';
+    if (length != NULL)
+    {
+        *length = writer.length;
+    }
+
+    return writer.data;
+}
+
+/*
+    static int export_records(const HashTable* hashTable, int format, ExportWriter* writer)
+        Puts the line of every record into the writer.
+        Returns 0 on success, -1 for unknown format or failed output.
+        Should not be used by user.
+*/
+static int export_records(const HashTable* hashTable, int format, ExportWriter* writer)
+{
+    if (format != HASHTABLE_EXPORT_TEXT && format != HASHTABLE_EXPORT_TSV && format != HASHTABLE_EXPORT_JSONL)
+    {
+        return -1;
+    }
+
+    HashTableIterator iterator;
+    hashTable_iterator_init(&iterator, hashTable);
+
+    for (const Record* record = hashTable_iterator_next(&iterator); record != NULL && !writer->failed;
+         record = hashTable_iterator_next(&iterator))
+    {
+        switch (format)
+        {
+            case HASHTABLE_EXPORT_TEXT:
+                writer_put(writer, "Key: ", 5);
+                writer_put(writer, record_key(record), strlen(record_key(record)));
+                writer_put(writer, ", Value: ", 9);
+                writer_put(writer, record_value(record), strlen(record_value(record)));
+                writer_put(writer, "\n", 1);
+                break;
+            case HASHTABLE_EXPORT_TSV:
+                writer_put_escaped(writer, record_key(record), format);
+                writer_put(writer, "\t", 1);
+                writer_put_escaped(writer, record_value(record), format);
+                writer_put(writer, "\n", 1);
+                break;
+            default:
+                writer_put(writer, "{\"key\":\"", 8);
+                writer_put_escaped(writer, record_key(record), format);
+                writer_put(writer, "\",\"value\":\"", 11);
+                writer_put_escaped(writer, record_value(record), format);
+                writer_put(writer, "\"}\n", 3);
+                break;
+        }
+    }
+
+    return writer->failed ? -1 : 0;
+}
+
+/*
+    static void writer_put(ExportWriter* writer, const char* bytes, size_t length)
+        Appends bytes to the block, which is flushed (or grown) first if they don't fit.
+        Bytes longer than the whole block are written to fd directly.
+        Should not be used by user.
+*/
+static void writer_put(ExportWriter* writer, const char* bytes, size_t length)
+{
+    if (writer->failed)
+    {
+        return;
+    }
+
+    if (writer->capacity - writer->length < length)
+    {
+        if (writer->fd < 0)
+        {
+            if (writer_reserve(writer, length) != 0)
+            {
+                return;
+            }
+        }
+        else if (writer_flush(writer) != 0)
+        {
+            return;
+        }
+        else if (length > writer->capacity)
+        {
+            writer->failed = fd_write_all(writer->fd, bytes, length) != 0;
+            return;
+        }
+    }
+
+    memcpy(writer->data + writer->length, bytes, length);
+    writer->length += length;
+}
+
+/*
+    static void writer_put_escaped(ExportWriter* writer, const char* str, int format)
+        Appends the string escaped for TSV or JSON, bytes are classified by a lookup table.
+        Runs of bytes which need no escape are copied at once.
+        Should not be used by user.
+*/
+static void writer_put_escaped(ExportWriter* writer, const char* str, int format)
+{
+    // Letter following the backslash, 'u' for \u00XX, 0 for bytes copied as they are
+    static const char tsvEscapes[256] = {['\t'] = 't', ['\n'] = 'n', ['\r'] = 'r', ['\\'] = '\\'};
+    static const char jsonEscapes[256] = {
+        [0x00] = 'u', [0x01] = 'u', [0x02] = 'u', [0x03] = 'u', [0x04] = 'u', [0x05] = 'u', [0x06] = 'u', [0x07] = 'u',
+        ['\b'] = 'b', ['\t'] = 't', ['\n'] = 'n', [0x0B] = 'u', ['\f'] = 'f', ['\r'] = 'r', [0x0E] = 'u', [0x0F] = 'u',
+        [0x10] = 'u', [0x11] = 'u', [0x12] = 'u', [0x13] = 'u', [0x14] = 'u', [0x15] = 'u', [0x16] = 'u', [0x17] = 'u',
+        [0x18] = 'u', [0x19] = 'u', [0x1A] = 'u', [0x1B] = 'u', [0x1C] = 'u', [0x1D] = 'u', [0x1E] = 'u', [0x1F] = 'u',
+        ['"'] = '"', ['\\'] = '\\'};
+    static const char hex[] = "0123456789abcdef";
+
+    const char* escapes = format == HASHTABLE_EXPORT_JSONL ? jsonEscapes : tsvEscapes;
+    const char* run = str;
+    const char* c = str;
+
+    for (; *c != '\0'; ++c)
+    {
+        const unsigned char byte = (unsigned char)*c;
+        const char escape = escapes[byte];
+        if (escape == 0)
+        {
+            continue;
+        }
+
+        writer_put(writer, run, (size_t)(c - run));
+        run = c + 1;
+
+        if (escape != 'u')
+        {
+            const char sequence[2] = {'\\', escape};
+            writer_put(writer, sequence, sizeof(sequence));
+        }
+        else
+        {
+            const char sequence[6] = {'\\', 'u', '0', '0', hex[byte >> 4], hex[byte & 0xFu]};
+            writer_put(writer, sequence, sizeof(sequence));
+        }
+    }
+
+    writer_put(writer, run, (size_t)(c - run));
+}
+
+/*
+    static int writer_flush(ExportWriter* writer)
+        Writes the block to fd and empties it, does nothing for a string writer.
+        Returns 0 on success, -1 if the write fails.
+        Should not be used by user.
+*/
+static int writer_flush(ExportWriter* writer)
+{
+    if (writer->failed)
+    {
+        return -1;
+    }
+
+    if (writer->fd >= 0 && writer->length > 0)
+    {
+        writer->failed = fd_write_all(writer->fd, writer->data, writer->length) != 0;
+        writer->length = 0;
+    }
+
+    return writer->failed ? -1 : 0;
+}
+
+/*
+    static int writer_reserve(ExportWriter* writer, size_t length)
+        Grows the string of the writer (at least twice) to fit length more bytes.
+        Returns 0 on success, -1 if allocation fails.
+        Should not be used by user.
+*/
+static int writer_reserve(ExportWriter* writer, size_t length)
+{
+    if (writer->capacity - writer->length >= length)
+    {
+        return 0;
+    }
+
+    size_t capacity = writer->capacity > 0 ? 2 * writer->capacity : HASHTABLE_EXPORT_BLOCK;
+    while (capacity - writer->length < length)
+    {
+        capacity *= 2;
+    }
+
+    char* data = realloc(writer->data, capacity);
+    if (data == NULL)
+    {
+        writer->failed = 1;
+        return -1;
+    }
+
+    writer->data = data;
+    writer->capacity = capacity;
+    return 0;
+}
+
+/*
+    static int fd_write_all(int fd, const char* bytes, size_t length)
+        Writes all bytes, continuing after partial writes and interrupted calls.
+        Returns 0 on success, -1 otherwise.
+        Should not be used by user.
+*/
+static int fd_write_all(int fd, const char* bytes, size_t length)
+{
+    while (length > 0)
+    {
+        const ssize_t written = write(fd, bytes, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+
+        bytes += written;
+        length -= (size_t)written;
+    }
+
+    return 0;
+}
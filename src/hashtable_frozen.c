@@ -0,0 +1,305 @@
+#include <hashtable_module/hashtable_frozen.h>
+#include <hashtable_module/hashtable_typed.h>
+#include "hashtable_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Seed of one key bucket holds its slot index directly
+#define FROZEN_DIRECT 0x80000000u
+// Seeds tried for one bucket before giving up, buckets with keys of equal 64-bit hash are refused without a search
+#define FROZEN_MAX_SEED (1u << 24)
+
+static uint64_t frozen_mix(uint64_t hash, uint32_t seed);
+static size_t frozen_bucket(uint64_t hash, size_t noOfBuckets);
+static int place_buckets(HashTableFrozen* frozen, const uint64_t* hashes, size_t* slotOf);
+
+/*
+    Function: HashTableFrozen* hashTable_freeze(const HashTable* hashTable)
+        Builds read only copy of given table indexed by minimal perfect hash (CHD-like hash and displace):
+        keys are split into buckets of ~HASHTABLE_FROZEN_BUCKET_KEYS keys and for every bucket a seed is
+        searched, which maps all its keys to still free slots. Lookup is then key hash, seed of its bucket
+        and a single key compare. Index takes 4 bytes per bucket (about one byte per key) instead of a
+        pointer per bucket of the records array. Every slot is just two string pointers (instead of a whole Record),
+        entries and strings share one block.
+        Source table is not modified and can be deleted afterwards.
+        Returns NULL if allocation fails or two keys of the table have the same 64-bit hash: every seed maps
+        them to the same slot, and a lookup reads only that one slot, so such keys can't be frozen.
+*/
+HashTableFrozen* hashTable_freeze(const HashTable* hashTable)
+{
+    if (hashTable == NULL)
+    {
+        return NULL;
+    }
+
+    HashTableFrozen* frozen = calloc(1, sizeof(*frozen));
+    if (frozen == NULL)
+    {
+        return NULL;
+    }
+
+    const size_t count = hashTable_collect_records(hashTable, NULL);
+    frozen->size = count;
+    frozen->noOfBuckets = count / HASHTABLE_FROZEN_BUCKET_KEYS + 1;
+
+    const Record** sources = malloc((count > 0 ? count : 1) * sizeof(*sources));
+    uint64_t* hashes = malloc((count > 0 ? count : 1) * sizeof(*hashes));
+    size_t* slotOf = malloc((count > 0 ? count : 1) * sizeof(*slotOf));
+    frozen->seeds = calloc(frozen->noOfBuckets, sizeof(*frozen->seeds));
+    if (sources == NULL || hashes == NULL || slotOf == NULL || frozen->seeds == NULL)
+    {
+        free(sources);
+        free(hashes);
+        free(slotOf);
+        hashTableFrozen_delete(frozen);
+        return NULL;
+    }
+
+    hashTable_collect_records(hashTable, sources);
+
+    size_t stringsSize = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        hashes[i] = hashTableTyped_hash_str(record_key(sources[i]));
+        stringsSize += strlen(record_key(sources[i])) + strlen(record_value(sources[i])) + 2;
+    }
+
+    if (place_buckets(frozen, hashes, slotOf) != 0)
+    {
+        free(sources);
+        free(hashes);
+        free(slotOf);
+        hashTableFrozen_delete(frozen);
+        return NULL;
+    }
+
+    // Entries in slot order followed by their strings, all in one block
+    frozen->entries = malloc(count * sizeof(*frozen->entries) + stringsSize + 1);
+    if (frozen->entries == NULL)
+    {
+        free(sources);
+        free(hashes);
+        free(slotOf);
+        hashTableFrozen_delete(frozen);
+        return NULL;
+    }
+
+    char* strings = (char*)(frozen->entries + count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        HashTableFrozenEntry* entry = &frozen->entries[slotOf[i]];
+        const size_t keyLen = strlen(record_key(sources[i])) + 1;
+        const size_t valueLen = strlen(record_value(sources[i])) + 1;
+
+        entry->key = memcpy(strings, record_key(sources[i]), keyLen);
+        strings += keyLen;
+        entry->value = memcpy(strings, record_value(sources[i]), valueLen);
+        strings += valueLen;
+    }
+
+    free(sources);
+    free(hashes);
+    free(slotOf);
+    return frozen;
+}
+
+/*
+    Function: void hashTableFrozen_delete(HashTableFrozen* frozen)
+        Releases the index and the block of entries and strings.
+*/
+void hashTableFrozen_delete(HashTableFrozen* frozen)
+{
+    if (frozen == NULL)
+    {
+        return;
+    }
+
+    free(frozen->seeds);
+    free(frozen->entries);
+    free(frozen);
+}
+
+/*
+    Function: const char* hashTableFrozen_search(const HashTableFrozen* frozen, const char* key)
+        Finds the only slot the key can be in and compares it. Returns the value or NULL if key is not present.
+*/
+const char* hashTableFrozen_search(const HashTableFrozen* frozen, const char* key)
+{
+    if (frozen == NULL || key == NULL || frozen->size == 0)
+    {
+        return NULL;
+    }
+
+    const uint64_t hash = hashTableTyped_hash_str(key);
+    const uint32_t seed = frozen->seeds[frozen_bucket(hash, frozen->noOfBuckets)];
+    const size_t slot = (seed & FROZEN_DIRECT) ? (size_t)(seed & ~FROZEN_DIRECT)
+                                                : (size_t)(frozen_mix(hash, seed) % frozen->size);
+
+    const HashTableFrozenEntry* entry = &frozen->entries[slot];
+    return strcmp(entry->key, key) == 0 ? entry->value : NULL;
+}
+
+/*
+    static int place_buckets(HashTableFrozen* frozen, const uint64_t* hashes, size_t* slotOf)
+        Finds the seed of every bucket, the biggest buckets first while there are plenty of free slots.
+        One key buckets take any free slot directly. slotOf[i] receives the slot of i-th key.
+        Returns 0 on success, -1 if allocation fails, some bucket holds two equal hashes or can't be placed.
+        Should not be used by user.
+*/
+static int place_buckets(HashTableFrozen* frozen, const uint64_t* hashes, size_t* slotOf)
+{
+    const size_t count = frozen->size;
+    const size_t noOfBuckets = frozen->noOfBuckets;
+    size_t* bucketStart = calloc(noOfBuckets + 1, sizeof(*bucketStart));
+    size_t* bucketKeys = malloc((count > 0 ? count : 1) * sizeof(*bucketKeys));
+    size_t* order = malloc(noOfBuckets * sizeof(*order));
+    size_t* candidate = malloc((count > 0 ? count : 1) * sizeof(*candidate));
+    unsigned char* taken = calloc(count > 0 ? count : 1, 1);
+    int result = 0;
+
+    if (bucketStart == NULL || bucketKeys == NULL || order == NULL || candidate == NULL || taken == NULL)
+    {
+        free(bucketStart);
+        free(bucketKeys);
+        free(order);
+        free(candidate);
+        free(taken);
+        return -1;
+    }
+
+    // Keys grouped by bucket: count, prefix sum, fill
+    for (size_t i = 0; i < count; ++i)
+    {
+        bucketStart[frozen_bucket(hashes[i], noOfBuckets) + 1]++;
+    }
+    size_t maxBucket = 0;
+    for (size_t b = 0; b < noOfBuckets; ++b)
+    {
+        maxBucket = bucketStart[b + 1] > maxBucket ? bucketStart[b + 1] : maxBucket;
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t b = frozen_bucket(hashes[i], noOfBuckets);
+        bucketKeys[bucketStart[b]++] = i;
+    }
+    memmove(bucketStart + 1, bucketStart, noOfBuckets * sizeof(*bucketStart));
+    bucketStart[0] = 0;
+
+    // Buckets ordered by size descending
+    size_t ordered = 0;
+    for (size_t size = maxBucket; size > 0; --size)
+    {
+        for (size_t b = 0; b < noOfBuckets; ++b)
+        {
+            if (bucketStart[b + 1] - bucketStart[b] == size)
+            {
+                order[ordered++] = b;
+            }
+        }
+    }
+
+    size_t nextFree = 0;
+    for (size_t o = 0; o < ordered && result == 0; ++o)
+    {
+        const size_t b = order[o];
+        const size_t first = bucketStart[b];
+        const size_t size = bucketStart[b + 1] - first;
+
+        if (size == 1)
+        {
+            while (taken[nextFree])
+            {
+                nextFree++;
+            }
+            taken[nextFree] = 1;
+            slotOf[bucketKeys[first]] = nextFree;
+            frozen->seeds[b] = FROZEN_DIRECT | (uint32_t)nextFree;
+            continue;
+        }
+
+        // Equal hashes collide under every seed, the bucket is refused instead of trying all of them
+        for (size_t i = 1; i < size && result == 0; ++i)
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (hashes[bucketKeys[first + i]] == hashes[bucketKeys[first + j]])
+                {
+                    result = -1;
+                    break;
+                }
+            }
+        }
+        if (result != 0)
+        {
+            break;
+        }
+
+        uint32_t seed = 0;
+        for (; seed < FROZEN_MAX_SEED; ++seed)
+        {
+            size_t placed = 0;
+            for (; placed < size; ++placed)
+            {
+                const size_t slot = (size_t)(frozen_mix(hashes[bucketKeys[first + placed]], seed) % count);
+                if (taken[slot])
+                {
+                    break;
+                }
+                // Mark temporarily, so two keys of the bucket can't get the same slot
+                taken[slot] = 1;
+                candidate[placed] = slot;
+            }
+
+            if (placed == size)
+            {
+                break;
+            }
+
+            for (size_t i = 0; i < placed; ++i)
+            {
+                taken[candidate[i]] = 0;
+            }
+        }
+
+        if (seed == FROZEN_MAX_SEED)
+        {
+            result = -1;
+            break;
+        }
+
+        frozen->seeds[b] = seed;
+        for (size_t i = 0; i < size; ++i)
+        {
+            slotOf[bucketKeys[first + i]] = candidate[i];
+        }
+    }
+
+    free(bucketStart);
+    free(bucketKeys);
+    free(order);
+    free(candidate);
+    free(taken);
+    return result;
+}
+
+/*
+    static uint64_t frozen_mix(uint64_t hash, uint32_t seed)
+        Derives seeded slot hash from the key hash without hashing the key again.
+        Should not be used by user.
+*/
+static uint64_t frozen_mix(uint64_t hash, uint32_t seed)
+{
+    uint64_t x = hash ^ ((uint64_t)seed * 0x9E3779B97F4A7C15u);
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDu;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53u;
+    x ^= x >> 33;
+    return x;
+}
+
+static size_t frozen_bucket(uint64_t hash, size_t noOfBuckets)
+{
+    return (size_t)((hash >> 32) % noOfBuckets);
+}
@@ -0,0 +1,215 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // pthread_rwlock_t
+#endif
+
+#include <hashtable_module/hashtable_intern.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Expected number of strings of the global pool, it grows as needed
+#define INTERN_GLOBAL_SIZE 1024
+
+// Type and prototypes come from HASHTABLE_TYPED_DECLARE in the header
+HASHTABLE_TYPED_IMPL(InternSet, , const char*, const char*, hashTableTyped_hash_str, HASHTABLE_TYPED_EQUAL_STR)
+
+static HashTableInternPool* globalPool = NULL;
+static pthread_once_t globalOnce = PTHREAD_ONCE_INIT;
+
+static void intern_global_init(void);
+static const char* intern_copy(HashTableInternPool* pool, const char* str);
+
+/*
+    Function: HashTableInternPool* hashTableIntern_new(size_t size, int threadSafe)
+        Allocates an empty pool with room for size strings before its set grows.
+        Pool created with threadSafe not zero can be used by many threads at once,
+        lookups of already interned strings don't block each other.
+        Returns NULL if allocation fails.
+*/
+HashTableInternPool* hashTableIntern_new(size_t size, int threadSafe)
+{
+    HashTableInternPool* pool = malloc(sizeof(*pool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    pool->set = hashTableInternSet_new(size);
+    if (pool->set == NULL)
+    {
+        free(pool);
+        return NULL;
+    }
+
+    pool->chunks = NULL;
+    pool->noOfStrings = 0;
+    pool->bytes = 0;
+    pool->threadSafe = threadSafe != 0;
+
+    if (pool->threadSafe && pthread_rwlock_init(&pool->lock, NULL) != 0)
+    {
+        hashTableInternSet_delete(pool->set);
+        free(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+/*
+    Function: void hashTableIntern_delete(HashTableInternPool* pool)
+        Releases the pool with all its strings, canonical pointers must not be used any more
+        (including those stored in tables).
+*/
+void hashTableIntern_delete(HashTableInternPool* pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    HashTableInternChunk* chunk = pool->chunks;
+    while (chunk != NULL)
+    {
+        HashTableInternChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    if (pool->threadSafe)
+    {
+        pthread_rwlock_destroy(&pool->lock);
+    }
+
+    hashTableInternSet_delete(pool->set);
+    free(pool);
+}
+
+/*
+    Function: const char* hashTableIntern_get(HashTableInternPool* pool, const char* str)
+        Returns the canonical pointer of the string, which is copied into the pool when it is seen first.
+        Returns NULL if arguments are incorrect or allocation fails.
+*/
+const char* hashTableIntern_get(HashTableInternPool* pool, const char* str)
+{
+    if (pool == NULL || str == NULL)
+    {
+        return NULL;
+    }
+
+    // Most strings are already interned, which needs only the shared lock
+    const char* canonical = hashTableIntern_find(pool, str);
+    if (canonical != NULL)
+    {
+        return canonical;
+    }
+
+    if (pool->threadSafe)
+    {
+        pthread_rwlock_wrlock(&pool->lock);
+    }
+
+    // Another thread may have interned it meanwhile
+    const char* const* present = hashTableInternSet_search(pool->set, str);
+    canonical = present != NULL ? *present : intern_copy(pool, str);
+
+    if (pool->threadSafe)
+    {
+        pthread_rwlock_unlock(&pool->lock);
+    }
+
+    return canonical;
+}
+
+/*
+    Function: const char* hashTableIntern_find(HashTableInternPool* pool, const char* str)
+        Returns the canonical pointer of the string, NULL if it is not interned. Nothing is allocated.
+*/
+const char* hashTableIntern_find(HashTableInternPool* pool, const char* str)
+{
+    if (pool == NULL || str == NULL)
+    {
+        return NULL;
+    }
+
+    if (pool->threadSafe)
+    {
+        pthread_rwlock_rdlock(&pool->lock);
+    }
+
+    const char* const* present = hashTableInternSet_search(pool->set, str);
+    const char* canonical = present != NULL ? *present : NULL;
+
+    if (pool->threadSafe)
+    {
+        pthread_rwlock_unlock(&pool->lock);
+    }
+
+    return canonical;
+}
+
+/*
+    Function: HashTableInternPool* hashTableIntern_global(void)
+        Returns the thread safe pool shared by the whole process, created by the first call.
+        It is never deleted. Returns NULL if it couldn't be created.
+*/
+HashTableInternPool* hashTableIntern_global(void)
+{
+    pthread_once(&globalOnce, intern_global_init);
+    return globalPool;
+}
+
+static void intern_global_init(void)
+{
+    globalPool = hashTableIntern_new(INTERN_GLOBAL_SIZE, 1);
+}
+
+/*
+    static const char* intern_copy(HashTableInternPool* pool, const char* str)
+        Copies new string to the newest chunk (a new chunk is allocated when it doesn't fit)
+        and adds the copy to the set. Caller holds the exclusive lock.
+        Returns the copy, NULL if allocation fails.
+        Should not be used by user.
+*/
+static const char* intern_copy(HashTableInternPool* pool, const char* str)
+{
+    const size_t size = strlen(str) + 1;
+    HashTableInternChunk* chunk = pool->chunks;
+
+    if (chunk == NULL || chunk->capacity - chunk->used < size)
+    {
+        const size_t capacity = size > HASHTABLE_INTERN_CHUNK ? size : HASHTABLE_INTERN_CHUNK;
+        chunk = malloc(sizeof(*chunk) + capacity);
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+
+        chunk->used = 0;
+        chunk->capacity = capacity;
+
+        // Chunk of a single long string goes behind the newest one, which keeps its free space
+        if (pool->chunks != NULL && capacity == size && pool->chunks->capacity - pool->chunks->used > 0)
+        {
+            chunk->next = pool->chunks->next;
+            pool->chunks->next = chunk;
+        }
+        else
+        {
+            chunk->next = pool->chunks;
+            pool->chunks = chunk;
+        }
+    }
+
+    char* copy = chunk->data + chunk->used;
+    memcpy(copy, str, size);
+
+    if (hashTableInternSet_insert(pool->set, copy, copy) != 0)
+    {
+        return NULL;
+    }
+
+    chunk->used += size;
+    pool->noOfStrings++;
+    pool->bytes += size;
+    return copy;
+}
@@ -0,0 +1,32 @@
+#ifndef HASHTABLE_INTERNAL_H
+#define HASHTABLE_INTERNAL_H
+
+#include <hashtable_module/hashtable.h>
+
+// Helpers shared by the modules built on HashTable, not a part of the public interface
+
+/*
+    static inline size_t hashTable_collect_records(const HashTable* hashTable, const Record** records)
+        Stores pointers to all records of the table into records (if not NULL) and returns their number.
+        Expired records are left out.
+        Should not be used by user.
+*/
+static inline size_t hashTable_collect_records(const HashTable* hashTable, const Record** records)
+{
+    HashTableIterator iterator;
+    size_t count = 0;
+
+    hashTable_iterator_init(&iterator, hashTable);
+    for (const Record* record = hashTable_iterator_next(&iterator); record != NULL; record = hashTable_iterator_next(&iterator))
+    {
+        if (records != NULL)
+        {
+            records[count] = record;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+#endif // HASHTABLE_INTERNAL_H
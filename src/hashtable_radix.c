@@ -0,0 +1,522 @@
+#include <hashtable_module/hashtable_radix.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int radix_valid(const char* category, size_t length);
+static size_t radix_segment(const char* str, size_t length);
+static int radix_segment_compare(const char* a, size_t aLen, const char* b, size_t bLen);
+static size_t radix_child(const HashTableRadixNode* node, const char* segment, size_t segmentLen, int* found);
+static size_t radix_common(const HashTableRadixNode* node, const char* rest, size_t restLen);
+static HashTableRadixNode* radix_node_new(const char* label, size_t labelLen, HashTableRadixNode* parent);
+static int radix_attach(HashTableRadixNode* node, HashTableRadixNode* child, size_t index);
+static HashTableRadixNode* radix_insert(HashTableRadix* tree, const char* category);
+static HashTableRadixNode* radix_find(const HashTableRadix* tree, const char* category, int exact);
+static HashTableRadixNode* radix_next(HashTableRadixNode* node, const HashTableRadixNode* top, int descend);
+static void radix_propagate(HashTableRadix* tree, HashTableRadixNode* top, int clear);
+
+/*
+    Function: HashTableRadix* hashTableRadix_new(int defaultLevel)
+        Allocates a tree with only the root, categories without configured ancestor resolve to defaultLevel.
+        Returns NULL if allocation fails.
+*/
+HashTableRadix* hashTableRadix_new(int defaultLevel)
+{
+    HashTableRadix* tree = malloc(sizeof(*tree));
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    tree->root = radix_node_new("", 0, NULL);
+    if (tree->root == NULL)
+    {
+        free(tree);
+        return NULL;
+    }
+
+    tree->root->level = defaultLevel;
+    tree->root->configured = 1;
+    tree->noOfNodes = 1;
+    tree->noOfConfigured = 1;
+    return tree;
+}
+
+/*
+    Function: void hashTableRadix_delete(HashTableRadix* tree)
+        Releases all nodes (handles returned by hashTableRadix_get included) and the tree itself.
+*/
+void hashTableRadix_delete(HashTableRadix* tree)
+{
+    if (tree == NULL)
+    {
+        return;
+    }
+
+    // Post-order without recursion, every child is detached from its parent before it is visited
+    HashTableRadixNode* node = tree->root;
+    while (node != NULL)
+    {
+        if (node->noOfChildren > 0)
+        {
+            node = node->children[--node->noOfChildren];
+            continue;
+        }
+
+        HashTableRadixNode* parent = node->parent;
+        free(node->children);
+        free(node);
+        node = parent;
+    }
+
+    free(tree);
+}
+
+/*
+    Function: const HashTableRadixNode* hashTableRadix_get(HashTableRadix* tree, const char* category)
+        Returns the node of the category, inserted (inheriting its level) if it is not in the tree yet.
+        The node stays valid until the tree is deleted and its level is kept resolved by every
+        reconfiguration, so a logger holding it checks its level without any lookup.
+        Returns NULL if arguments are incorrect (empty segment in category) or allocation fails.
+*/
+const HashTableRadixNode* hashTableRadix_get(HashTableRadix* tree, const char* category)
+{
+    if (tree == NULL || category == NULL)
+    {
+        return NULL;
+    }
+
+    return radix_insert(tree, category);
+}
+
+/*
+    Function: int hashTableRadix_resolve(const HashTableRadix* tree, const char* category)
+        Returns the level of the longest configured prefix of the category (whole segments only,
+        "net.httpx" doesn't inherit from "net.http"), the default level if there is none.
+        Nothing is inserted, the walk stops at the deepest node of the tree on the path of the category.
+        Returns -1 if arguments are incorrect.
+*/
+int hashTableRadix_resolve(const HashTableRadix* tree, const char* category)
+{
+    if (tree == NULL || category == NULL)
+    {
+        return -1;
+    }
+
+    const HashTableRadixNode* node = radix_find(tree, category, 0);
+    return node != NULL ? node->level : -1;
+}
+
+/*
+    Function: int hashTableRadix_set(HashTableRadix* tree, const char* category, int level)
+        Configures level of the category ("" for the default level). All its descendants without
+        own level are updated to it, descendants configured by themselves keep their levels.
+        Returns 0 on success, -1 if arguments are incorrect or allocation fails.
+*/
+int hashTableRadix_set(HashTableRadix* tree, const char* category, int level)
+{
+    if (tree == NULL || category == NULL)
+    {
+        return -1;
+    }
+
+    HashTableRadixNode* node = radix_insert(tree, category);
+    if (node == NULL)
+    {
+        return -1;
+    }
+
+    if (!node->configured)
+    {
+        node->configured = 1;
+        tree->noOfConfigured++;
+    }
+
+    node->level = level;
+    radix_propagate(tree, node, 0);
+    return 0;
+}
+
+/*
+    Function: int hashTableRadix_set_subtree(HashTableRadix* tree, const char* category, int level)
+        Configures level of the category and drops own levels of all its descendants,
+        so the whole subtree resolves to level.
+        Returns 0 on success, -1 if arguments are incorrect or allocation fails.
+*/
+int hashTableRadix_set_subtree(HashTableRadix* tree, const char* category, int level)
+{
+    if (hashTableRadix_set(tree, category, level) != 0)
+    {
+        return -1;
+    }
+
+    radix_propagate(tree, radix_find(tree, category, 1), 1);
+    return 0;
+}
+
+/*
+    Function: int hashTableRadix_unset(HashTableRadix* tree, const char* category)
+        Drops own level of the category, which inherits its level again (with descendants inheriting from it).
+        Nodes stay in the tree. The default level can't be unset.
+        Returns 0 on success (also if the category was not configured), -1 if arguments are incorrect.
+*/
+int hashTableRadix_unset(HashTableRadix* tree, const char* category)
+{
+    if (tree == NULL || category == NULL || category[0] == '\0' || !radix_valid(category, strlen(category)))
+    {
+        return -1;
+    }
+
+    HashTableRadixNode* node = radix_find(tree, category, 1);
+    if (node == NULL || !node->configured)
+    {
+        return 0;
+    }
+
+    node->configured = 0;
+    node->level = node->parent->level;
+    tree->noOfConfigured--;
+    radix_propagate(tree, node, 0);
+    return 0;
+}
+
+/*
+    static int radix_valid(const char* category, size_t length)
+        Checks that the category is empty or consists of non empty segments.
+        Should not be used by user.
+*/
+static int radix_valid(const char* category, size_t length)
+{
+    if (length == 0)
+    {
+        return 1;
+    }
+
+    if (category[0] == HASHTABLE_RADIX_SEPARATOR || category[length - 1] == HASHTABLE_RADIX_SEPARATOR)
+    {
+        return 0;
+    }
+
+    for (size_t i = 1; i < length; ++i)
+    {
+        if (category[i] == HASHTABLE_RADIX_SEPARATOR && category[i - 1] == HASHTABLE_RADIX_SEPARATOR)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+    static size_t radix_segment(const char* str, size_t length)
+        Returns length of the first segment of str.
+        Should not be used by user.
+*/
+static size_t radix_segment(const char* str, size_t length)
+{
+    const char* separator = memchr(str, HASHTABLE_RADIX_SEPARATOR, length);
+    return separator != NULL ? (size_t)(separator - str) : length;
+}
+
+static int radix_segment_compare(const char* a, size_t aLen, const char* b, size_t bLen)
+{
+    const int result = memcmp(a, b, aLen < bLen ? aLen : bLen);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    return aLen < bLen ? -1 : aLen > bLen;
+}
+
+/*
+    static size_t radix_child(const HashTableRadixNode* node, const char* segment, size_t segmentLen, int* found)
+        Binary search of the child whose label starts with the segment.
+        Returns its index with found set to 1, or the index where it would be inserted with found set to 0.
+        Should not be used by user.
+*/
+static size_t radix_child(const HashTableRadixNode* node, const char* segment, size_t segmentLen, int* found)
+{
+    size_t low = 0;
+    size_t high = node->noOfChildren;
+
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        const HashTableRadixNode* child = node->children[middle];
+        const int result = radix_segment_compare(child->label, child->segmentLen, segment, segmentLen);
+        if (result == 0)
+        {
+            *found = 1;
+            return middle;
+        }
+
+        if (result < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    *found = 0;
+    return low;
+}
+
+/*
+    static size_t radix_common(const HashTableRadixNode* node, const char* rest, size_t restLen)
+        Returns labelLen if the whole label of the node is a prefix of rest (by whole segments),
+        otherwise length of the longest common prefix ending at a segment boundary of both.
+        Node is a child found by the first segment of rest, so the result is never 0.
+        Should not be used by user.
+*/
+static size_t radix_common(const HashTableRadixNode* node, const char* rest, size_t restLen)
+{
+    const size_t shorter = node->labelLen < restLen ? node->labelLen : restLen;
+    size_t i = 0;
+    size_t boundary = 0;
+
+    for (; i < shorter && node->label[i] == rest[i]; ++i)
+    {
+        if (rest[i] == HASHTABLE_RADIX_SEPARATOR)
+        {
+            boundary = i;
+        }
+    }
+
+    if (i == node->labelLen && (i == restLen || rest[i] == HASHTABLE_RADIX_SEPARATOR))
+    {
+        return i;
+    }
+
+    if (i == restLen && node->label[i] == HASHTABLE_RADIX_SEPARATOR)
+    {
+        return i;
+    }
+
+    return boundary;
+}
+
+/*
+    static HashTableRadixNode* radix_node_new(const char* label, size_t labelLen, HashTableRadixNode* parent)
+        Allocates an unconfigured node without children, inheriting level of the parent.
+        Returns NULL if allocation fails.
+        Should not be used by user.
+*/
+static HashTableRadixNode* radix_node_new(const char* label, size_t labelLen, HashTableRadixNode* parent)
+{
+    HashTableRadixNode* node = malloc(sizeof(*node) + labelLen + 1);
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    node->parent = parent;
+    node->children = NULL;
+    node->noOfChildren = 0;
+    node->capacity = 0;
+    node->level = parent != NULL ? parent->level : 0;
+    node->configured = 0;
+    node->labelLen = labelLen;
+    node->segmentLen = radix_segment(label, labelLen);
+    memcpy(node->label, label, labelLen);
+    node->label[labelLen] = '\0';
+    return node;
+}
+
+/*
+    static int radix_attach(HashTableRadixNode* node, HashTableRadixNode* child, size_t index)
+        Inserts the child to children of the node at index, the array grows twice when full.
+        Returns 0 on success, -1 if allocation fails (node is unchanged).
+        Should not be used by user.
+*/
+static int radix_attach(HashTableRadixNode* node, HashTableRadixNode* child, size_t index)
+{
+    if (node->noOfChildren == node->capacity)
+    {
+        const size_t capacity = node->capacity > 0 ? 2 * node->capacity : 2;
+        HashTableRadixNode** children = realloc(node->children, capacity * sizeof(*children));
+        if (children == NULL)
+        {
+            return -1;
+        }
+
+        node->children = children;
+        node->capacity = capacity;
+    }
+
+    memmove(&node->children[index + 1], &node->children[index], (node->noOfChildren - index) * sizeof(*node->children));
+    node->children[index] = child;
+    node->noOfChildren++;
+    child->parent = node;
+    return 0;
+}
+
+/*
+    static HashTableRadixNode* radix_insert(HashTableRadix* tree, const char* category)
+        Walks the category down the tree, splitting the node where the category leaves its label
+        and adding the remaining segments as one new leaf. Split keeps the node with the longer label
+        (so handles stay valid), the common prefix goes to a new node above it.
+        Returns node of the category, NULL if the category is incorrect or allocation fails.
+        Should not be used by user.
+*/
+static HashTableRadixNode* radix_insert(HashTableRadix* tree, const char* category)
+{
+    size_t restLen = strlen(category);
+    if (!radix_valid(category, restLen))
+    {
+        return NULL;
+    }
+
+    HashTableRadixNode* node = tree->root;
+    const char* rest = category;
+
+    while (restLen > 0)
+    {
+        int found = 0;
+        const size_t index = radix_child(node, rest, radix_segment(rest, restLen), &found);
+
+        if (!found)
+        {
+            HashTableRadixNode* leaf = radix_node_new(rest, restLen, node);
+            if (leaf == NULL || radix_attach(node, leaf, index) != 0)
+            {
+                free(leaf);
+                return NULL;
+            }
+
+            tree->noOfNodes++;
+            return leaf;
+        }
+
+        HashTableRadixNode* child = node->children[index];
+        const size_t common = radix_common(child, rest, restLen);
+
+        if (common < child->labelLen)
+        {
+            HashTableRadixNode* middle = radix_node_new(child->label, common, node);
+            if (middle == NULL || radix_attach(middle, child, 0) != 0)
+            {
+                free(middle);
+                return NULL;
+            }
+
+            // Child keeps the part of its label behind the separator ending the common prefix
+            child->labelLen -= common + 1;
+            memmove(child->label, child->label + common + 1, child->labelLen + 1);
+            child->segmentLen = radix_segment(child->label, child->labelLen);
+            node->children[index] = middle;
+            tree->noOfNodes++;
+            child = middle;
+        }
+
+        node = child;
+        rest += common;
+        restLen -= common;
+        if (restLen > 0)
+        {
+            rest++;
+            restLen--;
+        }
+    }
+
+    return node;
+}
+
+/*
+    static HashTableRadixNode* radix_find(const HashTableRadix* tree, const char* category, int exact)
+        Returns the deepest node whose category is a prefix of the given one (the root at least).
+        With exact set returns NULL unless the node is the category itself. Nothing is changed.
+        Should not be used by user.
+*/
+static HashTableRadixNode* radix_find(const HashTableRadix* tree, const char* category, int exact)
+{
+    HashTableRadixNode* node = tree->root;
+    const char* rest = category;
+    size_t restLen = strlen(category);
+
+    while (restLen > 0)
+    {
+        int found = 0;
+        const size_t index = radix_child(node, rest, radix_segment(rest, restLen), &found);
+        if (!found)
+        {
+            break;
+        }
+
+        HashTableRadixNode* child = node->children[index];
+        if (radix_common(child, rest, restLen) < child->labelLen)
+        {
+            break;
+        }
+
+        node = child;
+        rest += child->labelLen;
+        restLen -= child->labelLen;
+        if (restLen > 0)
+        {
+            rest++;
+            restLen--;
+        }
+    }
+
+    return exact && restLen > 0 ? NULL : node;
+}
+
+/*
+    static HashTableRadixNode* radix_next(HashTableRadixNode* node, const HashTableRadixNode* top, int descend)
+        Returns the node following node in pre-order of the subtree of top, NULL at its end.
+        Children of node are skipped when descend is 0. The next sibling is found by binary search
+        in the parent, so no stack is needed.
+        Should not be used by user.
+*/
+static HashTableRadixNode* radix_next(HashTableRadixNode* node, const HashTableRadixNode* top, int descend)
+{
+    if (descend && node->noOfChildren > 0)
+    {
+        return node->children[0];
+    }
+
+    while (node != top)
+    {
+        HashTableRadixNode* parent = node->parent;
+        int found = 0;
+        const size_t index = radix_child(parent, node->label, node->segmentLen, &found);
+        if (index + 1 < parent->noOfChildren)
+        {
+            return parent->children[index + 1];
+        }
+
+        node = parent;
+    }
+
+    return NULL;
+}
+
+/*
+    static void radix_propagate(HashTableRadix* tree, HashTableRadixNode* top, int clear)
+        Updates cached levels of descendants of top after its level changed. Subtrees of configured
+        descendants are skipped, unless clear is set, which drops their own levels first.
+        Should not be used by user.
+*/
+static void radix_propagate(HashTableRadix* tree, HashTableRadixNode* top, int clear)
+{
+    int descend = 1;
+
+    for (HashTableRadixNode* node = radix_next(top, top, 1); node != NULL; node = radix_next(node, top, descend))
+    {
+        if (clear && node->configured)
+        {
+            node->configured = 0;
+            tree->noOfConfigured--;
+        }
+
+        descend = !node->configured;
+        if (descend)
+        {
+            node->level = node->parent->level;
+        }
+    }
+}
@@ -0,0 +1,840 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // pthreads, sched_yield
+#endif
+
+#include <hashtable_module/hashtable_rcu.h>
+#include <hashtable_module/hashtable_typed.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+static HashTableRcuVersion* rcu_version_new(size_t size, size_t depth);
+static void rcu_version_release(HashTableRcuVersion* version);
+static void rcu_node_release(HashTableRcuNode* node, size_t level);
+static HashTableRcuBucket* rcu_bucket_get(const HashTableRcuVersion* version, size_t index);
+static int rcu_bucket_put(HashTableRcuVersion* version, size_t index, HashTableRcuBucket* bucket);
+static void rcu_bucket_release(HashTableRcuBucket* bucket);
+static size_t rcu_bucket_find(const HashTableRcuBucket* bucket, uint64_t hash, const char* key);
+static HashTableRcuBucket* rcu_bucket_alloc(size_t count, size_t bytes);
+static void rcu_bucket_add(HashTableRcuBucket* bucket, char** strings, uint64_t hash, const char* key, const char* value);
+static HashTableRcuBucket* rcu_bucket_copy(const HashTableRcuBucket* bucket, size_t skip, const HashTableRcuEntry* extra);
+static int rcu_bucket_equals(const HashTableRcuBucket* bucket, const Record* const* records, const uint64_t* hashes, size_t count);
+static HashTableRcuBucket* rcu_bucket_from_records(const Record* const* records, const uint64_t* hashes, size_t count);
+static size_t rcu_reclaim(HashTableRcu* rcu);
+
+// Index of the entry not found by rcu_bucket_find
+#define RCU_NOT_FOUND ((size_t)-1)
+
+/*
+    Function: HashTableRcu* hashTableRcu_new(size_t size)
+        Allocates the table with an empty published version of size buckets (rounded up to a power of two).
+        The number of buckets is fixed, so unchanged buckets can be shared by all versions.
+        Returns NULL if allocation fails.
+*/
+HashTableRcu* hashTableRcu_new(size_t size)
+{
+    size_t buckets = 1;
+    size_t bits = 0;
+    while (buckets < size)
+    {
+        buckets <<= 1;
+        bits++;
+    }
+
+    HashTableRcu* rcu = calloc(1, sizeof(*rcu));
+    if (rcu == NULL)
+    {
+        return NULL;
+    }
+
+    const size_t depth = bits > 0 ? (bits + HASHTABLE_RCU_FANOUT_BITS - 1) / HASHTABLE_RCU_FANOUT_BITS : 1;
+    rcu->current = rcu_version_new(buckets, depth);
+    if (rcu->current == NULL || pthread_mutex_init(&rcu->lock, NULL) != 0)
+    {
+        free(rcu->current);
+        free(rcu);
+        return NULL;
+    }
+
+    rcu->epoch = 1;
+    return rcu;
+}
+
+/*
+    Function: void hashTableRcu_delete(HashTableRcu* rcu)
+        Releases all versions and registered readers. No thread may be in a read section.
+*/
+void hashTableRcu_delete(HashTableRcu* rcu)
+{
+    if (rcu == NULL)
+    {
+        return;
+    }
+
+    rcu_version_release(rcu->current);
+    rcu_version_release(rcu->draft);
+
+    while (rcu->retired != NULL)
+    {
+        HashTableRcuVersion* next = rcu->retired->nextRetired;
+        rcu_version_release(rcu->retired);
+        rcu->retired = next;
+    }
+
+    while (rcu->readers != NULL)
+    {
+        HashTableRcuReader* next = rcu->readers->next;
+        free(rcu->readers);
+        rcu->readers = next;
+    }
+
+    pthread_mutex_destroy(&rcu->lock);
+    free(rcu);
+}
+
+/*
+    Function: HashTableRcuReader* hashTableRcu_reader_register(HashTableRcu* rcu)
+        Registers a reader, every reading thread needs its own one.
+        Returns NULL if arguments are incorrect or allocation fails.
+*/
+HashTableRcuReader* hashTableRcu_reader_register(HashTableRcu* rcu)
+{
+    if (rcu == NULL)
+    {
+        return NULL;
+    }
+
+    HashTableRcuReader* reader = malloc(sizeof(*reader));
+    if (reader == NULL)
+    {
+        return NULL;
+    }
+
+    reader->rcu = rcu;
+    reader->epoch = 0;
+
+    pthread_mutex_lock(&rcu->lock);
+    reader->next = rcu->readers;
+    rcu->readers = reader;
+    pthread_mutex_unlock(&rcu->lock);
+
+    return reader;
+}
+
+/*
+    Function: void hashTableRcu_reader_unregister(HashTableRcuReader* reader)
+        Removes the reader (outside of a read section) and releases it.
+*/
+void hashTableRcu_reader_unregister(HashTableRcuReader* reader)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+
+    HashTableRcu* rcu = reader->rcu;
+    pthread_mutex_lock(&rcu->lock);
+
+    HashTableRcuReader** link = &rcu->readers;
+    while (*link != NULL && *link != reader)
+    {
+        link = &(*link)->next;
+    }
+
+    if (*link != NULL)
+    {
+        *link = reader->next;
+    }
+
+    pthread_mutex_unlock(&rcu->lock);
+    free(reader);
+}
+
+/*
+    Function: const HashTableRcuVersion* hashTableRcu_read_lock(HashTableRcuReader* reader)
+        Enters a read section and returns the current version, which stays valid (and unchanged)
+        until hashTableRcu_read_unlock. Takes no lock, a writer never waits for readers.
+        Read sections of one reader can't be nested. Returns NULL if arguments are incorrect.
+*/
+const HashTableRcuVersion* hashTableRcu_read_lock(HashTableRcuReader* reader)
+{
+    if (reader == NULL)
+    {
+        return NULL;
+    }
+
+    // Epoch is announced before the version is loaded, so the writer can't release what will be loaded
+    const uint64_t epoch = __atomic_load_n(&reader->rcu->epoch, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&reader->epoch, epoch, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&reader->rcu->current, __ATOMIC_SEQ_CST);
+}
+
+/*
+    Function: void hashTableRcu_read_unlock(HashTableRcuReader* reader)
+        Leaves the read section, the version and strings found in it must not be used any more.
+*/
+void hashTableRcu_read_unlock(HashTableRcuReader* reader)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+
+    __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/*
+    Function: const char* hashTableRcuVersion_search(const HashTableRcuVersion* version, const char* key)
+        Returns the value of the key in the version, NULL if it is not there.
+        Value is valid while the version is (until the end of the read section).
+*/
+const char* hashTableRcuVersion_search(const HashTableRcuVersion* version, const char* key)
+{
+    if (version == NULL || key == NULL)
+    {
+        return NULL;
+    }
+
+    const uint64_t hash = hashTableTyped_hash_str(key);
+    const HashTableRcuBucket* bucket = rcu_bucket_get(version, hash & (version->size - 1));
+    const size_t index = rcu_bucket_find(bucket, hash, key);
+
+    return index != RCU_NOT_FOUND ? bucket->entries[index].value : NULL;
+}
+
+/*
+    Function: int hashTableRcu_begin(HashTableRcu* rcu)
+        Starts an update: takes the writer lock and makes a draft sharing the whole bucket trie
+        of the current version, nothing is copied until the draft changes.
+        Draft is changed by hashTableRcu_insert, hashTableRcu_delete_record and hashTableRcu_load,
+        and ended by hashTableRcu_publish or hashTableRcu_abort of the same thread.
+        Returns 0 on success, -1 if arguments are incorrect or allocation fails.
+*/
+int hashTableRcu_begin(HashTableRcu* rcu)
+{
+    if (rcu == NULL)
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&rcu->lock);
+
+    const HashTableRcuVersion* current = rcu->current;
+    HashTableRcuVersion* draft = rcu_version_new(current->size, current->depth);
+    if (draft == NULL)
+    {
+        pthread_mutex_unlock(&rcu->lock);
+        return -1;
+    }
+
+    draft->root = current->root;
+    if (draft->root != NULL)
+    {
+        draft->root->refs++;
+    }
+
+    draft->noOfElems = current->noOfElems;
+    rcu->draft = draft;
+    return 0;
+}
+
+/*
+    Function: int hashTableRcu_insert(HashTableRcu* rcu, const char* key, const char* value)
+        Inserts the key (or replaces its value) in the draft. Only the bucket of the key (and trie nodes
+        on its path still shared with the current version) is copied, strings are copied into it. Setting the same value again changes nothing.
+        Returns 0 on success, -1 if arguments are incorrect, there is no draft or allocation fails.
+*/
+int hashTableRcu_insert(HashTableRcu* rcu, const char* key, const char* value)
+{
+    if (rcu == NULL || rcu->draft == NULL || key == NULL || value == NULL)
+    {
+        return -1;
+    }
+
+    HashTableRcuVersion* draft = rcu->draft;
+    const uint64_t hash = hashTableTyped_hash_str(key);
+    const size_t bucketIndex = hash & (draft->size - 1);
+    const HashTableRcuBucket* bucket = rcu_bucket_get(draft, bucketIndex);
+    const size_t index = rcu_bucket_find(bucket, hash, key);
+
+    if (index != RCU_NOT_FOUND && strcmp(bucket->entries[index].value, value) == 0)
+    {
+        return 0;
+    }
+
+    const HashTableRcuEntry entry = {hash, key, value};
+    HashTableRcuBucket* copy = rcu_bucket_copy(bucket, index, &entry);
+    if (copy == NULL || rcu_bucket_put(draft, bucketIndex, copy) != 0)
+    {
+        return -1;
+    }
+
+    if (index == RCU_NOT_FOUND)
+    {
+        draft->noOfElems++;
+    }
+
+    return 0;
+}
+
+/*
+    Function: int hashTableRcu_delete_record(HashTableRcu* rcu, const char* key)
+        Removes the key from the draft, only its bucket is copied.
+        Returns 0 on success (also if the key is not there), -1 if arguments are incorrect,
+        there is no draft or allocation fails.
+*/
+int hashTableRcu_delete_record(HashTableRcu* rcu, const char* key)
+{
+    if (rcu == NULL || rcu->draft == NULL || key == NULL)
+    {
+        return -1;
+    }
+
+    HashTableRcuVersion* draft = rcu->draft;
+    const uint64_t hash = hashTableTyped_hash_str(key);
+    const size_t bucketIndex = hash & (draft->size - 1);
+    const HashTableRcuBucket* bucket = rcu_bucket_get(draft, bucketIndex);
+    const size_t index = rcu_bucket_find(bucket, hash, key);
+
+    if (index == RCU_NOT_FOUND)
+    {
+        return 0;
+    }
+
+    HashTableRcuBucket* copy = NULL;
+    if (bucket->count > 1)
+    {
+        copy = rcu_bucket_copy(bucket, index, NULL);
+        if (copy == NULL)
+        {
+            return -1;
+        }
+    }
+
+    if (rcu_bucket_put(draft, bucketIndex, copy) != 0)
+    {
+        return -1;
+    }
+
+    draft->noOfElems--;
+    return 0;
+}
+
+/*
+    Function: int hashTableRcu_load(HashTableRcu* rcu, const HashTable* hashTable)
+        Replaces content of the draft by all records of the table (expired ones left out),
+        e.g. a configuration reloaded into a HashTable. Buckets with the same entries as before
+        stay shared, so a reload which changed few keys copies only their buckets.
+        Returns 0 on success, -1 if arguments are incorrect, there is no draft or allocation fails
+        (the draft may be partially loaded then, it should be aborted).
+*/
+int hashTableRcu_load(HashTableRcu* rcu, const HashTable* hashTable)
+{
+    if (rcu == NULL || rcu->draft == NULL || hashTable == NULL)
+    {
+        return -1;
+    }
+
+    HashTableRcuVersion* draft = rcu->draft;
+    const size_t capacity = hashTable->noOfElems > 0 ? hashTable->noOfElems : 1;
+    const Record** records = malloc(2 * capacity * sizeof(*records));
+    uint64_t* hashes = malloc(2 * capacity * sizeof(*hashes));
+    size_t* starts = calloc(draft->size + 1, sizeof(*starts));
+    if (records == NULL || hashes == NULL || starts == NULL)
+    {
+        free(records);
+        free(hashes);
+        free(starts);
+        return -1;
+    }
+
+    // Records are counted per bucket in the first half of the arrays, then sorted by bucket into the second half
+    HashTableIterator iterator;
+    hashTable_iterator_init(&iterator, hashTable);
+    size_t count = 0;
+    for (const Record* record = hashTable_iterator_next(&iterator); record != NULL && count < capacity;
+         record = hashTable_iterator_next(&iterator))
+    {
+        records[count] = record;
+        hashes[count] = hashTableTyped_hash_str(record_key(record));
+        starts[(hashes[count] & (draft->size - 1)) + 1]++;
+        count++;
+    }
+
+    for (size_t i = 0; i < draft->size; ++i)
+    {
+        starts[i + 1] += starts[i];
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t target = capacity + starts[hashes[i] & (draft->size - 1)]++;
+        records[target] = records[i];
+        hashes[target] = hashes[i];
+    }
+
+    // Placement moved every start to the start of the following bucket
+    int result = 0;
+    for (size_t i = 0; i < draft->size && result == 0; ++i)
+    {
+        const size_t first = capacity + (i > 0 ? starts[i - 1] : 0);
+        const size_t inBucket = capacity + starts[i] - first;
+
+        const HashTableRcuBucket* present = rcu_bucket_get(draft, i);
+        if (rcu_bucket_equals(present, &records[first], &hashes[first], inBucket))
+        {
+            continue;
+        }
+
+        const size_t presentCount = present != NULL ? present->count : 0;
+        HashTableRcuBucket* bucket = inBucket > 0 ? rcu_bucket_from_records(&records[first], &hashes[first], inBucket) : NULL;
+        if ((inBucket > 0 && bucket == NULL) || rcu_bucket_put(draft, i, bucket) != 0)
+        {
+            result = -1;
+            break;
+        }
+
+        draft->noOfElems = draft->noOfElems - presentCount + inBucket;
+    }
+
+    free(records);
+    free(hashes);
+    free(starts);
+    return result;
+}
+
+/*
+    Function: int hashTableRcu_publish(HashTableRcu* rcu)
+        Makes the draft the current version by one atomic store, readers entering a read section
+        from now on get it. Replaced version is retired and released (with buckets no other version shares)
+        as soon as no reader can hold it. Ends the update and releases the writer lock.
+        Returns 0 on success, -1 if arguments are incorrect or there is no draft.
+*/
+int hashTableRcu_publish(HashTableRcu* rcu)
+{
+    if (rcu == NULL || rcu->draft == NULL)
+    {
+        return -1;
+    }
+
+    HashTableRcuVersion* replaced = rcu->current;
+    __atomic_store_n(&rcu->current, rcu->draft, __ATOMIC_SEQ_CST);
+    rcu->draft = NULL;
+
+    // Readers which announced an epoch after the increment can't have loaded the replaced version
+    replaced->retiredAt = __atomic_fetch_add(&rcu->epoch, 1, __ATOMIC_SEQ_CST);
+    replaced->nextRetired = rcu->retired;
+    rcu->retired = replaced;
+    rcu->noOfRetired++;
+
+    rcu_reclaim(rcu);
+    pthread_mutex_unlock(&rcu->lock);
+    return 0;
+}
+
+/*
+    Function: void hashTableRcu_abort(HashTableRcu* rcu)
+        Drops the draft, the current version stays. Ends the update and releases the writer lock.
+*/
+void hashTableRcu_abort(HashTableRcu* rcu)
+{
+    if (rcu == NULL || rcu->draft == NULL)
+    {
+        return;
+    }
+
+    rcu_version_release(rcu->draft);
+    rcu->draft = NULL;
+    pthread_mutex_unlock(&rcu->lock);
+}
+
+/*
+    Function: size_t hashTableRcu_reclaim(HashTableRcu* rcu)
+        Releases retired versions which no reader can hold any more. Must not be called during an update.
+        Returns the number of versions still waiting.
+*/
+size_t hashTableRcu_reclaim(HashTableRcu* rcu)
+{
+    if (rcu == NULL)
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock(&rcu->lock);
+    const size_t waiting = rcu_reclaim(rcu);
+    pthread_mutex_unlock(&rcu->lock);
+    return waiting;
+}
+
+/*
+    Function: void hashTableRcu_synchronize(HashTableRcu* rcu)
+        Waits until all retired versions are released, i.e. until every read section which
+        could see them has ended. Must not be called from a read section or during an update.
+*/
+void hashTableRcu_synchronize(HashTableRcu* rcu)
+{
+    while (hashTableRcu_reclaim(rcu) > 0)
+    {
+        sched_yield();
+    }
+}
+
+/*
+    static HashTableRcuVersion* rcu_version_new(size_t size, size_t depth)
+        Allocates an empty version of size buckets indexed by a trie of depth levels.
+        Returns NULL if allocation fails.
+        Should not be used by user.
+*/
+static HashTableRcuVersion* rcu_version_new(size_t size, size_t depth)
+{
+    HashTableRcuVersion* version = calloc(1, sizeof(*version));
+    if (version == NULL)
+    {
+        return NULL;
+    }
+
+    version->size = size;
+    version->depth = depth;
+    return version;
+}
+
+/*
+    static void rcu_version_release(HashTableRcuVersion* version)
+        Releases the version with trie nodes and buckets held by no other version.
+        Should not be used by user.
+*/
+static void rcu_version_release(HashTableRcuVersion* version)
+{
+    if (version == NULL)
+    {
+        return;
+    }
+
+    rcu_node_release(version->root, version->depth - 1);
+    free(version);
+}
+
+/*
+    static void rcu_node_release(HashTableRcuNode* node, size_t level)
+        Drops one reference of the node (NULL is ignored) of given trie level, 0 being the lowest one.
+        Node held by nobody else is released together with its subtree, recursion is bounded by the depth.
+        Should not be used by user.
+*/
+static void rcu_node_release(HashTableRcuNode* node, size_t level)
+{
+    if (node == NULL || --node->refs > 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < HASHTABLE_RCU_FANOUT; ++i)
+    {
+        if (level > 0)
+        {
+            rcu_node_release(node->slots.nodes[i], level - 1);
+        }
+        else
+        {
+            rcu_bucket_release(node->slots.buckets[i]);
+        }
+    }
+
+    free(node);
+}
+
+/*
+    static HashTableRcuBucket* rcu_bucket_get(const HashTableRcuVersion* version, size_t index)
+        Walks the trie of the version down to the bucket at index.
+        Returns the bucket, NULL if it is empty.
+        Should not be used by user.
+*/
+static HashTableRcuBucket* rcu_bucket_get(const HashTableRcuVersion* version, size_t index)
+{
+    const HashTableRcuNode* node = version->root;
+
+    for (size_t level = version->depth - 1; level > 0 && node != NULL; --level)
+    {
+        node = node->slots.nodes[(index >> (level * HASHTABLE_RCU_FANOUT_BITS)) & (HASHTABLE_RCU_FANOUT - 1)];
+    }
+
+    return node != NULL ? node->slots.buckets[index & (HASHTABLE_RCU_FANOUT - 1)] : NULL;
+}
+
+/*
+    static size_t rcu_bucket_find(const HashTableRcuBucket* bucket, uint64_t hash, const char* key)
+        Returns index of the entry of the key, RCU_NOT_FOUND if it is not in the bucket (or bucket is NULL).
+        Should not be used by user.
+*/
+static size_t rcu_bucket_find(const HashTableRcuBucket* bucket, uint64_t hash, const char* key)
+{
+    if (bucket == NULL)
+    {
+        return RCU_NOT_FOUND;
+    }
+
+    for (size_t i = 0; i < bucket->count; ++i)
+    {
+        if (bucket->entries[i].hash == hash && strcmp(bucket->entries[i].key, key) == 0)
+        {
+            return i;
+        }
+    }
+
+    return RCU_NOT_FOUND;
+}
+
+/*
+    static HashTableRcuBucket* rcu_bucket_alloc(size_t count, size_t bytes)
+        Allocates a bucket with room for count entries and bytes of their strings, no entry is used yet.
+        Returns NULL if allocation fails.
+        Should not be used by user.
+*/
+static HashTableRcuBucket* rcu_bucket_alloc(size_t count, size_t bytes)
+{
+    HashTableRcuBucket* bucket = malloc(sizeof(*bucket) + count * sizeof(*bucket->entries) + bytes);
+    if (bucket == NULL)
+    {
+        return NULL;
+    }
+
+    bucket->refs = 1;
+    bucket->count = 0;
+    return bucket;
+}
+
+/*
+    static void rcu_bucket_add(HashTableRcuBucket* bucket, char** strings, uint64_t hash, const char* key, const char* value)
+        Appends the entry, its strings are copied to strings, which is moved behind them.
+        Should not be used by user.
+*/
+static void rcu_bucket_add(HashTableRcuBucket* bucket, char** strings, uint64_t hash, const char* key, const char* value)
+{
+    const size_t keySize = strlen(key) + 1;
+    const size_t valueSize = strlen(value) + 1;
+    HashTableRcuEntry* entry = &bucket->entries[bucket->count++];
+
+    memcpy(*strings, key, keySize);
+    memcpy(*strings + keySize, value, valueSize);
+    entry->hash = hash;
+    entry->key = *strings;
+    entry->value = *strings + keySize;
+    *strings += keySize + valueSize;
+}
+
+/*
+    static HashTableRcuBucket* rcu_bucket_copy(const HashTableRcuBucket* bucket, size_t skip, const HashTableRcuEntry* extra)
+        Copies entries of the bucket (which may be NULL) except the one at index skip, the extra entry
+        (if not NULL) takes its place or is appended when skip is RCU_NOT_FOUND.
+        Returns the new bucket, NULL if allocation fails.
+        Should not be used by user.
+*/
+static HashTableRcuBucket* rcu_bucket_copy(const HashTableRcuBucket* bucket, size_t skip, const HashTableRcuEntry* extra)
+{
+    const size_t oldCount = bucket != NULL ? bucket->count : 0;
+    size_t count = 0;
+    size_t bytes = 0;
+
+    for (size_t i = 0; i <= oldCount; ++i)
+    {
+        const HashTableRcuEntry* entry = i == skip || i == oldCount ? NULL : &bucket->entries[i];
+        if ((i == skip || (i == oldCount && skip == RCU_NOT_FOUND)) && extra != NULL)
+        {
+            entry = extra;
+        }
+
+        if (entry != NULL)
+        {
+            count++;
+            bytes += strlen(entry->key) + strlen(entry->value) + 2;
+        }
+    }
+
+    HashTableRcuBucket* copy = rcu_bucket_alloc(count, bytes);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+
+    char* strings = (char*)&copy->entries[count];
+    for (size_t i = 0; i <= oldCount; ++i)
+    {
+        const HashTableRcuEntry* entry = i == skip || i == oldCount ? NULL : &bucket->entries[i];
+        if ((i == skip || (i == oldCount && skip == RCU_NOT_FOUND)) && extra != NULL)
+        {
+            entry = extra;
+        }
+
+        if (entry != NULL)
+        {
+            rcu_bucket_add(copy, &strings, entry->hash, entry->key, entry->value);
+        }
+    }
+
+    return copy;
+}
+
+/*
+    static int rcu_bucket_equals(const HashTableRcuBucket* bucket, const Record* const* records, const uint64_t* hashes, size_t count)
+        Checks whether the bucket (which may be NULL) holds exactly the keys and values of the records.
+        Should not be used by user.
+*/
+static int rcu_bucket_equals(const HashTableRcuBucket* bucket, const Record* const* records, const uint64_t* hashes, size_t count)
+{
+    if ((bucket != NULL ? bucket->count : 0) != count)
+    {
+        return 0;
+    }
+
+    // Keys of a table are distinct, so the same number of found keys means the same set
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t index = rcu_bucket_find(bucket, hashes[i], record_key(records[i]));
+        if (index == RCU_NOT_FOUND || strcmp(bucket->entries[index].value, record_value(records[i])) != 0)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+    static HashTableRcuBucket* rcu_bucket_from_records(const Record* const* records, const uint64_t* hashes, size_t count)
+        Allocates a bucket with copies of keys and values of the records.
+        Returns NULL if allocation fails.
+        Should not be used by user.
+*/
+static HashTableRcuBucket* rcu_bucket_from_records(const Record* const* records, const uint64_t* hashes, size_t count)
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        bytes += strlen(record_key(records[i])) + strlen(record_value(records[i])) + 2;
+    }
+
+    HashTableRcuBucket* bucket = rcu_bucket_alloc(count, bytes);
+    if (bucket == NULL)
+    {
+        return NULL;
+    }
+
+    char* strings = (char*)&bucket->entries[count];
+    for (size_t i = 0; i < count; ++i)
+    {
+        rcu_bucket_add(bucket, &strings, hashes[i], record_key(records[i]), record_value(records[i]));
+    }
+
+    return bucket;
+}
+
+/*
+    static int rcu_bucket_put(HashTableRcuVersion* version, size_t index, HashTableRcuBucket* bucket)
+        Replaces the bucket at index of the draft version by the given one (NULL empties it). Trie nodes
+        on the path which are shared are copied first (their children get one more reference), missing
+        ones are allocated. The replaced bucket is released when no other node holds it.
+        Returns 0 on success, -1 if allocation fails (the given bucket is released then).
+        Should not be used by user.
+*/
+static int rcu_bucket_put(HashTableRcuVersion* version, size_t index, HashTableRcuBucket* bucket)
+{
+    HashTableRcuNode** link = &version->root;
+
+    for (size_t level = version->depth; level-- > 0;)
+    {
+        HashTableRcuNode* node = *link;
+        if (node == NULL || node->refs > 1)
+        {
+            HashTableRcuNode* copy = node != NULL ? malloc(sizeof(*copy)) : calloc(1, sizeof(*copy));
+            if (copy == NULL)
+            {
+                rcu_bucket_release(bucket);
+                return -1;
+            }
+
+            if (node != NULL)
+            {
+                *copy = *node;
+                for (size_t i = 0; i < HASHTABLE_RCU_FANOUT; ++i)
+                {
+                    if (level > 0 && copy->slots.nodes[i] != NULL)
+                    {
+                        copy->slots.nodes[i]->refs++;
+                    }
+                    else if (level == 0 && copy->slots.buckets[i] != NULL)
+                    {
+                        copy->slots.buckets[i]->refs++;
+                    }
+                }
+                node->refs--;
+            }
+
+            copy->refs = 1;
+            node = copy;
+            *link = node;
+        }
+
+        const size_t slot = (index >> (level * HASHTABLE_RCU_FANOUT_BITS)) & (HASHTABLE_RCU_FANOUT - 1);
+        if (level > 0)
+        {
+            link = &node->slots.nodes[slot];
+        }
+        else
+        {
+            rcu_bucket_release(node->slots.buckets[slot]);
+            node->slots.buckets[slot] = bucket;
+        }
+    }
+
+    return 0;
+}
+
+/*
+    static void rcu_bucket_release(HashTableRcuBucket* bucket)
+        Drops one reference of the bucket (NULL is ignored), which is released when nobody else holds it.
+        Should not be used by user.
+*/
+static void rcu_bucket_release(HashTableRcuBucket* bucket)
+{
+    if (bucket != NULL && --bucket->refs == 0)
+    {
+        free(bucket);
+    }
+}
+
+/*
+    static size_t rcu_reclaim(HashTableRcu* rcu)
+        Releases retired versions older than the oldest epoch announced by a reader in a read section.
+        Caller holds the writer lock. Returns the number of versions still waiting.
+        Should not be used by user.
+*/
+static size_t rcu_reclaim(HashTableRcu* rcu)
+{
+    uint64_t oldest = UINT64_MAX;
+    for (const HashTableRcuReader* reader = rcu->readers; reader != NULL; reader = reader->next)
+    {
+        const uint64_t epoch = __atomic_load_n(&reader->epoch, __ATOMIC_SEQ_CST);
+        if (epoch != 0 && epoch < oldest)
+        {
+            oldest = epoch;
+        }
+    }
+
+    // Retired list goes from the newest version, everything behind the first releasable one is older
+    HashTableRcuVersion** link = &rcu->retired;
+    while (*link != NULL && (*link)->retiredAt >= oldest)
+    {
+        link = &(*link)->nextRetired;
+    }
+
+    HashTableRcuVersion* version = *link;
+    *link = NULL;
+    while (version != NULL)
+    {
+        HashTableRcuVersion* next = version->nextRetired;
+        rcu_version_release(version);
+        rcu->noOfRetired--;
+        version = next;
+    }
+
+    return rcu->noOfRetired;
+}
@@ -0,0 +1,300 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // mmap, open, fstat
+#endif
+
+#include <hashtable_module/hashtable_snapshot.h>
+#include <hashtable_module/hashtable_typed.h>
+#include "hashtable_internal.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static uint64_t snapshot_checksum(const HashTableSnapshotHeader* header);
+static int snapshot_valid(const HashTableSnapshotHeader* header, size_t fileSize);
+
+/*
+    Function: int hashTable_snapshot_write(const HashTable* hashTable, const char* path)
+        Serializes given hash table into the snapshot file, see hashtable_snapshot.h for the layout.
+        Whole image is prepared in memory, written to "<path>.tmp" and renamed to path,
+        so processes which open the snapshot never see a partially written file.
+        Returns 0 on success, -1 otherwise.
+*/
+int hashTable_snapshot_write(const HashTable* hashTable, const char* path)
+{
+    if (hashTable == NULL || path == NULL)
+    {
+        return -1;
+    }
+
+    const size_t noOfElems = hashTable_collect_records(hashTable, NULL);
+    const Record** records = malloc((noOfElems > 0 ? noOfElems : 1) * sizeof(*records));
+    uint64_t* hashes = malloc((noOfElems > 0 ? noOfElems : 1) * sizeof(*hashes));
+    if (records == NULL || hashes == NULL)
+    {
+        free(records);
+        free(hashes);
+        return -1;
+    }
+    hashTable_collect_records(hashTable, records);
+
+    // Power of two buckets, so lookup needs a mask only
+    size_t size = 1;
+    while (size < noOfElems)
+    {
+        size <<= 1;
+    }
+
+    size_t stringsSize = 0;
+    for (size_t i = 0; i < noOfElems; ++i)
+    {
+        hashes[i] = hashTableTyped_hash_str(record_key(records[i]));
+        stringsSize += strlen(record_key(records[i])) + strlen(record_value(records[i])) + 2;
+    }
+
+    HashTableSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HASHTABLE_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.size = size;
+    header.noOfElems = noOfElems;
+    header.bucketsOffset = sizeof(header);
+    header.entriesOffset = header.bucketsOffset + (size + 1) * sizeof(uint64_t);
+    header.stringsOffset = header.entriesOffset + noOfElems * sizeof(HashTableSnapshotEntry);
+    header.stringsSize = stringsSize;
+    header.fileSize = header.stringsOffset + stringsSize;
+    header.checksum = snapshot_checksum(&header);
+
+    unsigned char* image = calloc(1, header.fileSize);
+    if (image == NULL)
+    {
+        free(records);
+        free(hashes);
+        return -1;
+    }
+
+    memcpy(image, &header, sizeof(header));
+    uint64_t* buckets = (uint64_t*)(void*)(image + header.bucketsOffset);
+    HashTableSnapshotEntry* entries = (HashTableSnapshotEntry*)(void*)(image + header.entriesOffset);
+    char* strings = (char*)(image + header.stringsOffset);
+
+    // Counting sort of entries by bucket: count, prefix sum, place
+    for (size_t i = 0; i < noOfElems; ++i)
+    {
+        buckets[(hashes[i] & (size - 1)) + 1]++;
+    }
+    for (size_t i = 0; i < size; ++i)
+    {
+        buckets[i + 1] += buckets[i];
+    }
+
+    uint64_t stringsUsed = 0;
+    for (size_t i = 0; i < noOfElems; ++i)
+    {
+        // buckets[b] is used as the insertion cursor of bucket b and shifted back afterwards
+        const size_t bucket = (size_t)(hashes[i] & (size - 1));
+        HashTableSnapshotEntry* entry = &entries[buckets[bucket]++];
+        const size_t keyLen = strlen(record_key(records[i])) + 1;
+        const size_t valueLen = strlen(record_value(records[i])) + 1;
+
+        entry->hash = hashes[i];
+        entry->keyOffset = stringsUsed;
+        memcpy(strings + stringsUsed, record_key(records[i]), keyLen);
+        stringsUsed += keyLen;
+        entry->valueOffset = stringsUsed;
+        memcpy(strings + stringsUsed, record_value(records[i]), valueLen);
+        stringsUsed += valueLen;
+    }
+    memmove(buckets + 1, buckets, size * sizeof(*buckets));
+    buckets[0] = 0;
+
+    free(records);
+    free(hashes);
+
+    const size_t tmpPathLen = strlen(path) + sizeof(".tmp");
+    char* tmpPath = malloc(tmpPathLen);
+    if (tmpPath == NULL)
+    {
+        free(image);
+        return -1;
+    }
+    snprintf(tmpPath, tmpPathLen, "%s.tmp", path);
+
+    int result = -1;
+    FILE* file = fopen(tmpPath, "wb");
+    if (file != NULL)
+    {
+        const size_t written = fwrite(image, 1, header.fileSize, file);
+        if (fclose(file) == 0 && written == header.fileSize && rename(tmpPath, path) == 0)
+        {
+            result = 0;
+        }
+        else
+        {
+            remove(tmpPath);
+        }
+    }
+
+    free(tmpPath);
+    free(image);
+    return result;
+}
+
+/*
+    Function: HashTableSnapshot* hashTableSnapshot_open(const char* path)
+        Maps the snapshot file read only. Nothing is copied or deserialized, pages are loaded on first access
+        and shared with every other process which maps the same file.
+        Only the header is validated (checksum and bounds of the regions), so opening doesn't touch the buckets,
+        entries or strings. Their offsets are checked by the lookups, a damaged file is never read out of bounds.
+        Returns NULL if the file can't be mapped or is not a valid snapshot.
+*/
+HashTableSnapshot* hashTableSnapshot_open(const char* path)
+{
+    if (path == NULL)
+    {
+        return NULL;
+    }
+
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(HashTableSnapshotHeader))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    const size_t fileSize = (size_t)st.st_size;
+    void* mapping = mmap(NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    const HashTableSnapshotHeader* header = mapping;
+    if (!snapshot_valid(header, fileSize))
+    {
+        munmap(mapping, fileSize);
+        return NULL;
+    }
+
+    HashTableSnapshot* snapshot = malloc(sizeof(*snapshot));
+    if (snapshot == NULL)
+    {
+        munmap(mapping, fileSize);
+        return NULL;
+    }
+
+    const unsigned char* base = mapping;
+    snapshot->mapping = mapping;
+    snapshot->mappingSize = fileSize;
+    snapshot->size = (size_t)header->size;
+    snapshot->noOfElems = (size_t)header->noOfElems;
+    snapshot->buckets = (const uint64_t*)(const void*)(base + header->bucketsOffset);
+    snapshot->entries = (const HashTableSnapshotEntry*)(const void*)(base + header->entriesOffset);
+    snapshot->strings = (const char*)(base + header->stringsOffset);
+    snapshot->stringsSize = (size_t)header->stringsSize;
+
+    return snapshot;
+}
+
+/*
+    Function: void hashTableSnapshot_close(HashTableSnapshot* snapshot)
+        Unmaps the file and releases the snapshot handle.
+*/
+void hashTableSnapshot_close(HashTableSnapshot* snapshot)
+{
+    if (snapshot == NULL)
+    {
+        return;
+    }
+
+    munmap(snapshot->mapping, snapshot->mappingSize);
+    free(snapshot);
+}
+
+/*
+    Function: const char* hashTableSnapshot_search(const HashTableSnapshot* snapshot, const char* key)
+        Equivalent of hashTable_search working directly on the mapped file, offsets of the visited bucket
+        and entries are bounds checked.
+        Returns the value pointing into the mapping, valid until hashTableSnapshot_close.
+*/
+const char* hashTableSnapshot_search(const HashTableSnapshot* snapshot, const char* key)
+{
+    if (snapshot == NULL || key == NULL || snapshot->noOfElems == 0)
+    {
+        return NULL;
+    }
+
+    const uint64_t hash = hashTableTyped_hash_str(key);
+    const size_t bucket = (size_t)(hash & (snapshot->size - 1));
+
+    const uint64_t end = snapshot->buckets[bucket + 1] < snapshot->noOfElems ? snapshot->buckets[bucket + 1] : snapshot->noOfElems;
+
+    // Offsets come from the file, the last byte of strings is NUL, so any offset before it is a whole string
+    for (uint64_t i = snapshot->buckets[bucket]; i < end; ++i)
+    {
+        const HashTableSnapshotEntry* entry = &snapshot->entries[i];
+        if (entry->hash == hash && entry->keyOffset < snapshot->stringsSize && entry->valueOffset < snapshot->stringsSize &&
+            strcmp(snapshot->strings + entry->keyOffset, key) == 0)
+        {
+            return snapshot->strings + entry->valueOffset;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    static uint64_t snapshot_checksum(const HashTableSnapshotHeader* header)
+        Mixes all header fields but the checksum itself by the finalizer of hashTableTyped_hash_u64.
+        Should not be used by user.
+*/
+static uint64_t snapshot_checksum(const HashTableSnapshotHeader* header)
+{
+    uint64_t magic = 0;
+    memcpy(&magic, header->magic, sizeof(magic));
+
+    const uint64_t fields[] = {magic, header->size, header->noOfElems, header->bucketsOffset, header->entriesOffset,
+                               header->stringsOffset, header->stringsSize, header->fileSize};
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < sizeof(fields) / sizeof(*fields); ++i)
+    {
+        checksum = hashTableTyped_hash_u64(checksum ^ fields[i]);
+    }
+
+    return checksum;
+}
+
+/*
+    static int snapshot_valid(const HashTableSnapshotHeader* header, size_t fileSize)
+        Checks the header: magic, checksum and that all regions it describes lie within the file one after
+        another. Of the rest of the file only the last byte of strings is read, which has to be NUL.
+        Should not be used by user.
+*/
+static int snapshot_valid(const HashTableSnapshotHeader* header, size_t fileSize)
+{
+    if (memcmp(header->magic, HASHTABLE_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->checksum != snapshot_checksum(header) ||
+        header->fileSize != fileSize ||
+        header->size == 0 || (header->size & (header->size - 1)) != 0 ||
+        header->size > fileSize / sizeof(uint64_t) ||
+        header->noOfElems > fileSize / sizeof(HashTableSnapshotEntry) ||
+        header->bucketsOffset != sizeof(*header) ||
+        header->entriesOffset != header->bucketsOffset + (header->size + 1) * sizeof(uint64_t) ||
+        header->stringsOffset != header->entriesOffset + header->noOfElems * sizeof(HashTableSnapshotEntry) ||
+        header->stringsOffset + header->stringsSize != fileSize)
+    {
+        return 0;
+    }
+
+    const char* strings = (const char*)header + header->stringsOffset;
+    return header->noOfElems == 0 || (header->stringsSize > 0 && strings[header->stringsSize - 1] == '\0');
+}
@@ -0,0 +1,125 @@
+#include <nodelist_module/unrolledlist.h>
+#include <stdlib.h>
+
+UnrolledList* unrolledList_new(void* data)
+{
+    if (data == NULL)
+    {
+        return NULL;
+    }
+
+    UnrolledList* head = malloc(sizeof(*head));
+    if (head == NULL)
+    {
+        return NULL;
+    }
+
+    head->next = NULL;
+    head->count = 1;
+    head->data[0] = data;
+
+    return head;
+}
+
+// as for NodeList, data stored in the list are not freed
+void unrolledList_delete(UnrolledList** head)
+{
+    if (*head == NULL)
+    {
+        return;
+    }
+
+    UnrolledList* current = *head;
+    UnrolledList* next = NULL;
+
+    while (current != NULL)
+    {
+        next = current->next;
+        free(current);
+        current = next;
+    }
+
+    *head = NULL;
+}
+
+// same contract as nodeList_insert: the list has to exist, new element is placed to the head node
+void unrolledList_insert(UnrolledList** restrict head, void* restrict data)
+{
+    if (*head == NULL || data == NULL)
+    {
+        return;
+    }
+
+    // free slot in the head node, no allocation needed
+    if ((*head)->count < UNROLLED_LIST_NODE_CAPACITY)
+    {
+        (*head)->data[(*head)->count++] = data;
+        return;
+    }
+
+    // head node is full, new node becomes the head
+    UnrolledList* newNode = unrolledList_new(data);
+    if (newNode == NULL)
+    {
+        return;
+    }
+
+    newNode->next = *head;
+    *head = newNode;
+}
+
+// the hole is filled by the last element of the head node, so all nodes except the head stay full
+void unrolledList_node_delete(UnrolledList** restrict head, void* restrict data)
+{
+    if (*head == NULL || data == NULL)
+    {
+        return;
+    }
+
+    UnrolledList* currentNode = *head;
+    size_t slot = 0;
+
+    // Define searched node as a currentNode and the slot of data within it
+    while (currentNode != NULL)
+    {
+        slot = 0;
+        while (slot < currentNode->count && currentNode->data[slot] != data)
+        {
+            slot++;
+        }
+
+        if (slot < currentNode->count)
+        {
+            break;
+        }
+        currentNode = currentNode->next;
+    }
+
+    // Can't find that element
+    if (currentNode == NULL)
+    {
+        return;
+    }
+
+    UnrolledList* first = *head;
+    currentNode->data[slot] = first->data[--first->count];
+
+    // Head node became empty, the next (full) node is the new head
+    if (first->count == 0)
+    {
+        *head = first->next;
+        free(first);
+    }
+}
+
+size_t unrolledList_size(const UnrolledList* head)
+{
+    size_t size = 0;
+
+    for (const UnrolledList* node = head; node != NULL; node = node->next)
+    {
+        size += node->count;
+    }
+
+    return size;
+}
@@ -1,13 +1,28 @@
 extern void hashtable_record_new_test(void);
 extern void hashtable_new_test(void);
+extern void hashtable_new_from_arrays_test(void);
+extern void hashtable_bloom_enable_test(void);
+extern void hashtable_insert_owned_test(void);
+extern void hashtable_insert_ttl_test(void);
+extern void hashtable_merge_test(void);
 extern void nodeList_new_test(void);
+extern void unrolledList_insert_test(void);
+extern void hashtable_radix_set_test(void);
 
 int main(void)
 {
     hashtable_record_new_test();
     hashtable_new_test();
+    hashtable_new_from_arrays_test();
+    hashtable_bloom_enable_test();
+    hashtable_insert_owned_test();
+    hashtable_insert_ttl_test();
+    hashtable_merge_test();
 
     nodeList_new_test();
+    unrolledList_insert_test();
+
+    hashtable_radix_set_test();
 
     return 0;
 }
\ No newline at end of file
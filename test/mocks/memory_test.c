@@ -4,7 +4,14 @@
 
 void hashtable_record_new_test(void);
 void hashtable_new_test(void);
+void hashtable_new_from_arrays_test(void);
+void hashtable_bloom_enable_test(void);
+void hashtable_insert_owned_test(void);
+void hashtable_insert_ttl_test(void);
+void hashtable_merge_test(void);
 void nodeList_new_test(void);
+void unrolledList_insert_test(void);
+void hashtable_radix_set_test(void);
 
 static struct
 {
@@ -37,6 +44,8 @@ static inline void* mock_calloc(size_t nmemb, size_t size)
 
 #include <hashtable.c>
 #include <nodelist.c>
+#include <unrolledlist.c>
+#include <hashtable_radix.c>
 
 
 // Test function: Record* record_new(const char* key, const char* value);
@@ -79,6 +88,147 @@ void hashtable_new_test(void)
     }
 }
 
+// Test function: HashTable* hashTable_new_from_arrays(const char* const* keys, const char* const* values, size_t count, size_t threads);
+void hashtable_new_from_arrays_test(void)
+{
+    const char* keys[] = {"keyOne", "keyTwo", "keyThr"};
+    const char* values[] = {"valOne", "valTwo", "valThr"};
+
+    // Correct arguments, check behaviour when malloc fails
+    {
+        mock_params.malloc_null = true;
+        mock_params.calloc_null = false;
+        HashTable* hashTable = hashTable_new_from_arrays(keys, values, 3, 2);
+
+        assert(hashTable == NULL);
+    }
+
+    // Correct arguments, check behaviour when calloc fails
+    {
+        mock_params.malloc_null = false;
+        mock_params.calloc_null = true;
+        HashTable* hashTable = hashTable_new_from_arrays(keys, values, 3, 2);
+
+        assert(hashTable == NULL);
+    }
+}
+
+// Test function: int hashTable_bloom_enable(HashTable* hashTable, size_t bitsPerKey, int mode);
+void hashtable_bloom_enable_test(void)
+{
+    // Correct arguments, check behaviour when calloc of the filter fails, previous filter should stay
+    {
+        mock_params.malloc_null = false;
+        mock_params.calloc_null = false;
+        HashTable* hashTable = hashTable_new(5);
+        hashTable_insert(hashTable, "keyOne", "valOne");
+        assert(hashTable_bloom_enable(hashTable, 0, HASHTABLE_BLOOM_PLAIN) == 0);
+        HashTableBloom* bloom = hashTable->bloom;
+
+        mock_params.calloc_null = true;
+        assert(hashTable_bloom_enable(hashTable, 0, HASHTABLE_BLOOM_COUNTING) == -1);
+        assert(hashTable->bloom == bloom);
+        assert(hashTable_search(hashTable, "keyOne") != NULL);
+
+        mock_params.calloc_null = false;
+        hashTable_delete(hashTable);
+    }
+}
+
+// Test function: int hashTable_insert_owned(HashTable* hashTable, char* key, char* value);
+void hashtable_insert_owned_test(void)
+{
+    // Record allocation fails, the buffers stay with the caller
+    {
+        mock_params.malloc_null = false;
+        mock_params.calloc_null = false;
+        HashTable* hashTable = hashTable_new(6);
+        char* key = malloc(8);
+        char* val = malloc(8);
+        assert(key != NULL && val != NULL);
+        strcpy(key, "keyOne");
+        strcpy(val, "valOne");
+
+        mock_params.malloc_null = true;
+        assert(hashTable_insert_owned(hashTable, key, val) == -1);
+        assert(hashTable->noOfElems == 0);
+
+        mock_params.malloc_null = false;
+        assert(hashTable_insert_owned(hashTable, key, val) == 0);
+        assert(hashTable_search(hashTable, "keyOne") == val);
+
+        hashTable_delete(hashTable);
+    }
+}
+
+// Test function: void hashTable_insert_ttl(HashTable* hashTable, const char* key, const char* value, uint64_t ttl);
+void hashtable_insert_ttl_test(void)
+{
+    // Timer allocation fails, nothing is inserted
+    {
+        mock_params.malloc_null = false;
+        mock_params.calloc_null = false;
+        HashTable* hashTable = hashTable_new(5);
+
+        mock_params.malloc_null = true;
+        hashTable_insert_ttl(hashTable, "keyOne", "valOne", 5);
+        mock_params.malloc_null = false;
+        assert(hashTable->noOfElems == 0);
+        assert(hashTable->wheel == NULL);
+
+        hashTable_delete(hashTable);
+    }
+
+    // Wheel allocation fails, the inserted record is deleted again
+    {
+        mock_params.malloc_null = false;
+        mock_params.calloc_null = false;
+        HashTable* hashTable = hashTable_new(5);
+        hashTable_insert(hashTable, "keyTwo", "valTwo");
+
+        mock_params.calloc_null = true;
+        hashTable_insert_ttl(hashTable, "keyOne", "valOne", 5);
+        mock_params.calloc_null = false;
+        assert(hashTable->noOfElems == 1);
+        assert(hashTable_search(hashTable, "keyOne") == NULL);
+        assert(hashTable_search(hashTable, "keyTwo") != NULL);
+        assert(hashTable->wheel == NULL);
+
+        hashTable_delete(hashTable);
+    }
+}
+
+// Test function: int hashTable_merge(HashTable* destination, const HashTable* const* sources, size_t count,
+//                                    HashTableCombineCallback combine, void* context, size_t threads);
+void hashtable_merge_test(void)
+{
+    // New records can't be allocated, present keys are still updated and jobs run on the calling thread
+    {
+        mock_params.malloc_null = false;
+        mock_params.calloc_null = false;
+        HashTable* source = hashTable_new(8);
+        HashTable* ht = hashTable_new(8);
+        hashTable_insert(source, "present", "new");
+        hashTable_insert(source, "absent", "value");
+        hashTable_insert(ht, "present", "old");
+
+        mock_params.malloc_null = true;
+        assert(hashTable_merge(ht, (const HashTable* const*)&source, 1, NULL, NULL, 4) == -1);
+        assert(ht->noOfElems == 1);
+        assert(strcmp(hashTable_search(ht, "present"), "new") == 0);
+        assert(hashTable_search(ht, "absent") == NULL);
+
+        mock_params.malloc_null = false;
+        assert(hashTable_merge(ht, (const HashTable* const*)&source, 1, NULL, NULL, 4) == 0);
+        assert(ht->noOfElems == 2);
+
+        mock_params.malloc_null = true;
+        hashTable_delete_parallel(source, 4);
+        hashTable_delete_parallel(ht, 4);
+        mock_params.malloc_null = false;
+    }
+}
+
 // Test function: NodeList* nodeList_new(void* data); 
 void nodeList_new_test(void)
 {
@@ -94,4 +244,63 @@ void nodeList_new_test(void)
         
         record_delete(record);
     }
-}
\ No newline at end of file
+}
+
+// Test function: void unrolledList_insert(UnrolledList** head, void* data);
+void unrolledList_insert_test(void)
+{
+    // Check behaviour when malloc fails, only a full head node needs a new node
+    {
+        mock_params.malloc_null = true;
+        mock_params.calloc_null = false;
+        int values[UNROLLED_LIST_NODE_CAPACITY + 1];
+
+        assert(unrolledList_new(&values[0]) == NULL);
+
+        mock_params.malloc_null = false;
+        UnrolledList* head = unrolledList_new(&values[0]);
+        mock_params.malloc_null = true;
+        for (size_t i = 1; i < UNROLLED_LIST_NODE_CAPACITY; ++i)
+        {
+            unrolledList_insert(&head, &values[i]);
+        }
+        assert(head->count == UNROLLED_LIST_NODE_CAPACITY);
+
+        UnrolledList* head_cpy = head;
+        unrolledList_insert(&head, &values[UNROLLED_LIST_NODE_CAPACITY]);
+        assert(head == head_cpy);
+        assert(unrolledList_size(head) == UNROLLED_LIST_NODE_CAPACITY);
+
+        mock_params.malloc_null = false;
+        unrolledList_delete(&head);
+    }
+}
+
+// Test function: int hashTableRadix_set(HashTableRadix* tree, const char* category, int level);
+void hashtable_radix_set_test(void)
+{
+    // Node allocation fails while a label is split, the tree and its handles are unchanged
+    {
+        mock_params.malloc_null = true;
+        mock_params.calloc_null = false;
+        assert(hashTableRadix_new(0) == NULL);
+
+        mock_params.malloc_null = false;
+        HashTableRadix* tree = hashTableRadix_new(0);
+        const HashTableRadixNode* client = hashTableRadix_get(tree, "net.http.client");
+        assert(client != NULL);
+
+        mock_params.malloc_null = true;
+        assert(hashTableRadix_set(tree, "net.http", 2) == -1);
+        assert(hashTableRadix_get(tree, "net.dns") == NULL);
+        assert(tree->noOfNodes == 2);
+        assert(strcmp(client->label, "net.http.client") == 0);
+        assert(client->level == 0);
+
+        mock_params.malloc_null = false;
+        assert(hashTableRadix_set(tree, "net.http", 2) == 0);
+        assert(client->level == 2);
+
+        hashTableRadix_delete(tree);
+    }
+}
@@ -0,0 +1,249 @@
+#include <hashtable_cuckoo.c>
+#include <hashtable.c>
+#include <nodelist.c>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void hashtable_cuckoo_test(void);
+
+static void cuckoo_check(const HashTableCuckoo* hashTable);
+
+// Test functions: HashTableCuckoo* hashTableCuckoo_new(size_t size);
+//                 int hashTableCuckoo_insert(HashTableCuckoo* hashTable, const char* key, const char* value);
+//                 void hashTableCuckoo_delete_record(HashTableCuckoo* hashTable, const char* key);
+//                 const char* hashTableCuckoo_search(const HashTableCuckoo* hashTable, const char* key);
+//                 int cuckoo_insert_record(HashTableCuckoo* hashTable, Record* record, uint64_t hash);
+void hashtable_cuckoo_test(void)
+{
+    // Incorrect arguments
+    {
+        HashTableCuckoo* ht = hashTableCuckoo_new(0);
+        assert(ht != NULL);
+        assert(ht->noOfBuckets == 2);
+
+        assert(hashTableCuckoo_insert(NULL, "key", "value") == -1);
+        assert(hashTableCuckoo_insert(ht, NULL, "value") == -1);
+        assert(hashTableCuckoo_insert(ht, "key", NULL) == -1);
+        assert(hashTableCuckoo_search(NULL, "key") == NULL);
+        assert(hashTableCuckoo_search(ht, NULL) == NULL);
+        hashTableCuckoo_delete_record(NULL, "key");
+        hashTableCuckoo_delete_record(ht, NULL);
+        hashTableCuckoo_delete(NULL);
+        assert(ht->noOfElems == 0);
+
+        hashTableCuckoo_delete(ht);
+    }
+
+    // Insert, update, search and delete
+    {
+        HashTableCuckoo* ht = hashTableCuckoo_new(3);
+        const size_t buckets = ht->noOfBuckets;
+
+        assert(hashTableCuckoo_insert(ht, "keyOne", "valueOne") == 0);
+        assert(hashTableCuckoo_insert(ht, "keyTwo", "valueTwo") == 0);
+        assert(hashTableCuckoo_insert(ht, "keyThr", "valueThr") == 0);
+        assert(ht->noOfElems == 3);
+        assert(ht->noOfBuckets == buckets);
+        cuckoo_check(ht);
+
+        assert(strcmp(hashTableCuckoo_search(ht, "keyOne"), "valueOne") == 0);
+        assert(strcmp(hashTableCuckoo_search(ht, "keyTwo"), "valueTwo") == 0);
+        assert(strcmp(hashTableCuckoo_search(ht, "keyThr"), "valueThr") == 0);
+        assert(hashTableCuckoo_search(ht, "keyFou") == NULL);
+
+        // Present key keeps the number of records, only the value changes
+        assert(hashTableCuckoo_insert(ht, "keyTwo", "valueTwoUpdated") == 0);
+        assert(ht->noOfElems == 3);
+        assert(strcmp(hashTableCuckoo_search(ht, "keyTwo"), "valueTwoUpdated") == 0);
+
+        hashTableCuckoo_delete_record(ht, "keyTwo");
+        hashTableCuckoo_delete_record(ht, "keyFou");
+        assert(ht->noOfElems == 2);
+        assert(hashTableCuckoo_search(ht, "keyTwo") == NULL);
+        assert(strcmp(hashTableCuckoo_search(ht, "keyOne"), "valueOne") == 0);
+        cuckoo_check(ht);
+
+        hashTableCuckoo_delete(ht);
+    }
+
+    // Table grows from the smallest size, every key stays in one of its buckets or in the stash
+    {
+        HashTableCuckoo* ht = hashTableCuckoo_new(0);
+        char key[32];
+        char value[32];
+
+        for (size_t i = 0; i < 5000; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            snprintf(value, sizeof(value), "value%zu", i);
+            assert(hashTableCuckoo_insert(ht, key, value) == 0);
+        }
+
+        assert(ht->noOfElems == 5000);
+        assert(ht->noOfElems * 100 <= ht->noOfBuckets * HASHTABLE_CUCKOO_SLOTS * HASHTABLE_CUCKOO_LOAD_PERCENT);
+        cuckoo_check(ht);
+
+        for (size_t i = 0; i < 5000; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            snprintf(value, sizeof(value), "value%zu", i);
+            assert(strcmp(hashTableCuckoo_search(ht, key), value) == 0);
+        }
+
+        // Delete every second key, the rest has to be still found
+        for (size_t i = 0; i < 5000; i += 2)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            hashTableCuckoo_delete_record(ht, key);
+        }
+
+        assert(ht->noOfElems == 2500);
+        cuckoo_check(ht);
+
+        for (size_t i = 0; i < 5000; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            assert((hashTableCuckoo_search(ht, key) != NULL) == (i % 2 == 1));
+        }
+
+        hashTableCuckoo_delete(ht);
+    }
+
+    // Anagrams of the same letters, keys differing only in the byte order
+    {
+        HashTableCuckoo* ht = hashTableCuckoo_new(16);
+        char key[] = "abcdef";
+        size_t inserted = 0;
+
+        for (size_t i = 0; i < 720; ++i)
+        {
+            // i-th permutation of the letters in factorial number system
+            char letters[] = "abcdef";
+            size_t rest = i;
+            for (size_t pos = 0; pos < 6; ++pos)
+            {
+                size_t factorial = 1;
+                for (size_t f = 2; f < 6 - pos; ++f)
+                {
+                    factorial *= f;
+                }
+
+                const size_t chosen = rest / factorial;
+                rest %= factorial;
+                key[pos] = letters[chosen];
+                memmove(&letters[chosen], &letters[chosen + 1], 6 - chosen - pos);
+            }
+
+            assert(hashTableCuckoo_insert(ht, key, key) == 0);
+            inserted++;
+            assert(strcmp(hashTableCuckoo_search(ht, key), key) == 0);
+        }
+
+        assert(ht->noOfElems == inserted);
+        assert(strcmp(hashTableCuckoo_search(ht, "fedcba"), "fedcba") == 0);
+        cuckoo_check(ht);
+
+        hashTableCuckoo_delete(ht);
+    }
+
+    // Keys living only in buckets 0 and 1 of tables up to 16 buckets: after 8 slots and the whole stash
+    // are taken, growing to 16 buckets fills the stash again and the table has to grow once more
+    {
+        HashTableCuckoo* ht = hashTableCuckoo_new(16);
+        assert(ht->noOfBuckets == 8);
+        char keys[17][16];
+        size_t found = 0;
+
+        for (size_t i = 0; found < 17; ++i)
+        {
+            snprintf(keys[found], sizeof(keys[found]), "stash%zu", i);
+            const uint64_t hash = hashTableTyped_hash_str(keys[found]);
+            const size_t first = (size_t)hash & 15;
+            const size_t second = (size_t)(hash >> 32) & 15;
+            found += first < 2 && second < 2 && first != second;
+        }
+
+        for (size_t k = 0; k < 17; ++k)
+        {
+            assert(hashTableCuckoo_insert(ht, keys[k], keys[k]) == 0);
+            assert(ht->noOfBuckets > 8 || ht->stashCount == (k < 8 ? 0 : k - 7));
+        }
+
+        assert(ht->noOfBuckets > 16);
+        assert(ht->noOfElems == 17);
+        for (size_t k = 0; k < 17; ++k)
+        {
+            assert(strcmp(hashTableCuckoo_search(ht, keys[k]), keys[k]) == 0);
+        }
+        cuckoo_check(ht);
+
+        hashTableCuckoo_delete(ht);
+    }
+
+    // Records of one full hash share two buckets at every size: 2 buckets and the stash take 16 of them,
+    // the next one fails after HASHTABLE_CUCKOO_MAX_GROWS doublings instead of growing forever
+    {
+        HashTableCuckoo* ht = hashTableCuckoo_new(0);
+        const uint64_t hash = 0x0123456789ABCDEFu;
+        const size_t fit = 2 * HASHTABLE_CUCKOO_SLOTS + HASHTABLE_CUCKOO_STASH;
+        char key[16];
+
+        for (size_t k = 0; k < fit; ++k)
+        {
+            snprintf(key, sizeof(key), "same%zu", k);
+            assert(cuckoo_insert_record(ht, record_new(key, key), hash) == 0);
+        }
+        assert(ht->stashCount == HASHTABLE_CUCKOO_STASH);
+        const size_t buckets = ht->noOfBuckets;
+
+        Record* extra = record_new("extra", "extra");
+        assert(cuckoo_insert_record(ht, extra, hash) == -1);
+        record_delete(extra);
+
+        assert(ht->noOfElems == fit);
+        assert(ht->noOfBuckets <= buckets << HASHTABLE_CUCKOO_MAX_GROWS);
+        for (size_t k = 0; k < fit; ++k)
+        {
+            snprintf(key, sizeof(key), "same%zu", k);
+            assert(cuckoo_find(ht, key, hash) != NULL);
+        }
+        assert(cuckoo_find(ht, "extra", hash) == NULL);
+
+        hashTableCuckoo_delete(ht);
+    }
+}
+
+// every record is in one of its two buckets or in the stash and is counted
+static void cuckoo_check(const HashTableCuckoo* hashTable)
+{
+    size_t count = 0;
+
+    assert(hashTable->stashCount <= HASHTABLE_CUCKOO_STASH);
+    assert(((uintptr_t)hashTable->buckets % 64) == 0);
+
+    for (size_t b = 0; b < hashTable->noOfBuckets; ++b)
+    {
+        for (size_t s = 0; s < HASHTABLE_CUCKOO_SLOTS; ++s)
+        {
+            const Record* record = hashTable->buckets[b].records[s];
+            if (record == NULL)
+            {
+                continue;
+            }
+
+            const uint64_t hash = hashTableTyped_hash_str(record_key(record));
+            assert(hashTable->buckets[b].hashes[s] == hash);
+            assert(cuckoo_first(hash, hashTable->noOfBuckets) == b || cuckoo_second(hash, hashTable->noOfBuckets) == b);
+            count++;
+        }
+    }
+
+    for (size_t i = 0; i < hashTable->stashCount; ++i)
+    {
+        assert(hashTable->stashHashes[i] == hashTableTyped_hash_str(record_key(hashTable->stash[i])));
+        count++;
+    }
+
+    assert(count == hashTable->noOfElems);
+}
@@ -0,0 +1,137 @@
+#include <hashtable_export.c>
+#include <hashtable.c>
+#include <nodelist.c>
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+
+void hashtable_export_test(void);
+
+static char* read_file(const char* path, size_t* length);
+
+// Test functions: int hashTable_export_fd(const HashTable* hashTable, int fd, int format, char* buffer, size_t capacity);
+//                 char* hashTable_export_string(const HashTable* hashTable, int format, size_t* length);
+void hashtable_export_test(void)
+{
+    register const char* path = "hashtable_export_test.txt";
+
+    // Incorrect arguments
+    {
+        HashTable* ht = hashTable_new(5);
+        char buffer[16];
+
+        assert(hashTable_export_fd(NULL, 1, HASHTABLE_EXPORT_TEXT, NULL, 0) == -1);
+        assert(hashTable_export_fd(ht, -1, HASHTABLE_EXPORT_TEXT, NULL, 0) == -1);
+        assert(hashTable_export_fd(ht, 1, HASHTABLE_EXPORT_TEXT, buffer, 0) == -1);
+        assert(hashTable_export_fd(ht, 1, 42, NULL, 0) == -1);
+        assert(hashTable_export_string(NULL, HASHTABLE_EXPORT_TEXT, NULL) == NULL);
+        assert(hashTable_export_string(ht, 42, NULL) == NULL);
+
+        hashTable_delete(ht);
+    }
+
+    // Empty table gives empty output
+    {
+        HashTable* ht = hashTable_new(5);
+        size_t length = 1;
+        char* out = hashTable_export_string(ht, HASHTABLE_EXPORT_JSONL, &length);
+
+        assert(out != NULL);
+        assert(length == 0);
+        assert(out[0] == '\0');
+
+        free(out);
+        hashTable_delete(ht);
+    }
+
+    // Line of every format, special characters escaped
+    {
+        HashTable* ht = hashTable_new(5);
+        hashTable_insert(ht, "a\tb", "q\"\\\n\x01");
+
+        char* text = hashTable_export_string(ht, HASHTABLE_EXPORT_TEXT, NULL);
+        char* tsv = hashTable_export_string(ht, HASHTABLE_EXPORT_TSV, NULL);
+        char* json = hashTable_export_string(ht, HASHTABLE_EXPORT_JSONL, NULL);
+
+        assert(strcmp(text, "Key: a\tb, Value: q\"\\\n\x01\n") == 0);
+        assert(strcmp(tsv, "a\\tb\tq\"\\\\\\n\x01\n") == 0);
+        assert(strcmp(json, "{\"key\":\"a\\tb\",\"value\":\"q\\\"\\\\\\n\\u0001\"}\n") == 0);
+
+        free(text);
+        free(tsv);
+        free(json);
+        hashTable_delete(ht);
+    }
+
+    // Expired records are left out
+    {
+        HashTable* ht = hashTable_new(5);
+        hashTable_insert(ht, "keyOne", "valueOne");
+        hashTable_insert_ttl(ht, "keyTwo", "valueTwo", 5);
+        hashTable_expire(ht, 10, 0);
+
+        char* tsv = hashTable_export_string(ht, HASHTABLE_EXPORT_TSV, NULL);
+        assert(strcmp(tsv, "keyOne\tvalueOne\n") == 0);
+
+        free(tsv);
+        hashTable_delete(ht);
+    }
+
+    // Many records written to a file through small, default and big blocks, all equal to the string output
+    {
+        HashTable* ht = hashTable_new(3000);
+        char key[32];
+        char value[128];
+        for (size_t i = 0; i < 3000; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            snprintf(value, sizeof(value), "%zu a value long enough to be longer than the small block %zu", i, i);
+            hashTable_insert(ht, key, value);
+        }
+
+        size_t expectedLength = 0;
+        char* expected = hashTable_export_string(ht, HASHTABLE_EXPORT_JSONL, &expectedLength);
+        assert(expected != NULL);
+        assert(expectedLength > HASHTABLE_EXPORT_BLOCK);
+
+        const size_t capacities[] = {16, 0, 1 << 20};
+        for (size_t c = 0; c < sizeof(capacities) / sizeof(*capacities); ++c)
+        {
+            char* buffer = capacities[c] > 0 ? malloc(capacities[c]) : NULL;
+            const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            assert(fd >= 0);
+            assert(hashTable_export_fd(ht, fd, HASHTABLE_EXPORT_JSONL, buffer, capacities[c]) == 0);
+            close(fd);
+
+            size_t length = 0;
+            char* written = read_file(path, &length);
+            assert(length == expectedLength);
+            assert(memcmp(written, expected, length) == 0);
+
+            free(written);
+            free(buffer);
+        }
+
+        remove(path);
+        free(expected);
+        hashTable_delete(ht);
+    }
+}
+
+static char* read_file(const char* path, size_t* length)
+{
+    FILE* file = fopen(path, "rb");
+    assert(file != NULL);
+
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* data = malloc((size_t)size + 1);
+    assert(data != NULL);
+    *length = fread(data, 1, (size_t)size, file);
+    fclose(file);
+
+    return data;
+}
@@ -0,0 +1,105 @@
+#include <hashtable_frozen.c>
+#include <hashtable.c>
+#include <nodelist.c>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void hashtable_freeze_test(void);
+
+// Test functions: HashTableFrozen* hashTable_freeze(const HashTable* hashTable);
+//                 const char* hashTableFrozen_search(const HashTableFrozen* frozen, const char* key);
+//                 int place_buckets(HashTableFrozen* frozen, const uint64_t* hashes, size_t* slotOf);
+void hashtable_freeze_test(void)
+{
+    // Incorrect arguments
+    {
+        assert(hashTable_freeze(NULL) == NULL);
+        assert(hashTableFrozen_search(NULL, "key") == NULL);
+        hashTableFrozen_delete(NULL);
+    }
+
+    // Empty table, every search should miss
+    {
+        HashTable* ht = hashTable_new(5);
+        HashTableFrozen* frozen = hashTable_freeze(ht);
+        hashTable_delete(ht);
+
+        assert(frozen != NULL);
+        assert(frozen->size == 0);
+        assert(hashTableFrozen_search(frozen, "keyOne") == NULL);
+
+        hashTableFrozen_delete(frozen);
+    }
+
+    // Colliding keys, frozen table should not depend on the source one
+    {
+        HashTable* ht = hashTable_new(3);
+        hashTable_insert(ht, "keyOne", "valOne");
+        hashTable_insert(ht, "keyTwo", "valTwo");
+        hashTable_insert(ht, "keyThr", "valThr");
+
+        HashTableFrozen* frozen = hashTable_freeze(ht);
+        hashTable_delete(ht);
+
+        assert(frozen != NULL);
+        assert(frozen->size == 3);
+        assert(strcmp(hashTableFrozen_search(frozen, "keyOne"), "valOne") == 0);
+        assert(strcmp(hashTableFrozen_search(frozen, "keyTwo"), "valTwo") == 0);
+        assert(strcmp(hashTableFrozen_search(frozen, "keyThr"), "valThr") == 0);
+        assert(hashTableFrozen_search(frozen, "keyFour") == NULL);
+        assert(hashTableFrozen_search(frozen, NULL) == NULL);
+
+        hashTableFrozen_delete(frozen);
+    }
+
+    // Many keys in as many slots (minimal perfect hash), every one should be found
+    {
+        register const size_t count = 5000;
+        char (*keys)[16] = malloc(count * sizeof(*keys));
+        HashTable* ht = hashTable_new(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            snprintf(keys[i], sizeof(keys[i]), "key%zu", i);
+            hashTable_insert(ht, keys[i], keys[i]);
+        }
+
+        HashTableFrozen* frozen = hashTable_freeze(ht);
+        hashTable_delete(ht);
+
+        assert(frozen != NULL);
+        assert(frozen->size == count);
+        assert(frozen->noOfBuckets < count / 2);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const char* value = hashTableFrozen_search(frozen, keys[i]);
+            assert(value != NULL && strcmp(value, keys[i]) == 0);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            char missing[16];
+            snprintf(missing, sizeof(missing), "miss%zu", i);
+            assert(hashTableFrozen_search(frozen, missing) == NULL);
+        }
+
+        hashTableFrozen_delete(frozen);
+        free(keys);
+    }
+
+    // Two keys of equal 64-bit hash share one slot under every seed, placement fails without trying them all
+    {
+        uint64_t hashes[] = {1, 2, 3, 42, 42, 5};
+        size_t slotOf[6];
+        HashTableFrozen frozen = {6, 1, NULL, NULL};
+        uint32_t seed = 0;
+        frozen.seeds = &seed;
+
+        assert(place_buckets(&frozen, hashes, slotOf) == -1);
+
+        hashes[4] = 4;
+        assert(place_buckets(&frozen, hashes, slotOf) == 0);
+    }
+}
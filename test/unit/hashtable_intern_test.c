@@ -0,0 +1,176 @@
+#include <hashtable_intern.c>
+#include <hashtable.c>
+#include <nodelist.c>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void hashtable_intern_test(void);
+
+static void* intern_worker(void* arg);
+
+// Strings interned by every worker thread
+#define INTERN_TEST_STRINGS 2000
+
+typedef struct InternWork
+{
+    HashTableInternPool* pool;
+    const char* canonical[INTERN_TEST_STRINGS];
+} InternWork;
+
+// Test functions: HashTableInternPool* hashTableIntern_new(size_t size, int threadSafe);
+//                 const char* hashTableIntern_get(HashTableInternPool* pool, const char* str);
+//                 const char* hashTableIntern_find(HashTableInternPool* pool, const char* str);
+//                 HashTableInternPool* hashTableIntern_global(void);
+void hashtable_intern_test(void)
+{
+    // Incorrect arguments
+    {
+        HashTableInternPool* pool = hashTableIntern_new(0, 0);
+        assert(pool != NULL);
+
+        assert(hashTableIntern_get(NULL, "str") == NULL);
+        assert(hashTableIntern_get(pool, NULL) == NULL);
+        assert(hashTableIntern_find(NULL, "str") == NULL);
+        assert(hashTableIntern_find(pool, NULL) == NULL);
+        hashTableIntern_delete(NULL);
+
+        hashTableIntern_delete(pool);
+    }
+
+    // Equal strings share one canonical copy
+    {
+        HashTableInternPool* pool = hashTableIntern_new(4, 0);
+        char first[] = "net.http.client";
+        char second[] = "net.http.client";
+
+        assert(hashTableIntern_find(pool, first) == NULL);
+        const char* canonical = hashTableIntern_get(pool, first);
+        assert(canonical != NULL);
+        assert(canonical != first);
+        assert(strcmp(canonical, first) == 0);
+
+        assert(hashTableIntern_get(pool, second) == canonical);
+        assert(hashTableIntern_find(pool, second) == canonical);
+        assert(hashTableIntern_get(pool, canonical) == canonical);
+
+        const char* other = hashTableIntern_get(pool, "net.http");
+        assert(other != canonical);
+        assert(hashTableIntern_get(pool, "") != NULL);
+        assert(pool->noOfStrings == 3);
+        assert(pool->bytes == sizeof(first) + sizeof("net.http") + 1);
+
+        // Canonical copy doesn't depend on the buffer it was interned from
+        first[0] = 'X';
+        assert(strcmp(canonical, "net.http.client") == 0);
+
+        hashTableIntern_delete(pool);
+    }
+
+    // Many strings and strings longer than a chunk, the set grows and old pointers stay valid
+    {
+        HashTableInternPool* pool = hashTableIntern_new(0, 0);
+        const char* canonical[5000];
+        char str[32];
+
+        char* longStr = malloc(HASHTABLE_INTERN_CHUNK + 100);
+        memset(longStr, 'x', HASHTABLE_INTERN_CHUNK + 99);
+        longStr[HASHTABLE_INTERN_CHUNK + 99] = '\0';
+
+        for (size_t i = 0; i < 5000; ++i)
+        {
+            snprintf(str, sizeof(str), "category.%zu", i);
+            canonical[i] = hashTableIntern_get(pool, str);
+            if (i == 10)
+            {
+                const char* longCanonical = hashTableIntern_get(pool, longStr);
+                assert(strcmp(longCanonical, longStr) == 0);
+                assert(hashTableIntern_get(pool, longStr) == longCanonical);
+            }
+        }
+
+        assert(pool->noOfStrings == 5001);
+        for (size_t i = 0; i < 5000; ++i)
+        {
+            snprintf(str, sizeof(str), "category.%zu", i);
+            assert(hashTableIntern_find(pool, str) == canonical[i]);
+            assert(strcmp(canonical[i], str) == 0);
+        }
+
+        free(longStr);
+        hashTableIntern_delete(pool);
+    }
+
+    // Canonical strings shared by tables without copies, found by pointer or by equal string
+    {
+        HashTableInternPool* pool = hashTableIntern_new(16, 0);
+        HashTable* first = hashTable_new(8);
+        HashTable* second = hashTable_new(8);
+        const char* key = hashTableIntern_get(pool, "a.category.name.longer.than.inline");
+        const char* value = hashTableIntern_get(pool, "INFO");
+
+        assert(hashTable_insert_borrowed(first, key, value) == 0);
+        assert(hashTable_insert_borrowed(second, key, value) == 0);
+
+        assert(hashTable_search(first, key) == value);
+        assert(hashTable_search(second, key) == value);
+        assert(hashTable_search(first, "a.category.name.longer.than.inline") == value);
+
+        hashTable_delete(first);
+        hashTable_delete(second);
+        hashTableIntern_delete(pool);
+    }
+
+    // Threads interning the same strings get the same canonical pointers
+    {
+        InternWork* work = malloc(4 * sizeof(*work));
+        pthread_t threads[4];
+        HashTableInternPool* pool = hashTableIntern_new(0, 1);
+
+        for (size_t t = 0; t < 4; ++t)
+        {
+            work[t].pool = pool;
+            assert(pthread_create(&threads[t], NULL, intern_worker, &work[t]) == 0);
+        }
+        for (size_t t = 0; t < 4; ++t)
+        {
+            pthread_join(threads[t], NULL);
+        }
+
+        assert(pool->noOfStrings == INTERN_TEST_STRINGS);
+        for (size_t i = 0; i < INTERN_TEST_STRINGS; ++i)
+        {
+            assert(work[0].canonical[i] != NULL);
+            for (size_t t = 1; t < 4; ++t)
+            {
+                assert(work[t].canonical[i] == work[0].canonical[i]);
+            }
+        }
+
+        hashTableIntern_delete(pool);
+        free(work);
+    }
+
+    // Global pool is created once
+    {
+        HashTableInternPool* pool = hashTableIntern_global();
+        assert(pool != NULL);
+        assert(pool->threadSafe);
+        assert(hashTableIntern_global() == pool);
+        assert(hashTableIntern_get(pool, "global") == hashTableIntern_get(hashTableIntern_global(), "global"));
+    }
+}
+
+static void* intern_worker(void* arg)
+{
+    InternWork* work = arg;
+    char str[32];
+
+    for (size_t i = 0; i < INTERN_TEST_STRINGS; ++i)
+    {
+        snprintf(str, sizeof(str), "field%zu", i);
+        work->canonical[i] = hashTableIntern_get(work->pool, str);
+    }
+
+    return NULL;
+}
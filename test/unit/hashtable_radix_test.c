@@ -0,0 +1,180 @@
+#include <hashtable_radix.c>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void hashtable_radix_test(void);
+
+// Test functions: HashTableRadix* hashTableRadix_new(int defaultLevel);
+//                 const HashTableRadixNode* hashTableRadix_get(HashTableRadix* tree, const char* category);
+//                 int hashTableRadix_resolve(const HashTableRadix* tree, const char* category);
+//                 int hashTableRadix_set(HashTableRadix* tree, const char* category, int level);
+//                 int hashTableRadix_set_subtree(HashTableRadix* tree, const char* category, int level);
+//                 int hashTableRadix_unset(HashTableRadix* tree, const char* category);
+void hashtable_radix_test(void)
+{
+    // Incorrect arguments
+    {
+        HashTableRadix* tree = hashTableRadix_new(3);
+        assert(tree != NULL);
+
+        assert(hashTableRadix_get(NULL, "net") == NULL);
+        assert(hashTableRadix_get(tree, NULL) == NULL);
+        assert(hashTableRadix_get(tree, ".net") == NULL);
+        assert(hashTableRadix_get(tree, "net.") == NULL);
+        assert(hashTableRadix_get(tree, "net..http") == NULL);
+        assert(hashTableRadix_resolve(NULL, "net") == -1);
+        assert(hashTableRadix_resolve(tree, NULL) == -1);
+        assert(hashTableRadix_set(NULL, "net", 1) == -1);
+        assert(hashTableRadix_set(tree, "net.", 1) == -1);
+        assert(hashTableRadix_set_subtree(tree, NULL, 1) == -1);
+        assert(hashTableRadix_unset(tree, "") == -1);
+        assert(hashTableRadix_unset(tree, "..") == -1);
+        hashTableRadix_delete(NULL);
+
+        assert(tree->noOfNodes == 1);
+        assert(hashTableRadix_resolve(tree, "") == 3);
+        hashTableRadix_delete(tree);
+    }
+
+    // Longest prefix match by whole segments
+    {
+        HashTableRadix* tree = hashTableRadix_new(0);
+        assert(hashTableRadix_set(tree, "net", 1) == 0);
+        assert(hashTableRadix_set(tree, "net.http", 2) == 0);
+
+        assert(hashTableRadix_resolve(tree, "net.http.client") == 2);
+        assert(hashTableRadix_resolve(tree, "net.http") == 2);
+        assert(hashTableRadix_resolve(tree, "net.httpx") == 1);
+        assert(hashTableRadix_resolve(tree, "net.ftp.server") == 1);
+        assert(hashTableRadix_resolve(tree, "net") == 1);
+        assert(hashTableRadix_resolve(tree, "ne") == 0);
+        assert(hashTableRadix_resolve(tree, "network") == 0);
+        assert(hashTableRadix_resolve(tree, "db") == 0);
+        assert(tree->noOfConfigured == 3);
+
+        // Default level changed for everything without configured ancestor
+        assert(hashTableRadix_set(tree, "", 7) == 0);
+        assert(hashTableRadix_resolve(tree, "db") == 7);
+        assert(hashTableRadix_resolve(tree, "net.ftp") == 1);
+
+        hashTableRadix_delete(tree);
+    }
+
+    // Path compression, long label is split where categories differ and handles stay valid
+    {
+        HashTableRadix* tree = hashTableRadix_new(0);
+        const HashTableRadixNode* client = hashTableRadix_get(tree, "com.example.net.http.client");
+        assert(client != NULL);
+        assert(tree->noOfNodes == 2);
+        assert(strcmp(client->label, "com.example.net.http.client") == 0);
+        assert(hashTableRadix_get(tree, "com.example.net.http.client") == client);
+
+        const HashTableRadixNode* server = hashTableRadix_get(tree, "com.example.net.http.server");
+        assert(tree->noOfNodes == 4);
+        assert(strcmp(client->label, "client") == 0);
+        assert(strcmp(server->label, "server") == 0);
+        assert(client->parent == server->parent);
+        assert(strcmp(client->parent->label, "com.example.net.http") == 0);
+
+        // Category ending inside a label splits it too
+        const HashTableRadixNode* net = hashTableRadix_get(tree, "com.example.net");
+        assert(tree->noOfNodes == 5);
+        assert(strcmp(net->label, "com.example.net") == 0);
+        assert(strcmp(client->parent->label, "http") == 0);
+        assert(client->parent->parent == net);
+
+        // Differing in the middle of a segment splits at the preceding separator
+        const HashTableRadixNode* netty = hashTableRadix_get(tree, "com.example.netty");
+        assert(strcmp(netty->label, "netty") == 0);
+        assert(strcmp(net->label, "net") == 0);
+        assert(netty->parent == net->parent);
+        assert(strcmp(net->parent->label, "com.example") == 0);
+
+        assert(hashTableRadix_set(tree, "com.example.net", 4) == 0);
+        assert(client->level == 4);
+        assert(server->level == 4);
+        assert(netty->level == 0);
+        assert(hashTableRadix_resolve(tree, "com.example.netty.io") == 0);
+        assert(hashTableRadix_resolve(tree, "com.example.net.http.client.pool") == 4);
+
+        hashTableRadix_delete(tree);
+    }
+
+    // Cached levels of handles follow every reconfiguration
+    {
+        HashTableRadix* tree = hashTableRadix_new(1);
+        const HashTableRadixNode* client = hashTableRadix_get(tree, "net.http.client");
+        const HashTableRadixNode* server = hashTableRadix_get(tree, "net.http.server");
+        const HashTableRadixNode* dns = hashTableRadix_get(tree, "net.dns");
+        assert(client->level == 1);
+        assert(!client->configured);
+
+        assert(hashTableRadix_set(tree, "net", 2) == 0);
+        assert(client->level == 2 && server->level == 2 && dns->level == 2);
+
+        assert(hashTableRadix_set(tree, "net.http.server", 5) == 0);
+        assert(hashTableRadix_set(tree, "net.http", 3) == 0);
+        assert(client->level == 3 && server->level == 5 && dns->level == 2);
+
+        // Descendants configured by themselves keep their levels
+        assert(hashTableRadix_set(tree, "net", 4) == 0);
+        assert(client->level == 3 && server->level == 5 && dns->level == 4);
+
+        assert(hashTableRadix_unset(tree, "net.http") == 0);
+        assert(client->level == 4 && server->level == 5);
+        assert(hashTableRadix_unset(tree, "net.http") == 0);
+        assert(hashTableRadix_unset(tree, "not.in.tree") == 0);
+
+        // Whole subtree reconfigured at once
+        assert(tree->noOfConfigured == 3);
+        assert(hashTableRadix_set_subtree(tree, "net", 6) == 0);
+        assert(client->level == 6 && server->level == 6 && dns->level == 6);
+        assert(!server->configured);
+        assert(tree->noOfConfigured == 2);
+
+        assert(hashTableRadix_unset(tree, "net") == 0);
+        assert(client->level == 1 && server->level == 1 && dns->level == 1);
+        assert(tree->noOfConfigured == 1);
+
+        hashTableRadix_delete(tree);
+    }
+
+    // Many categories, every one resolves to its configured ancestor
+    {
+        HashTableRadix* tree = hashTableRadix_new(0);
+        char category[64];
+
+        for (int a = 0; a < 20; ++a)
+        {
+            for (int b = 0; b < 20; ++b)
+            {
+                for (int c = 0; c < 5; ++c)
+                {
+                    snprintf(category, sizeof(category), "app%d.module%d.class%d", a, b, c);
+                    assert(hashTableRadix_get(tree, category) != NULL);
+                }
+            }
+
+            snprintf(category, sizeof(category), "app%d", a);
+            assert(hashTableRadix_set(tree, category, a) == 0);
+        }
+
+        assert(hashTableRadix_set(tree, "app7.module3", 100) == 0);
+
+        for (int a = 0; a < 20; ++a)
+        {
+            for (int b = 0; b < 20; ++b)
+            {
+                snprintf(category, sizeof(category), "app%d.module%d.class4.method", a, b);
+                assert(hashTableRadix_resolve(tree, category) == (a == 7 && b == 3 ? 100 : a));
+            }
+        }
+
+        hashTableRadix_set_subtree(tree, "", 9);
+        assert(tree->noOfConfigured == 1);
+        assert(hashTableRadix_resolve(tree, "app7.module3.class1") == 9);
+
+        hashTableRadix_delete(tree);
+    }
+}
@@ -0,0 +1,272 @@
+#include <hashtable_rcu.c>
+#include <hashtable.c>
+#include <nodelist.c>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void hashtable_rcu_test(void);
+
+static void* rcu_reader_thread(void* arg);
+
+// Keys of the concurrent test, every published version has the same value for all of them
+#define RCU_TEST_KEYS 64
+#define RCU_TEST_VERSIONS 300
+
+typedef struct RcuReaderWork
+{
+    HashTableRcu* rcu;
+    int stop; // set by the writer when it published all versions
+    size_t sections; // read sections checked by the reader
+} RcuReaderWork;
+
+// Test functions: HashTableRcu* hashTableRcu_new(size_t size);
+//                 const HashTableRcuVersion* hashTableRcu_read_lock(HashTableRcuReader* reader);
+//                 const char* hashTableRcuVersion_search(const HashTableRcuVersion* version, const char* key);
+//                 int hashTableRcu_begin(HashTableRcu* rcu);
+//                 int hashTableRcu_insert(HashTableRcu* rcu, const char* key, const char* value);
+//                 int hashTableRcu_delete_record(HashTableRcu* rcu, const char* key);
+//                 int hashTableRcu_load(HashTableRcu* rcu, const HashTable* hashTable);
+//                 int hashTableRcu_publish(HashTableRcu* rcu);
+//                 void hashTableRcu_abort(HashTableRcu* rcu);
+//                 void hashTableRcu_synchronize(HashTableRcu* rcu);
+void hashtable_rcu_test(void)
+{
+    // Incorrect arguments
+    {
+        HashTableRcu* rcu = hashTableRcu_new(5);
+        assert(rcu != NULL);
+        assert(rcu->current->size == 8);
+
+        assert(hashTableRcu_reader_register(NULL) == NULL);
+        assert(hashTableRcu_read_lock(NULL) == NULL);
+        assert(hashTableRcuVersion_search(NULL, "key") == NULL);
+        assert(hashTableRcu_begin(NULL) == -1);
+        assert(hashTableRcu_insert(rcu, "key", "value") == -1);
+        assert(hashTableRcu_delete_record(rcu, "key") == -1);
+        assert(hashTableRcu_load(rcu, NULL) == -1);
+        assert(hashTableRcu_publish(rcu) == -1);
+        hashTableRcu_abort(rcu);
+        hashTableRcu_read_unlock(NULL);
+        hashTableRcu_reader_unregister(NULL);
+
+        assert(hashTableRcu_begin(rcu) == 0);
+        assert(hashTableRcu_insert(rcu, NULL, "value") == -1);
+        assert(hashTableRcu_insert(rcu, "key", NULL) == -1);
+        assert(hashTableRcu_delete_record(rcu, NULL) == -1);
+        hashTableRcu_abort(rcu);
+
+        hashTableRcu_delete(NULL);
+        hashTableRcu_delete(rcu);
+    }
+
+    // Reader keeps its version until the end of its read section, unchanged buckets are shared
+    {
+        HashTableRcu* rcu = hashTableRcu_new(16);
+        HashTableRcuReader* reader = hashTableRcu_reader_register(rcu);
+
+        assert(hashTableRcu_begin(rcu) == 0);
+        assert(hashTableRcu_insert(rcu, "keyOne", "valueOne") == 0);
+        assert(hashTableRcu_insert(rcu, "keyTwo", "valueTwo") == 0);
+        assert(hashTableRcu_insert(rcu, "keyTwo", "valueTwo") == 0);
+        assert(rcu->draft->noOfElems == 2);
+        for (int i = 0; i < 20; ++i)
+        {
+            char filler[16];
+            snprintf(filler, sizeof(filler), "filler%d", i);
+            assert(hashTableRcu_insert(rcu, filler, filler) == 0);
+        }
+        assert(hashTableRcuVersion_search(rcu->current, "keyOne") == NULL);
+        assert(hashTableRcu_publish(rcu) == 0);
+        assert(rcu->noOfRetired == 0);
+
+        const HashTableRcuVersion* old = hashTableRcu_read_lock(reader);
+        assert(old == rcu->current);
+        assert(strcmp(hashTableRcuVersion_search(old, "keyOne"), "valueOne") == 0);
+
+        assert(hashTableRcu_begin(rcu) == 0);
+        assert(hashTableRcu_insert(rcu, "keyOne", "changed") == 0);
+        assert(hashTableRcu_delete_record(rcu, "keyTwo") == 0);
+        assert(hashTableRcu_delete_record(rcu, "keyThree") == 0);
+        assert(hashTableRcu_insert(rcu, "keyThree", "valueThree") == 0);
+        assert(hashTableRcu_publish(rcu) == 0);
+
+        // Replaced version waits for the reader, which still sees all of it
+        assert(rcu->current != old);
+        assert(rcu->noOfRetired == 1);
+        assert(strcmp(hashTableRcuVersion_search(old, "keyOne"), "valueOne") == 0);
+        assert(strcmp(hashTableRcuVersion_search(old, "keyTwo"), "valueTwo") == 0);
+        assert(hashTableRcuVersion_search(old, "keyThree") == NULL);
+
+        const HashTableRcuVersion* current = rcu->current;
+        assert(current->noOfElems == 22);
+        assert(strcmp(hashTableRcuVersion_search(current, "keyOne"), "changed") == 0);
+        assert(hashTableRcuVersion_search(current, "keyTwo") == NULL);
+        assert(strcmp(hashTableRcuVersion_search(current, "keyThree"), "valueThree") == 0);
+
+        // Buckets without changed keys are the same blocks in both versions
+        size_t shared = 0;
+        for (size_t i = 0; i < current->size; ++i)
+        {
+            const int touched = i == (hashTableTyped_hash_str("keyOne") & 15) || i == (hashTableTyped_hash_str("keyTwo") & 15) ||
+                                i == (hashTableTyped_hash_str("keyThree") & 15);
+            assert(touched || rcu_bucket_get(current, i) == rcu_bucket_get(old, i));
+            assert(!touched || rcu_bucket_get(current, i) == NULL || rcu_bucket_get(current, i) != rcu_bucket_get(old, i));
+            shared += !touched && rcu_bucket_get(current, i) != NULL;
+        }
+        assert(shared > 0);
+
+        assert(hashTableRcu_reclaim(rcu) == 1);
+        hashTableRcu_read_unlock(reader);
+        hashTableRcu_synchronize(rcu);
+        assert(rcu->noOfRetired == 0);
+
+        // Aborted draft changes nothing
+        assert(hashTableRcu_begin(rcu) == 0);
+        assert(hashTableRcu_insert(rcu, "keyFour", "valueFour") == 0);
+        hashTableRcu_abort(rcu);
+        assert(hashTableRcuVersion_search(rcu->current, "keyFour") == NULL);
+        assert(rcu->current == current);
+
+        hashTableRcu_reader_unregister(reader);
+        hashTableRcu_delete(rcu);
+    }
+
+    // Reload from HashTable copies only the buckets which changed
+    {
+        HashTableRcu* rcu = hashTableRcu_new(256);
+        HashTable* config = hashTable_new(200);
+        char key[32];
+        char value[32];
+        for (size_t i = 0; i < 100; ++i)
+        {
+            snprintf(key, sizeof(key), "option%zu", i);
+            snprintf(value, sizeof(value), "value%zu", i);
+            hashTable_insert(config, key, value);
+        }
+
+        assert(hashTableRcu_begin(rcu) == 0);
+        assert(hashTableRcu_load(rcu, config) == 0);
+        assert(hashTableRcu_publish(rcu) == 0);
+        const HashTableRcuVersion* first = rcu->current;
+        assert(first->noOfElems == 100);
+
+        HashTableRcuReader* reader = hashTableRcu_reader_register(rcu);
+        assert(hashTableRcu_read_lock(reader) == first);
+
+        hashTable_insert(config, "option7", "reloaded");
+        hashTable_delete_record(config, "option8");
+        hashTable_insert(config, "option100", "value100");
+        assert(hashTableRcu_begin(rcu) == 0);
+        assert(hashTableRcu_load(rcu, config) == 0);
+        assert(hashTableRcu_publish(rcu) == 0);
+        const HashTableRcuVersion* second = rcu->current;
+
+        size_t copied = 0;
+        for (size_t i = 0; i < second->size; ++i)
+        {
+            copied += rcu_bucket_get(second, i) != rcu_bucket_get(first, i);
+        }
+        assert(copied >= 1 && copied <= 3);
+        assert(second->noOfElems == 100);
+        assert(strcmp(hashTableRcuVersion_search(second, "option7"), "reloaded") == 0);
+        assert(hashTableRcuVersion_search(second, "option8") == NULL);
+        assert(strcmp(hashTableRcuVersion_search(second, "option100"), "value100") == 0);
+        for (size_t i = 0; i < 100; ++i)
+        {
+            snprintf(key, sizeof(key), "option%zu", i);
+            snprintf(value, sizeof(value), "value%zu", i);
+            assert(strcmp(hashTableRcuVersion_search(first, key), value) == 0);
+        }
+
+        // Reload of the same content shares every bucket
+        assert(hashTableRcu_begin(rcu) == 0);
+        assert(hashTableRcu_load(rcu, config) == 0);
+        for (size_t i = 0; i < second->size; ++i)
+        {
+            assert(rcu_bucket_get(rcu->draft, i) == rcu_bucket_get(second, i));
+        }
+        hashTableRcu_abort(rcu);
+
+        hashTableRcu_read_unlock(reader);
+        hashTableRcu_synchronize(rcu);
+        hashTableRcu_reader_unregister(reader);
+        hashTable_delete(config);
+        hashTableRcu_delete(rcu);
+    }
+
+    // Concurrent readers never see a mix of two versions
+    {
+        HashTableRcu* rcu = hashTableRcu_new(32);
+        RcuReaderWork work = {rcu, 0, 0};
+        pthread_t threads[4];
+        char key[32];
+        char value[32];
+
+        assert(hashTableRcu_begin(rcu) == 0);
+        for (size_t k = 0; k < RCU_TEST_KEYS; ++k)
+        {
+            snprintf(key, sizeof(key), "key%zu", k);
+            hashTableRcu_insert(rcu, key, "0");
+        }
+        hashTableRcu_publish(rcu);
+
+        for (size_t t = 0; t < 4; ++t)
+        {
+            assert(pthread_create(&threads[t], NULL, rcu_reader_thread, &work) == 0);
+        }
+
+        for (size_t v = 1; v <= RCU_TEST_VERSIONS; ++v)
+        {
+            snprintf(value, sizeof(value), "%zu", v);
+            assert(hashTableRcu_begin(rcu) == 0);
+            for (size_t k = 0; k < RCU_TEST_KEYS; ++k)
+            {
+                snprintf(key, sizeof(key), "key%zu", k);
+                assert(hashTableRcu_insert(rcu, key, value) == 0);
+            }
+            assert(hashTableRcu_publish(rcu) == 0);
+        }
+
+        __atomic_store_n(&work.stop, 1, __ATOMIC_RELEASE);
+        for (size_t t = 0; t < 4; ++t)
+        {
+            pthread_join(threads[t], NULL);
+        }
+
+        hashTableRcu_synchronize(rcu);
+        assert(rcu->noOfRetired == 0);
+        assert(work.sections > 0);
+        hashTableRcu_delete(rcu);
+    }
+}
+
+static void* rcu_reader_thread(void* arg)
+{
+    RcuReaderWork* work = arg;
+    HashTableRcuReader* reader = hashTableRcu_reader_register(work->rcu);
+    char key[32];
+    size_t sections = 0;
+
+    // At least one section, the writer may finish before this thread is scheduled
+    do
+    {
+        const HashTableRcuVersion* version = hashTableRcu_read_lock(reader);
+        const char* first = hashTableRcuVersion_search(version, "key0");
+        assert(first != NULL);
+
+        for (size_t k = 1; k < RCU_TEST_KEYS; ++k)
+        {
+            snprintf(key, sizeof(key), "key%zu", k);
+            const char* value = hashTableRcuVersion_search(version, key);
+            assert(value != NULL && strcmp(value, first) == 0);
+        }
+
+        hashTableRcu_read_unlock(reader);
+        sections++;
+    } while (!__atomic_load_n(&work->stop, __ATOMIC_ACQUIRE));
+
+    hashTableRcu_reader_unregister(reader);
+    __atomic_fetch_add(&work->sections, sections, __ATOMIC_RELAXED);
+    return NULL;
+}
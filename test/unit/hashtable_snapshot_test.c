@@ -0,0 +1,164 @@
+#include <hashtable_snapshot.c>
+#include <hashtable.c>
+#include <nodelist.c>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void hashtable_snapshot_test(void);
+
+// Test functions: int hashTable_snapshot_write(const HashTable* hashTable, const char* path);
+//                 HashTableSnapshot* hashTableSnapshot_open(const char* path);
+//                 const char* hashTableSnapshot_search(const HashTableSnapshot* snapshot, const char* key);
+void hashtable_snapshot_test(void)
+{
+    register const char* path = "hashtable_snapshot_test.bin";
+
+    // Incorrect arguments
+    {
+        assert(hashTable_snapshot_write(NULL, path) == -1);
+        assert(hashTableSnapshot_open(NULL) == NULL);
+        assert(hashTableSnapshot_open("not_existing_snapshot.bin") == NULL);
+        assert(hashTableSnapshot_search(NULL, "key") == NULL);
+        hashTableSnapshot_close(NULL);
+    }
+
+    // Empty table, every search should miss
+    {
+        HashTable* ht = hashTable_new(5);
+        assert(hashTable_snapshot_write(ht, path) == 0);
+        hashTable_delete(ht);
+
+        HashTableSnapshot* snapshot = hashTableSnapshot_open(path);
+        assert(snapshot != NULL);
+        assert(snapshot->noOfElems == 0);
+        assert(hashTableSnapshot_search(snapshot, "keyOne") == NULL);
+        hashTableSnapshot_close(snapshot);
+    }
+
+    // Records and collision lists are all written, values are read directly from the mapping
+    {
+        register const size_t count = 100;
+        char keys[100][16];
+        char values[100][16];
+        HashTable* ht = hashTable_new(count);
+
+        // Colliding keys
+        hashTable_insert(ht, "keyOne", "valOne");
+        hashTable_insert(ht, "keyTwo", "valTwo");
+        hashTable_insert(ht, "keyThr", "valThr");
+
+        for (size_t i = 3; i < count; ++i)
+        {
+            snprintf(keys[i], sizeof(keys[i]), "key%zu", i);
+            snprintf(values[i], sizeof(values[i]), "value%zu", i);
+            hashTable_insert(ht, keys[i], values[i]);
+        }
+
+        assert(hashTable_snapshot_write(ht, path) == 0);
+        hashTable_delete(ht);
+
+        HashTableSnapshot* snapshot = hashTableSnapshot_open(path);
+        assert(snapshot != NULL);
+        assert(snapshot->noOfElems == count);
+        assert(snapshot->size >= count);
+
+        const char* value = hashTableSnapshot_search(snapshot, "keyTwo");
+        assert(value != NULL && strcmp(value, "valTwo") == 0);
+        assert((const void*)value > snapshot->mapping);
+        assert((const char*)value < (const char*)snapshot->mapping + snapshot->mappingSize);
+        assert(strcmp(hashTableSnapshot_search(snapshot, "keyOne"), "valOne") == 0);
+        assert(strcmp(hashTableSnapshot_search(snapshot, "keyThr"), "valThr") == 0);
+
+        for (size_t i = 3; i < count; ++i)
+        {
+            assert(strcmp(hashTableSnapshot_search(snapshot, keys[i]), values[i]) == 0);
+        }
+
+        assert(hashTableSnapshot_search(snapshot, "missing") == NULL);
+        assert(hashTableSnapshot_search(snapshot, NULL) == NULL);
+
+        hashTableSnapshot_close(snapshot);
+    }
+
+    // Damaged file should be rejected
+    {
+        HashTable* ht = hashTable_new(5);
+        hashTable_insert(ht, "keyOne", "valOne");
+        assert(hashTable_snapshot_write(ht, path) == 0);
+        hashTable_delete(ht);
+
+        // Truncate the strings region
+        FILE* file = fopen(path, "rb");
+        unsigned char buffer[512];
+        const size_t size = fread(buffer, 1, sizeof(buffer), file);
+        fclose(file);
+        assert(size > sizeof(HashTableSnapshotHeader));
+
+        file = fopen(path, "wb");
+        fwrite(buffer, 1, size - 1, file);
+        fclose(file);
+        assert(hashTableSnapshot_open(path) == NULL);
+
+        // Header field changed without the checksum
+        HashTableSnapshotHeader header;
+        memcpy(&header, buffer, sizeof(header));
+        header.noOfElems++;
+        memcpy(buffer, &header, sizeof(header));
+        file = fopen(path, "wb");
+        fwrite(buffer, 1, size, file);
+        fclose(file);
+        assert(hashTableSnapshot_open(path) == NULL);
+
+        // Wrong magic
+        header.noOfElems--;
+        memcpy(buffer, &header, sizeof(header));
+        buffer[0] = 'X';
+        file = fopen(path, "wb");
+        fwrite(buffer, 1, size, file);
+        fclose(file);
+        assert(hashTableSnapshot_open(path) == NULL);
+    }
+
+    // Damaged buckets and entries are not checked by open, but never read out of bounds by lookups
+    {
+        HashTable* ht = hashTable_new(5);
+        hashTable_insert(ht, "keyOne", "valOne");
+        hashTable_insert(ht, "keyTwo", "valTwo");
+        assert(hashTable_snapshot_write(ht, path) == 0);
+        hashTable_delete(ht);
+
+        FILE* file = fopen(path, "rb");
+        unsigned char buffer[512];
+        const size_t size = fread(buffer, 1, sizeof(buffer), file);
+        fclose(file);
+
+        HashTableSnapshotHeader header;
+        memcpy(&header, buffer, sizeof(header));
+
+        // Key offsets of both entries and the end of the last bucket point far behind the file
+        HashTableSnapshotEntry entry;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            unsigned char* at = buffer + header.entriesOffset + i * sizeof(entry);
+            memcpy(&entry, at, sizeof(entry));
+            entry.keyOffset = UINT64_MAX / 2;
+            memcpy(at, &entry, sizeof(entry));
+        }
+        const uint64_t huge = UINT64_MAX / 2;
+        memcpy(buffer + header.bucketsOffset + header.size * sizeof(uint64_t), &huge, sizeof(huge));
+
+        file = fopen(path, "wb");
+        fwrite(buffer, 1, size, file);
+        fclose(file);
+
+        HashTableSnapshot* snapshot = hashTableSnapshot_open(path);
+        assert(snapshot != NULL);
+        assert(hashTableSnapshot_search(snapshot, "keyOne") == NULL);
+        assert(hashTableSnapshot_search(snapshot, "keyTwo") == NULL);
+        assert(hashTableSnapshot_search(snapshot, "missing") == NULL);
+        hashTableSnapshot_close(snapshot);
+    }
+
+    remove(path);
+}
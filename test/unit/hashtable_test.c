@@ -6,11 +6,32 @@
 
 void hashtable_record_new_test(void);
 void hashtable_new_test(void);
+void hashtable_new_from_arrays_test(void);
 void hashtable_insert_test(void);
 void hashtable_delete_record_test(void);
 void hashtable_hash_function_test(void);
 void hashtable_collision_test(void);
 void hashtable_search_test(void);
+void hashtable_stats_test(void);
+void hashtable_search_batch_test(void);
+void hashtable_bloom_test(void);
+void hashtable_cache_test(void);
+void hashtable_ttl_test(void);
+void hashtable_insert_zero_copy_test(void);
+void hashtable_inline_strings_test(void);
+void hashtable_treeify_test(void);
+void hashtable_iterator_test(void);
+void hashtable_scan_test(void);
+void hashtable_merge_test(void);
+void hashtable_clear_test(void);
+
+static void test_colliding_key(char* key, size_t keySize, const char* base, size_t tableSize, size_t n);
+static void test_sorted_bucket(const HashTable* ht, size_t index);
+static void test_scan_count(const char* key, const char* value, void* context);
+static void* test_search_worker(void* arg);
+static const Record* test_record(const HashTable* ht, const char* key);
+static const char* test_combine_sum(const char* key, const char* present, const char* incoming,
+                                    char* buffer, size_t capacity, void* context);
 
 // Test function: Record* record_new(const char* key, const char* value);
 void hashtable_record_new_test(void)
@@ -49,8 +70,31 @@ void hashtable_record_new_test(void)
         Record* record = record_new(key, val);
 
         assert(record != NULL);
-        assert(strcmp(record->key, key) == 0);
-        assert(strcmp(record->value, val) == 0);
+        assert(strcmp(record_key(record), key) == 0);
+        assert(strcmp(record_value(record), val) == 0);
+
+        // Short strings are stored in the record itself
+        assert(record_key(record) == (const char*)record->key.words);
+        assert(record_value(record) == (const char*)record->value.words);
+        assert(record->flags == (RECORD_KEY_INLINE | RECORD_VALUE_INLINE));
+
+        record_delete(record);
+    }
+
+    // Strings of RECORD_INLINE_SIZE - 1 characters are the longest stored inline
+    {
+        char key[RECORD_INLINE_SIZE + 1];
+        memset(key, 'k', RECORD_INLINE_SIZE);
+        key[RECORD_INLINE_SIZE] = '\0';
+        const char* val = key + 1;
+        Record* record = record_new(key, val);
+
+        assert(record != NULL);
+        assert(strcmp(record_key(record), key) == 0);
+        assert(strcmp(record_value(record), val) == 0);
+        assert(record_key(record) == record->key.ptr);
+        assert(record_value(record) == (const char*)record->value.words);
+        assert(record->flags == RECORD_VALUE_INLINE);
 
         record_delete(record);
     }
@@ -79,13 +123,131 @@ void hashtable_new_test(void)
         for (size_t i = 0; i < table_size; ++i)
         {
             assert(hashTable->records[i] == NULL);
-            assert(hashTable->collisionList[i] == NULL);
         }
 
         hashTable_delete(hashTable);
     }
 }
 
+// Test function: HashTable* hashTable_new_from_arrays(const char* const* keys, const char* const* values, size_t count, size_t threads);
+void hashtable_new_from_arrays_test(void)
+{
+    // Incorrect arguments, should return NULL
+    {
+        const char* keys[] = {"keyOne", NULL};
+        const char* values[] = {"valOne", "valTwo"};
+
+        assert(hashTable_new_from_arrays(NULL, values, 2, 1) == NULL);
+        assert(hashTable_new_from_arrays(keys, NULL, 2, 1) == NULL);
+        assert(hashTable_new_from_arrays(keys, values, 0, 1) == NULL);
+        assert(hashTable_new_from_arrays(keys, values, 2, 1) == NULL);
+    }
+
+    // Colliding keys, table should be sized exactly and records placed like by hashTable_insert
+    {
+        char keyTwo[24];
+        char keyThr[24];
+        test_colliding_key(keyTwo, sizeof(keyTwo), "keyOne", 3, 0);
+        test_colliding_key(keyThr, sizeof(keyThr), "keyOne", 3, 1);
+        const char* keys[] = {"keyOne", keyTwo, keyThr};
+        const char* values[] = {"valOne", "valTwo", "valThr"};
+        HashTable* ht = hashTable_new_from_arrays(keys, values, 3, 1);
+
+        assert(ht != NULL);
+        assert(ht->size == 3);
+        assert(ht->noOfElems == 3);
+        assert(ht->bulkBlock != NULL);
+
+        register const size_t index = hash_function(keys[0], ht->size);
+        assert(ht->records[index] != NULL);
+        assert(strcmp(record_key(ht->records[index]), "keyOne") == 0);
+        assert(ht->records[index]->next != NULL);
+        assert(ht->records[index]->next->next != NULL);
+
+        // Strings are copied, not referenced
+        for (size_t i = 0; i < 3; ++i)
+        {
+            const char* found = hashTable_search(ht, keys[i]);
+            assert(found != NULL && found != values[i]);
+            assert(strcmp(found, values[i]) == 0);
+        }
+
+        // Records from the block can be deleted and updated like the other ones (table is full, so delete first)
+        hashTable_delete_record(ht, keyTwo);
+        assert(ht->noOfElems == 2);
+        assert(hashTable_search(ht, keyTwo) == NULL);
+        assert(strcmp(hashTable_search(ht, keyThr), "valThr") == 0);
+
+        hashTable_insert(ht, "keyOne", "valNew");
+        assert(strcmp(hashTable_search(ht, "keyOne"), "valNew") == 0);
+        hashTable_insert(ht, "keyOne", "longerValue");
+        assert(strcmp(hashTable_search(ht, "keyOne"), "longerValue") == 0);
+        assert(ht->noOfElems == 2);
+
+        hashTable_delete(ht);
+    }
+
+    // Duplicate keys are merged, the last value wins for both serial and parallel build
+    {
+        const char* keys[] = {"keyOne", "keyTwo", "keyOne", "keyThr", "keyOne", "keyTwo"};
+        const char* values[] = {"valOne", "valTwo", "newOne", "valThr", "lastOne", "aLongerValueOfKeyTwo"};
+
+        for (size_t threads = 1; threads <= 3; threads += 2)
+        {
+            HashTable* ht = hashTable_new_from_arrays(keys, values, 6, threads);
+
+            assert(ht != NULL);
+            assert(ht->size == 6);
+            assert(ht->noOfElems == 3);
+            assert(strcmp(hashTable_search(ht, "keyOne"), "lastOne") == 0);
+            assert(strcmp(hashTable_search(ht, "keyTwo"), "aLongerValueOfKeyTwo") == 0);
+            assert(strcmp(hashTable_search(ht, "keyThr"), "valThr") == 0);
+
+            hashTable_delete_record(ht, "keyOne");
+            assert(hashTable_search(ht, "keyOne") == NULL);
+            assert(ht->noOfElems == 2);
+
+            hashTable_delete(ht);
+        }
+    }
+
+    // Parallel build gives the same content as the serial one
+    {
+        register const size_t count = 500;
+        char storage[500][16];
+        const char* keys[500];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            snprintf(storage[i], sizeof(storage[i]), "key%zu", i);
+            keys[i] = storage[i];
+        }
+
+        HashTable* serial = hashTable_new_from_arrays(keys, keys, count, 1);
+        HashTable* parallel = hashTable_new_from_arrays(keys, keys, count, 4);
+        HashTableStats serialStats;
+        HashTableStats parallelStats;
+
+        assert(serial != NULL && parallel != NULL);
+        assert(serial->noOfElems == count);
+        assert(parallel->noOfElems == count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            assert(strcmp(hashTable_search(serial, keys[i]), keys[i]) == 0);
+            assert(strcmp(hashTable_search(parallel, keys[i]), keys[i]) == 0);
+        }
+
+        hashTable_stats(serial, &serialStats);
+        hashTable_stats(parallel, &parallelStats);
+        assert(serialStats.occupiedBuckets == parallelStats.occupiedBuckets);
+        assert(serialStats.longestChain == parallelStats.longestChain);
+
+        hashTable_delete(serial);
+        hashTable_delete(parallel);
+    }
+}
+
 // Test function: void hashTable_insert(HashTable* hashTable, const char* key, const char* value);
 void hashtable_insert_test(void)
 {
@@ -103,7 +265,6 @@ void hashtable_insert_test(void)
         assert(ht->size == table_size);
         assert(ht->noOfElems == 0);
         assert(ht->records[0] == NULL);
-        assert(ht->collisionList[0] == NULL);
 
         hashTable_delete(ht);  
     }
@@ -122,7 +283,6 @@ void hashtable_insert_test(void)
         assert(ht->size == table_size);
         assert(ht->noOfElems == 0);
         assert(ht->records[0] == NULL);
-        assert(ht->collisionList[0] == NULL);
 
         hashTable_delete(ht);  
     }
@@ -136,16 +296,15 @@ void hashtable_insert_test(void)
 
         assert(ht->noOfElems == 0);
         assert(ht->records[0] == NULL);
-        assert(ht->collisionList[0] == NULL);
 
         hashTable_insert(ht, key, val);
 
         // Check if element has been added to hash table
         assert(ht->noOfElems == 1);
         assert(ht->records[0] != NULL);
-        assert(strcmp(ht->records[0]->key, key) == 0);
-        assert(strcmp(ht->records[0]->value, val) == 0);
-        assert(ht->collisionList[0] == NULL);
+        assert(strcmp(record_key(ht->records[0]), key) == 0);
+        assert(strcmp(record_value(ht->records[0]), val) == 0);
+        assert(ht->records[0]->next == NULL);
 
         hashTable_delete(ht);
     }
@@ -166,15 +325,15 @@ void hashtable_insert_test(void)
         index = hash_function(key, ht->size);
 
         assert(ht->noOfElems == 1);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
     
         hashTable_insert(ht, key2, val2);
         index = hash_function(key2, ht->size);
 
         assert(ht->noOfElems == 2);
-        assert(strcmp(ht->records[index]->key, key2) == 0);
-        assert(strcmp(ht->records[index]->value, val2) == 0);
+        assert(strcmp(record_key(ht->records[index]), key2) == 0);
+        assert(strcmp(record_value(ht->records[index]), val2) == 0);
 
         hashTable_delete(ht);
     }
@@ -196,8 +355,8 @@ void hashtable_insert_test(void)
 
         assert(ht->noOfElems == 1);
         assert(ht->records[index] != NULL);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
     
         hashTable_insert(ht, key2, val2);
         index = hash_function(key2, ht->size);
@@ -205,8 +364,8 @@ void hashtable_insert_test(void)
         // Check if new element has been rejected and old values remains
         assert(ht->noOfElems == 1);
         assert(ht->records[index] != NULL);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
 
         hashTable_delete(ht);
     }
@@ -223,24 +382,23 @@ void hashtable_insert_test(void)
 
         assert(ht->noOfElems == 0);
         assert(ht->records[index] == NULL);
-        assert(ht->collisionList[index] == NULL);
 
         hashTable_insert(ht, key, val);
 
         // Check if element has been added to hash table
         assert(ht->noOfElems == 1);
         assert(ht->records[index] != NULL);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
-        assert(ht->collisionList[index] == NULL);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
+        assert(ht->records[index]->next == NULL);
 
         hashTable_insert(ht, key, val2);
         // Check if element has been replaced
         assert(ht->noOfElems == 1);
         assert(ht->records[index] != NULL);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val2) == 0);
-        assert(ht->collisionList[index] == NULL);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val2) == 0);
+        assert(ht->records[index]->next == NULL);
 
         hashTable_delete(ht);
     }
@@ -277,16 +435,16 @@ void hashtable_delete_record_test(void)
         // Check if element has been added to hash table
         assert(ht->noOfElems == 1);
         assert(ht->records[index] != NULL);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
 
         hashTable_delete_record(ht, "key");
 
         // All stats should remain the same
         assert(ht->noOfElems == 1);
         assert(ht->records[index] != NULL);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
 
         hashTable_delete(ht);
     }
@@ -305,8 +463,8 @@ void hashtable_delete_record_test(void)
         // Check if element has been added to hash table
         assert(ht->noOfElems == 1);
         assert(ht->records[index] != NULL);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
 
         hashTable_delete_record(ht, key);
         assert(ht->noOfElems == 0);
@@ -370,20 +528,22 @@ void hashtable_delete_record_test(void)
         hashTable_delete(ht);        
     }
 
-    // Delete elements from collision node list
+    // Delete elements from collision chain
     {
         register const size_t table_size = 3;
         register const char* key = "keyOne";
         register const char* val = "valOne";
-        register const char* key2 = "keyTwo";
+        char key2[24];
         register const char* val2 = "valTwo";
-        register const char* key3 = "keyThr";
+        char key3[24];
         register const char* val3 = "valThr";
         HashTable* ht = hashTable_new(table_size);
+        test_colliding_key(key2, sizeof(key2), key, table_size, 0);
+        test_colliding_key(key3, sizeof(key3), key, table_size, 1);
 
-        register const size_t index = hash_function(key, ht->size);;
-        register const size_t index2 = hash_function(key2, ht->size);;
-        register const size_t index3 = hash_function(key3, ht->size);;
+        register const size_t index = hash_function(key, ht->size);
+        register const size_t index2 = hash_function(key2, ht->size);
+        register const size_t index3 = hash_function(key3, ht->size);
 
         hashTable_insert(ht, key, val);
         hashTable_insert(ht, key2, val2);
@@ -400,56 +560,86 @@ void hashtable_delete_record_test(void)
         // Three elements inserted despite of same indexes
         assert(ht->noOfElems == 3);
 
-        // Collision list should be created
-        assert(ht->collisionList[index] != NULL);
+        // Chain should be created
+        assert(ht->records[index]->next != NULL);
 
         // Firstly written data should not be changed
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
 
-        // New set of data should be added to start of collision list
-        NodeList* head = ht->collisionList[index];
-        Record* rec3 = (Record*)head->data;
+        // New set of data should be linked right after the first record
+        Record* rec3 = ht->records[index]->next;
         assert(rec3 != NULL);
-        assert(strcmp(rec3->key, key3) == 0);
-        assert(strcmp(rec3->value, val3) == 0);
+        assert(strcmp(record_key(rec3), key3) == 0);
+        assert(strcmp(record_value(rec3), val3) == 0);
 
         // Previous data should be accessable through new data
-        assert(head->next != NULL);
-        Record* rec2 = (Record*)head->next->data;
-        assert(rec2 != NULL);
-        assert(strcmp(rec2->key, key2) == 0);
-        assert(strcmp(rec2->value, val2) == 0);
-        assert(head->next->next == NULL);
-
-        // Delete current node which stores data for key3
+        assert(rec3->next != NULL);
+        Record* rec2 = rec3->next;
+        assert(strcmp(record_key(rec2), key2) == 0);
+        assert(strcmp(record_value(rec2), val2) == 0);
+        assert(rec2->next == NULL);
+
+        // Delete the record which stores data for key3
         hashTable_delete_record(ht, key3);
     
-        // New head and its record should equals the values of rec2, since previous head (rec3) was deleted
-        NodeList* headNew = ht->collisionList[index];
-        Record* recNew = (Record*)headNew->data;
-        assert(recNew == rec2);
-        assert(strcmp(recNew->key, key2) == 0);
-        assert(strcmp(recNew->value, val2) == 0);
+        // First record should now link to rec2, since rec3 was deleted
+        assert(ht->records[index]->next == rec2);
+        assert(strcmp(record_key(rec2), key2) == 0);
+        assert(strcmp(record_value(rec2), val2) == 0);
 
-        // New head should not have next element
-        assert(headNew->next == NULL);
+        // rec2 should not have next element
+        assert(rec2->next == NULL);
 
         // Number of elements should decrese by 1
         assert(ht->noOfElems == 2);
 
-        // Delete last element of collision list
+        // Delete last record of the chain
         hashTable_delete_record(ht, key2);
 
-        // After that collision list should not exist
-        assert(ht->collisionList[index] == NULL);
+        // After that only the first record should be left
+        assert(ht->records[index]->next == NULL);
 
         // Number of elements should decrese by 1
         assert(ht->noOfElems == 1);
 
         // Firstly written data should not be changed
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
+
+        hashTable_delete(ht);
+    }
+
+    // Delete the head record of the chain
+    {
+        register const size_t table_size = 3;
+        HashTable* ht = hashTable_new(table_size);
+        register const size_t index = hash_function("keyOne", ht->size);
+        char keyTwo[24];
+        char keyThr[24];
+        test_colliding_key(keyTwo, sizeof(keyTwo), "keyOne", table_size, 0);
+        test_colliding_key(keyThr, sizeof(keyThr), "keyOne", table_size, 1);
+
+        hashTable_insert(ht, "keyOne", "valOne");
+        hashTable_insert(ht, keyTwo, "valTwo");
+        hashTable_insert(ht, keyThr, "valThr");
+
+        hashTable_delete_record(ht, "keyOne");
+
+        // Next record of the chain takes the place, rest of the chain stays reachable
+        assert(ht->noOfElems == 2);
+        assert(ht->records[index] != NULL);
+        assert(strcmp(record_key(ht->records[index]), keyThr) == 0);
+        assert(ht->records[index]->next != NULL);
+        assert(ht->records[index]->next->next == NULL);
+        assert(hashTable_search(ht, "keyOne") == NULL);
+        assert(strcmp(hashTable_search(ht, keyTwo), "valTwo") == 0);
+        assert(strcmp(hashTable_search(ht, keyThr), "valThr") == 0);
+
+        hashTable_delete_record(ht, keyThr);
+        hashTable_delete_record(ht, keyTwo);
+        assert(ht->noOfElems == 0);
+        assert(ht->records[index] == NULL);
 
         hashTable_delete(ht);
     }
@@ -507,9 +697,10 @@ void hashtable_collision_test(void)
         register const size_t table_size = 2;
         register const char* key = "keyOne";
         register const char* val = "valOne";
-        register const char* key2 = "keyTwo";
+        char key2[24];
         register const char* val2 = "valTwo";
         HashTable* ht = hashTable_new(table_size);
+        test_colliding_key(key2, sizeof(key2), key, table_size, 0);
 
         hashTable_insert(ht, key, val);
         register const size_t index = hash_function(key, ht->size);
@@ -517,10 +708,9 @@ void hashtable_collision_test(void)
         // Check statistics after adding first one
         assert(ht->noOfElems == 1);
         assert(ht->records[index] != NULL);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
-        assert(ht->collisionList[0] == NULL);
-        assert(ht->collisionList[1] == NULL);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
+        assert(ht->records[index]->next == NULL);
 
         hashTable_insert(ht, key2, val2);
         register const size_t index2 = hash_function(key2, ht->size);
@@ -533,19 +723,17 @@ void hashtable_collision_test(void)
         assert(ht->noOfElems == 2);
 
         // Previously written data should not be changed
-        assert(strcmp(ht->records[index2]->key, key) == 0);
-        assert(strcmp(ht->records[index2]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index2]), key) == 0);
+        assert(strcmp(record_value(ht->records[index2]), val) == 0);
 
-        // But collision list should be now created
-        assert(ht->collisionList[index2] != NULL);
+        // But the chain should be now created
+        assert(ht->records[index2]->next != NULL);
 
-        // New set of data should be added to collision list
-        Record* rec2 = (Record*)ht->collisionList[index2]->data;
-        NodeList* next = ht->collisionList[index2]->next;
-        assert(rec2 != NULL);
-        assert(strcmp(rec2->key, key2) == 0);
-        assert(strcmp(rec2->value, val2) == 0);
-        assert(next == NULL);
+        // New set of data should be linked to the first record
+        Record* rec2 = ht->records[index2]->next;
+        assert(strcmp(record_key(rec2), key2) == 0);
+        assert(strcmp(record_value(rec2), val2) == 0);
+        assert(rec2->next == NULL);
 
         hashTable_delete(ht);
     }
@@ -555,29 +743,28 @@ void hashtable_collision_test(void)
         To simplify, look at the test description below.
         * 1st insert
             records[index]                  = {key, val}
-            collisionList[index]            = NULL
+            records[index].next             = NULL
         * 2nd insert
             records[index]                  = {key, val}
-            collisionList[index]            = 0x80
-            collisionList[index].data       = {key2, val2}
-            collisionList[index].next       = NULL
+            records[index].next             = {key2, val2}
+            records[index].next.next        = NULL
         * 3rd insert
             records[index]                  = {key, val}
-            collisionList[index]            = 0x94
-            collisionList[index].data       = {key3, val3}
-            collisionList[index].next       = (0x80)
-            collisionList[index].next.data  = {key2, val2}
-            collisionList[index].next.next  = NULL
+            records[index].next             = {key3, val3}
+            records[index].next.next        = {key2, val2}
+            records[index].next.next.next   = NULL
     */
     {
         register const size_t table_size = 3;
         register const char* key = "keyOne";
         register const char* val = "valOne";
-        register const char* key2 = "keyTwo";
+        char key2[24];
         register const char* val2 = "valTwo";
-        register const char* key3 = "keyThr";
+        char key3[24];
         register const char* val3 = "valThr";
         HashTable* ht = hashTable_new(table_size);
+        test_colliding_key(key2, sizeof(key2), key, table_size, 0);
+        test_colliding_key(key3, sizeof(key3), key, table_size, 1);
 
         hashTable_insert(ht, key, val);
         register const size_t index = hash_function(key, ht->size);
@@ -585,10 +772,9 @@ void hashtable_collision_test(void)
         // Check statistics after adding first one
         assert(ht->noOfElems == 1);
         assert(ht->records[index] != NULL);
-        assert(strcmp(ht->records[index]->key, key) == 0);
-        assert(strcmp(ht->records[index]->value, val) == 0);
-        assert(ht->collisionList[0] == NULL);
-        assert(ht->collisionList[1] == NULL);
+        assert(strcmp(record_key(ht->records[index]), key) == 0);
+        assert(strcmp(record_value(ht->records[index]), val) == 0);
+        assert(ht->records[index]->next == NULL);
 
         hashTable_insert(ht, key2, val2);
         register const size_t index2 = hash_function(key2, ht->size);
@@ -601,19 +787,17 @@ void hashtable_collision_test(void)
         assert(ht->noOfElems == 2);
 
         // Previously written data should not be changed
-        assert(strcmp(ht->records[index2]->key, key) == 0);
-        assert(strcmp(ht->records[index2]->value, val) == 0);
+        assert(strcmp(record_key(ht->records[index2]), key) == 0);
+        assert(strcmp(record_value(ht->records[index2]), val) == 0);
 
-        // But collision list should be now created
-        assert(ht->collisionList[index2] != NULL);
+        // But the chain should be now created
+        assert(ht->records[index2]->next != NULL);
 
-        // New set of data should be added to collision list
-        NodeList* firstNodeInCollision = ht->collisionList[index2];
-        Record* rec2 = (Record*)firstNodeInCollision->data;
-        assert(rec2 != NULL);
-        assert(strcmp(rec2->key, key2) == 0);
-        assert(strcmp(rec2->value, val2) == 0);
-        assert(firstNodeInCollision->next == NULL);
+        // New set of data should be linked to the first record
+        Record* rec2 = ht->records[index2]->next;
+        assert(strcmp(record_key(rec2), key2) == 0);
+        assert(strcmp(record_value(rec2), val2) == 0);
+        assert(rec2->next == NULL);
 
         hashTable_insert(ht, key3, val3);
         register const size_t index3 = hash_function(key3, ht->size);
@@ -626,28 +810,20 @@ void hashtable_collision_test(void)
         assert(ht->noOfElems == 3);
 
         // Firstly written data should not be changed
-        assert(strcmp(ht->records[index3]->key, key) == 0);
-        assert(strcmp(ht->records[index3]->value, val) == 0);
-
-        // Same collision list should still exist
-        assert(ht->collisionList[index2] == ht->collisionList[index3]);
-        assert(ht->collisionList[index3] != NULL);
+        assert(strcmp(record_key(ht->records[index3]), key) == 0);
+        assert(strcmp(record_value(ht->records[index3]), val) == 0);
 
-        // New set of data should be added to start of collision list
-        NodeList* secondNodeInCollision = ht->collisionList[index3];
-        Record* rec3 = (Record*)secondNodeInCollision->data;
+        // New set of data should be linked right after the first record
+        Record* rec3 = ht->records[index3]->next;
         assert(rec3 != NULL);
-        assert(strcmp(rec3->key, key3) == 0);
-        assert(strcmp(rec3->value, val3) == 0);
+        assert(strcmp(record_key(rec3), key3) == 0);
+        assert(strcmp(record_value(rec3), val3) == 0);
 
         // Previous data should be accessable through new data
-        assert(secondNodeInCollision->next != NULL);
-        assert(secondNodeInCollision->next == firstNodeInCollision);
-        Record* prevRec = (Record*)secondNodeInCollision->next->data;
-        assert(rec2 == prevRec);
-        assert(strcmp(prevRec->key, rec2->key) == 0);
-        assert(strcmp(prevRec->value, rec2->value) == 0);
-        assert(secondNodeInCollision->next->next == NULL);
+        assert(rec3->next == rec2);
+        assert(strcmp(record_key(rec3->next), key2) == 0);
+        assert(strcmp(record_value(rec3->next), val2) == 0);
+        assert(rec2->next == NULL);
 
         hashTable_delete(ht);
     }
@@ -695,14 +871,16 @@ void hashtable_search_test(void)
         register const size_t table_size = 3;
         register const char* key = "keyOne";
         register const char* val = "valOne";
-        register const char* key2 = "keyTwo";
+        char key2[24];
         register const char* val2 = "valTwo";
-        register const char* key3 = "keyThr";
+        char key3[24];
         register const char* val3 = "valThr";
         char* val_searched = NULL;
         char* val2_searched = NULL;
         char* val3_searched = NULL;
         HashTable* ht = hashTable_new(table_size);
+        test_colliding_key(key2, sizeof(key2), key, table_size, 0);
+        test_colliding_key(key3, sizeof(key3), key, table_size, 1);
 
         // Add first element
         hashTable_insert(ht, key, val);
@@ -738,7 +916,7 @@ void hashtable_search_test(void)
         val3_searched = (char*)hashTable_search(ht, key3);
         assert(strcmp(val3, val3_searched) == 0);
 
-        // Once again search each element to check if moving data in node list doesn't impacted the result
+        // Once again search each element to check if moving data in the chain doesn't impacted the result
         val_searched = (char*)hashTable_search(ht, key);
         val2_searched = (char*)hashTable_search(ht, key2);
         val3_searched = (char*)hashTable_search(ht, key3);
@@ -749,4 +927,1419 @@ void hashtable_search_test(void)
         hashTable_delete(ht);
     }
 
-}
\ No newline at end of file
+}
+
+// Test function: void hashTable_stats(const HashTable* hashTable, HashTableStats* stats);
+void hashtable_stats_test(void)
+{
+    // Empty table, only the bucket arrays are allocated
+    {
+        register const size_t table_size = 4;
+        HashTable* ht = hashTable_new(table_size);
+        HashTableStats stats;
+
+        hashTable_stats(ht, &stats);
+
+        assert(stats.size == table_size);
+        assert(stats.noOfElems == 0);
+        assert(stats.loadFactor == 0.0);
+        assert(stats.occupiedBuckets == 0);
+        assert(stats.longestChain == 0);
+        assert(stats.meanChain == 0.0);
+        assert(stats.chainHistogram[0] == table_size);
+        assert(stats.bytesAllocated >= sizeof(*ht) + table_size * sizeof(Record*));
+
+        hashTable_delete(ht);
+    }
+
+    // Three colliding keys and one more in other bucket
+    {
+        register const size_t table_size = 6;
+        register const char* key = "keyOne";
+        char key2[24];
+        char key3[24];
+        register const char* key4 = "b";
+        HashTable* ht = hashTable_new(table_size);
+        HashTableStats empty;
+        HashTableStats stats;
+        test_colliding_key(key2, sizeof(key2), key, table_size, 0);
+        test_colliding_key(key3, sizeof(key3), key, table_size, 1);
+
+        hashTable_stats(ht, &empty);
+
+        hashTable_insert(ht, key, "valOne");
+        hashTable_insert(ht, key2, "valTwo");
+        hashTable_insert(ht, key3, "valThr");
+
+        // Confirm that first three keys collide and the last one does not
+        assert(hash_function(key, ht->size) == hash_function(key3, ht->size));
+        assert(hash_function(key4, ht->size) != hash_function(key, ht->size));
+        hashTable_insert(ht, key4, "c");
+
+        hashTable_stats(ht, &stats);
+
+        assert(stats.noOfElems == 4);
+        assert(stats.loadFactor > 0.66 && stats.loadFactor < 0.67);
+        assert(stats.occupiedBuckets == 2);
+        assert(stats.longestChain == 3);
+        assert(stats.meanChain == 2.0);
+        assert(stats.chainHistogram[0] == 4);
+        assert(stats.chainHistogram[1] == 1);
+        assert(stats.chainHistogram[3] == 1);
+
+        // Four records with inline strings, chains need no extra memory
+        assert(stats.bytesAllocated == empty.bytesAllocated + 4 * sizeof(Record));
+
+        // Long value is allocated separately
+        hashTable_insert(ht, key4, "value longer than the inline buffer");
+        hashTable_stats(ht, &stats);
+        assert(stats.bytesAllocated == empty.bytesAllocated + 4 * sizeof(Record) + 36);
+
+        hashTable_delete(ht);
+    }
+
+    // Chains longer than the histogram collect in the last bin
+    {
+        register const size_t table_size = 1;
+        HashTable* ht = hashTable_new(table_size);
+        HashTableStats stats;
+
+        // Table of size 1 accepts one element only, so the chain is built directly
+        hashTable_insert(ht, "k0", "v");
+        for (size_t i = 1; i <= HASHTABLE_STATS_BINS; ++i)
+        {
+            char key[8];
+            snprintf(key, sizeof(key), "k%zu", i);
+            handle_collision(ht, 0, record_new(key, "v"));
+            ht->noOfElems++;
+        }
+
+        hashTable_stats(ht, &stats);
+
+        assert(stats.longestChain == HASHTABLE_STATS_BINS + 1);
+        assert(stats.chainHistogram[HASHTABLE_STATS_BINS - 1] == 1);
+
+        hashTable_delete(ht);
+    }
+
+#ifdef HASHTABLE_COUNTERS
+    // Lookup counters, each compared record is one probe
+    {
+        register const size_t table_size = 3;
+        HashTable* ht = hashTable_new(table_size);
+        HashTableStats stats;
+        char keyTwo[24];
+        char keyThr[24];
+        test_colliding_key(keyTwo, sizeof(keyTwo), "keyOne", table_size, 0);
+        test_colliding_key(keyThr, sizeof(keyThr), "keyOne", table_size, 1);
+
+        hashTable_insert(ht, "keyOne", "valOne");
+        hashTable_insert(ht, keyTwo, "valTwo");
+
+        assert(hashTable_search(ht, "keyOne") != NULL); // record in the main array, 1 probe
+        assert(hashTable_search(ht, keyTwo) != NULL); // second record of the chain, 2 probes
+        assert(hashTable_search(ht, keyThr) == NULL); // whole chain checked, 2 probes
+
+        hashTable_stats(ht, &stats);
+        assert(stats.counters.lookups == 3);
+        assert(stats.counters.probes == 5);
+
+        hashTable_reset_counters(ht);
+        hashTable_stats(ht, &stats);
+        assert(stats.counters.lookups == 0);
+        assert(stats.counters.probes == 0);
+
+        hashTable_delete(ht);
+    }
+#else
+    // Without counters the pointer stays in the structure but nothing is allocated or counted
+    {
+        HashTable* ht = hashTable_new(3);
+        HashTableStats stats;
+
+        hashTable_insert(ht, "keyOne", "valOne");
+        assert(hashTable_search(ht, "keyOne") != NULL);
+        assert(ht->counters == NULL);
+
+        hashTable_reset_counters(ht);
+        hashTable_stats(ht, &stats);
+        assert(stats.counters.lookups == 0);
+        assert(stats.counters.probes == 0);
+
+        hashTable_delete(ht);
+    }
+#endif
+}
+
+// Test function: void hashTable_search_batch(const HashTable* hashTable, const char* const* keys, const char** values, size_t count);
+void hashtable_search_batch_test(void)
+{
+    // Incorrect arguments, output should not be touched
+    {
+        register const size_t table_size = 10;
+        HashTable* ht = hashTable_new(table_size);
+        const char* keys[] = {"keyOne"};
+        const char* values[] = {"untouched"};
+
+        hashTable_search_batch(NULL, keys, values, 1);
+        hashTable_search_batch(ht, NULL, values, 1);
+        hashTable_search_batch(ht, keys, NULL, 1);
+
+        assert(strcmp(values[0], "untouched") == 0);
+
+        hashTable_delete(ht);
+    }
+
+    // Hits, misses, NULL key and colliding keys in one batch
+    {
+        register const size_t table_size = 3;
+        HashTable* ht = hashTable_new(table_size);
+        char keyTwo[24];
+        char keyThr[24];
+        test_colliding_key(keyTwo, sizeof(keyTwo), "keyOne", table_size, 0);
+        test_colliding_key(keyThr, sizeof(keyThr), "keyOne", table_size, 1);
+        const char* keys[] = {keyThr, "missing", NULL, "keyOne", keyTwo, "keyOne"};
+        const char* values[6];
+
+        hashTable_insert(ht, "keyOne", "valOne");
+        hashTable_insert(ht, keyTwo, "valTwo");
+        hashTable_insert(ht, keyThr, "valThr");
+
+        hashTable_search_batch(ht, keys, values, 6);
+
+        assert(strcmp(values[0], "valThr") == 0);
+        assert(values[1] == NULL);
+        assert(values[2] == NULL);
+        assert(strcmp(values[3], "valOne") == 0);
+        assert(strcmp(values[4], "valTwo") == 0);
+        assert(strcmp(values[5], "valOne") == 0);
+
+        hashTable_delete(ht);
+    }
+
+    // More keys than one group, each result should equal hashTable_search
+    {
+        register const size_t table_size = 64;
+        register const size_t count = 3 * HASHTABLE_BATCH_GROUP + 5;
+        HashTable* ht = hashTable_new(table_size);
+        char storage[3 * HASHTABLE_BATCH_GROUP + 5][8];
+        const char* keys[3 * HASHTABLE_BATCH_GROUP + 5];
+        const char* values[3 * HASHTABLE_BATCH_GROUP + 5];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            snprintf(storage[i], sizeof(storage[i]), "key%zu", i);
+            keys[i] = storage[i];
+
+            // Only every second key is inserted
+            if (i % 2 == 0)
+            {
+                hashTable_insert(ht, keys[i], keys[i]);
+            }
+        }
+
+        hashTable_search_batch(ht, keys, values, count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            assert(values[i] == hashTable_search(ht, keys[i]));
+            assert((i % 2 == 0) == (values[i] != NULL));
+        }
+
+        hashTable_delete(ht);
+    }
+}
+
+// Test function: int hashTable_bloom_enable(HashTable* hashTable, size_t bitsPerKey, int mode);
+void hashtable_bloom_test(void)
+{
+    // Incorrect arguments
+    {
+        register const size_t table_size = 10;
+        HashTable* ht = hashTable_new(table_size);
+
+        assert(hashTable_bloom_enable(NULL, 0, HASHTABLE_BLOOM_PLAIN) == -1);
+        assert(hashTable_bloom_enable(ht, 0, 7) == -1);
+        assert(hashTable_bloom_rebuild(NULL) == -1);
+        assert(hashTable_bloom_rebuild(ht) == -1);
+        hashTable_bloom_disable(NULL);
+        assert(ht->bloom == NULL);
+
+        hashTable_delete(ht);
+    }
+
+    // Present keys always pass, absent keys are mostly rejected without probing buckets
+    {
+        register const size_t table_size = 64;
+        HashTable* ht = hashTable_new(table_size);
+        char key[16];
+
+        for (size_t i = 0; i < 32; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            hashTable_insert(ht, key, key);
+        }
+
+        assert(hashTable_bloom_enable(ht, 0, HASHTABLE_BLOOM_PLAIN) == 0);
+        assert(ht->bloom != NULL);
+        assert(ht->bloom->bitsPerKey == HASHTABLE_BLOOM_BITS_PER_KEY);
+        assert((uintptr_t)ht->bloom->words % 64 == 0);
+
+        // Keys inserted after enabling are added too
+        hashTable_insert(ht, "late", "lateVal");
+        assert(strcmp(hashTable_search(ht, "late"), "lateVal") == 0);
+
+        hashTable_reset_counters(ht);
+        for (size_t i = 0; i < 32; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            assert(strcmp(hashTable_search(ht, key), key) == 0);
+        }
+        assert(ht->counters == NULL || ht->counters->filtered == 0);
+
+        for (size_t i = 100; i < 200; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            assert(hashTable_search(ht, key) == NULL);
+        }
+        assert(ht->counters == NULL || ht->counters->filtered > 90);
+
+        hashTable_bloom_disable(ht);
+        assert(ht->bloom == NULL);
+        assert(strcmp(hashTable_search(ht, "key5"), "key5") == 0);
+
+        hashTable_delete(ht);
+    }
+
+    // Plain filter keeps deleted keys until rebuild, counting filter forgets them immediately
+    {
+        register const size_t table_size = 64;
+        HashTable* ht = hashTable_new(table_size);
+        register const char* key = "keyOne";
+
+        hashTable_insert(ht, key, "valOne");
+        hashTable_insert(ht, "keyTwo", "valTwo");
+
+        assert(hashTable_bloom_enable(ht, 16, HASHTABLE_BLOOM_PLAIN) == 0);
+        hashTable_delete_record(ht, key);
+        assert(bloom_may_contain(ht->bloom, key_hash(key)) == 1);
+        assert(hashTable_bloom_rebuild(ht) == 0);
+        assert(ht->bloom->bitsPerKey == 16 && ht->bloom->mode == HASHTABLE_BLOOM_PLAIN);
+        assert(bloom_may_contain(ht->bloom, key_hash(key)) == 0);
+        assert(strcmp(hashTable_search(ht, "keyTwo"), "valTwo") == 0);
+
+        hashTable_insert(ht, key, "valOne");
+        assert(hashTable_bloom_enable(ht, 0, HASHTABLE_BLOOM_COUNTING) == 0);
+        assert(bloom_may_contain(ht->bloom, key_hash(key)) == 1);
+        hashTable_delete_record(ht, key);
+        assert(bloom_may_contain(ht->bloom, key_hash(key)) == 0);
+        assert(hashTable_search(ht, key) == NULL);
+        assert(strcmp(hashTable_search(ht, "keyTwo"), "valTwo") == 0);
+
+        hashTable_delete(ht);
+    }
+
+    // Colliding keys with counting filter, batch search gives the same results as hashTable_search
+    {
+        register const size_t table_size = 6;
+        HashTable* ht = hashTable_new(table_size);
+        const char* keys[] = {"keyOne", "keyTwo", "keyThr", "missing", NULL, "absent"};
+        const char* values[6];
+
+        hashTable_insert(ht, "keyOne", "valOne");
+        hashTable_insert(ht, "keyTwo", "valTwo");
+        hashTable_insert(ht, "keyThr", "valThr");
+        assert(hashTable_bloom_enable(ht, 0, HASHTABLE_BLOOM_COUNTING) == 0);
+
+        // keyTwo is in the chain of keyOne
+        hashTable_delete_record(ht, "keyTwo");
+
+        hashTable_search_batch(ht, keys, values, 6);
+        for (size_t i = 0; i < 6; ++i)
+        {
+            assert(values[i] == hashTable_search(ht, keys[i]));
+        }
+        assert(strcmp(values[0], "valOne") == 0);
+        assert(values[1] == NULL);
+        assert(strcmp(values[2], "valThr") == 0);
+
+        HashTableStats stats;
+        hashTable_stats(ht, &stats);
+        assert(stats.bytesAllocated > sizeof(HashTableBloom) + ht->bloom->blocks * 64);
+
+        hashTable_delete(ht);
+    }
+}
+
+// Test function: int hashTable_cache_enable(HashTable* hashTable, size_t maxElems, size_t maxBytes);
+void hashtable_cache_test(void)
+{
+    // Incorrect arguments
+    {
+        assert(hashTable_cache_enable(NULL, 1, 0) == -1);
+        hashTable_cache_disable(NULL);
+    }
+
+    // Full table refuses inserts, the same table in cache mode evicts
+    {
+        register const size_t table_size = 2;
+        HashTable* ht = hashTable_new(table_size);
+
+        hashTable_insert(ht, "a", "valA");
+        hashTable_insert(ht, "b", "valB");
+        hashTable_insert(ht, "c", "valC");
+        assert(ht->noOfElems == 2);
+        assert(hashTable_search(ht, "c") == NULL);
+
+        assert(hashTable_cache_enable(ht, 0, 0) == 0);
+        hashTable_insert(ht, "c", "valC");
+        assert(ht->noOfElems == 2);
+        assert(ht->cache->evictions == 1);
+        assert(strcmp(hashTable_search(ht, "c"), "valC") == 0);
+
+        hashTable_cache_disable(ht);
+        assert(ht->cache == NULL);
+        hashTable_insert(ht, "d", "valD");
+        assert(hashTable_search(ht, "d") == NULL);
+
+        hashTable_delete(ht);
+    }
+
+    // Entry budget, referenced records survive the eviction
+    {
+        register const size_t table_size = 10;
+        HashTable* ht = hashTable_new(table_size);
+        assert(hashTable_cache_enable(ht, 3, 0) == 0);
+
+        hashTable_insert(ht, "a", "valA");
+        hashTable_insert(ht, "b", "valB");
+        hashTable_insert(ht, "c", "valC");
+        assert(ht->noOfElems == 3);
+        assert(ht->cache->evictions == 0);
+
+        // Lookups only set the reference bit
+        assert(strcmp(hashTable_search(ht, "a"), "valA") == 0);
+        assert(strcmp(hashTable_search(ht, "c"), "valC") == 0);
+        assert(hashTable_search(ht, "x") == NULL);
+        assert(ht->cache->hits == 2);
+        assert(ht->cache->misses == 1);
+        assert(ht->records[hash_function("a", ht->size)]->flags & RECORD_REFERENCED);
+
+        hashTable_insert(ht, "d", "valD");
+        assert(ht->noOfElems == 3);
+        assert(ht->cache->evictions == 1);
+        assert(hashTable_search(ht, "b") == NULL);
+        assert(hashTable_search(ht, "a") != NULL);
+        assert(hashTable_search(ht, "c") != NULL);
+        assert(hashTable_search(ht, "d") != NULL);
+
+        // Update of present key doesn't need an entry
+        hashTable_insert(ht, "d", "newValD");
+        assert(ht->cache->evictions == 1);
+        assert(strcmp(hashTable_search(ht, "d"), "newValD") == 0);
+
+        // Lower budget evicts immediately, counters are kept
+        assert(hashTable_cache_enable(ht, 1, 0) == 0);
+        assert(ht->noOfElems == 1);
+        assert(ht->cache->evictions == 3);
+
+        HashTableStats stats;
+        hashTable_stats(ht, &stats);
+        assert(stats.cache.maxElems == 1);
+        assert(stats.cache.evictions == 3);
+        assert(stats.cache.hits == ht->cache->hits);
+
+        hashTable_delete(ht);
+    }
+
+    // Memory budget, colliding keys
+    {
+        register const size_t table_size = 6;
+        HashTable* ht = hashTable_new(table_size);
+        register const size_t recordSize = record_bytes("keyOne", "valOne");
+        assert(hashTable_cache_enable(ht, 0, 2 * recordSize) == 0);
+
+        hashTable_insert(ht, "keyOne", "valOne");
+        hashTable_insert(ht, "keyTwo", "valTwo");
+        assert(ht->cache->bytes == 2 * recordSize);
+
+        hashTable_insert(ht, "keyThr", "valThr");
+        assert(ht->noOfElems == 2);
+        assert(ht->cache->bytes == 2 * recordSize);
+        assert(ht->cache->evictions == 1);
+        assert(strcmp(hashTable_search(ht, "keyThr"), "valThr") == 0);
+
+        // Longer value needs more room, record bigger than the whole budget is refused
+        hashTable_insert(ht, "keyThr", "longerValue");
+        assert(ht->noOfElems == 1);
+        assert(strcmp(hashTable_search(ht, "keyThr"), "longerValue") == 0);
+        char huge[2 * sizeof(Record) + 64];
+        memset(huge, 'h', sizeof(huge) - 1);
+        huge[sizeof(huge) - 1] = '\0';
+        hashTable_insert(ht, "huge", huge);
+        assert(hashTable_search(ht, "huge") == NULL);
+        assert(ht->noOfElems == 1);
+
+        hashTable_delete_record(ht, "keyThr");
+        assert(ht->cache->bytes == 0);
+
+        hashTable_delete(ht);
+    }
+
+    // Concurrent lookups, every hit, miss, reference bit and counter is recorded
+    {
+        register const size_t table_size = 64;
+        register const size_t threadCount = 4;
+        HashTable* ht = hashTable_new(table_size);
+        pthread_t threads[4];
+        char key[24];
+
+        assert(hashTable_cache_enable(ht, 0, 0) == 0);
+        for (size_t i = 0; i < table_size / 2; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            hashTable_insert(ht, key, key);
+        }
+        hashTable_reset_counters(ht);
+
+        for (size_t t = 0; t < threadCount; ++t)
+        {
+            assert(pthread_create(&threads[t], NULL, test_search_worker, ht) == 0);
+        }
+        for (size_t t = 0; t < threadCount; ++t)
+        {
+            assert(pthread_join(threads[t], NULL) == 0);
+        }
+
+        assert(ht->cache->hits == threadCount * 100 * table_size / 2);
+        assert(ht->cache->misses == threadCount * 100 * table_size / 2);
+        assert(ht->counters == NULL || ht->counters->lookups == threadCount * 100 * table_size);
+        for (size_t i = 0; i < table_size / 2; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            assert(test_record(ht, key)->flags & RECORD_REFERENCED);
+        }
+
+        hashTable_delete(ht);
+    }
+}
+
+// Test function: void hashTable_insert_ttl(HashTable* hashTable, const char* key, const char* value, uint64_t ttl);
+// Test function: size_t hashTable_expire(HashTable* hashTable, uint64_t now, size_t maxWork);
+void hashtable_ttl_test(void)
+{
+    // Incorrect arguments
+    {
+        HashTable* ht = hashTable_new(10);
+
+        hashTable_insert_ttl(NULL, "key", "val", 1);
+        hashTable_insert_ttl(ht, NULL, "val", 1);
+        hashTable_insert_ttl(ht, "key", NULL, 1);
+        assert(ht->noOfElems == 0);
+        assert(hashTable_expire(NULL, 10, 10) == 0);
+
+        hashTable_delete(ht);
+    }
+
+    // Insert refused by a full table allocates no wheel
+    {
+        HashTable* ht = hashTable_new(1);
+
+        hashTable_insert(ht, "keyOne", "valOne");
+        hashTable_insert_ttl(ht, "keyTwo", "valTwo", 5);
+        assert(ht->noOfElems == 1);
+        assert(hashTable_search(ht, "keyTwo") == NULL);
+        assert(ht->wheel == NULL);
+
+        hashTable_delete(ht);
+    }
+
+    // Expiry is lazy on lookup and records are deleted by hashTable_expire in bounded batches
+    {
+        register const size_t table_size = 64;
+        HashTable* ht = hashTable_new(table_size);
+        char key[16];
+
+        // No wheel is allocated for a table without TTL records, its time stays 0
+        assert(hashTable_expire(ht, 1000, SIZE_MAX) == 0);
+        assert(ht->wheel == NULL);
+        hashTable_insert_ttl(ht, "short", "valShort", 1010);
+        hashTable_insert_ttl(ht, "long", "valLong", 1100);
+        hashTable_insert(ht, "forever", "valForever");
+        assert(ht->noOfElems == 3);
+        assert(ht->records[hash_function("short", ht->size)]->timer->expiresAt == 1010);
+
+        assert(hashTable_expire(ht, 1009, SIZE_MAX) == 0);
+        assert(strcmp(hashTable_search(ht, "short"), "valShort") == 0);
+        assert(hashTable_expire(ht, 1010, SIZE_MAX) == 1);
+        assert(hashTable_search(ht, "short") == NULL);
+        assert(ht->noOfElems == 2);
+
+        // Hidden before deleted
+        assert(hashTable_expire(ht, 1100, 0) == 0);
+        assert(hashTable_search(ht, "long") == NULL);
+        assert(ht->noOfElems == 2);
+        assert(hashTable_expire(ht, 1100, 1) == 1);
+        assert(ht->noOfElems == 1);
+        assert(strcmp(hashTable_search(ht, "forever"), "valForever") == 0);
+
+        for (size_t i = 0; i < 50; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            hashTable_insert_ttl(ht, key, key, 7);
+        }
+        assert(hashTable_expire(ht, 1107, 20) == 20);
+        assert(hashTable_expire(ht, 1107, 20) == 20);
+        assert(hashTable_expire(ht, 1107, 20) == 10);
+        assert(ht->noOfElems == 1);
+
+        hashTable_delete(ht);
+    }
+
+    // Update without TTL makes the record permanent, update with TTL replaces the timer
+    {
+        register const size_t table_size = 3;
+        HashTable* ht = hashTable_new(table_size);
+
+        hashTable_insert_ttl(ht, "keyOne", "valOne", 5);
+        hashTable_insert_ttl(ht, "keyTwo", "valTwo", 5);
+        hashTable_insert(ht, "keyTwo", "newTwo");
+        hashTable_insert_ttl(ht, "keyOne", "newOne", 50);
+        assert(ht->noOfElems == 2);
+
+        // Only the new timer of keyOne is left
+        assert(ht->wheel->pending[0] == 1);
+        assert(ht->wheel->slots[0][50]->record == ht->records[hash_function("keyOne", ht->size)]);
+
+        assert(hashTable_expire(ht, 5, SIZE_MAX) == 0);
+        assert(strcmp(hashTable_search(ht, "keyOne"), "newOne") == 0);
+        assert(strcmp(hashTable_search(ht, "keyTwo"), "newTwo") == 0);
+
+        // Deleted record takes its timer with it
+        hashTable_insert_ttl(ht, "keyThr", "valThr", 1);
+        hashTable_delete_record(ht, "keyThr");
+        assert(hashTable_expire(ht, 50, SIZE_MAX) == 1);
+        assert(strcmp(hashTable_search(ht, "keyTwo"), "newTwo") == 0);
+        assert(ht->noOfElems == 1);
+
+        hashTable_delete(ht);
+    }
+
+    // Random expiry times across all wheel levels and far timers, checked after random time steps
+    {
+        register const size_t table_size = 512;
+        register const size_t count = 400;
+        HashTable* ht = hashTable_new(table_size);
+        uint64_t expiresAt[400];
+        uint64_t seed = 12345;
+        uint64_t now = 0;
+        char key[16];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            seed = seed * 6364136223846793005u + 1442695040888963407u;
+            const uint64_t ttl = (seed >> 33) % ((i % 4 == 0) ? (UINT64_C(1) << 27) : 5000);
+            snprintf(key, sizeof(key), "key%zu", i);
+            hashTable_insert_ttl(ht, key, key, ttl);
+            expiresAt[i] = now + ttl;
+        }
+
+        while (ht->noOfElems > 0)
+        {
+            seed = seed * 6364136223846793005u + 1442695040888963407u;
+            now += (seed >> 33) % ((seed & 1) ? 300 : (UINT64_C(1) << 22));
+            hashTable_expire(ht, now, SIZE_MAX);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                snprintf(key, sizeof(key), "key%zu", i);
+                assert((find_record(ht, key, key_hash(key), hash_function(key, ht->size)) != NULL) == (expiresAt[i] > now));
+            }
+        }
+
+        for (size_t level = 0; level <= HASHTABLE_WHEEL_DUE; ++level)
+        {
+            assert(ht->wheel->pending[level] == 0);
+        }
+
+        hashTable_delete(ht);
+    }
+
+    // Far timers far apart, time jumps straight to the range of the earliest one
+    {
+        register const size_t table_size = 16;
+        HashTable* ht = hashTable_new(table_size);
+
+        hashTable_insert_ttl(ht, "near", "valNear", 100);
+        hashTable_insert_ttl(ht, "far", "valFar", UINT64_C(1) << 40);
+        hashTable_insert_ttl(ht, "farther", "valFarther", (UINT64_C(1) << 62) + 7);
+        assert(ht->wheel->pending[HASHTABLE_WHEEL_FAR] == 2);
+
+        assert(hashTable_expire(ht, UINT64_C(1) << 39, SIZE_MAX) == 1);
+        assert(ht->wheel->pending[HASHTABLE_WHEEL_FAR] == 2);
+        assert(hashTable_expire(ht, (UINT64_C(1) << 62) + 6, SIZE_MAX) == 1);
+        assert(strcmp(hashTable_search(ht, "farther"), "valFarther") == 0);
+        assert(ht->wheel->pending[0] == 1);
+        assert(hashTable_expire(ht, UINT64_MAX, SIZE_MAX) == 1);
+        assert(ht->noOfElems == 0);
+
+        hashTable_delete(ht);
+    }
+}
+
+static const Record* test_record(const HashTable* ht, const char* key)
+{
+    return find_record(ht, key, key_hash(key), hash_function(key, ht->size));
+}
+
+static char* test_strdup(const char* str)
+{
+    char* copy = malloc(strlen(str) + 1);
+    assert(copy != NULL);
+    return strcpy(copy, str);
+}
+
+// Test function: int hashTable_insert_owned(HashTable* hashTable, char* key, char* value);
+// Test function: int hashTable_insert_borrowed(HashTable* hashTable, const char* key, const char* value);
+void hashtable_insert_zero_copy_test(void)
+{
+    // Incorrect arguments, refused buffers stay with the caller
+    {
+        HashTable* ht = hashTable_new(1);
+        char* key = test_strdup("keyOne");
+        char* val = test_strdup("valOne");
+
+        assert(hashTable_insert_owned(NULL, key, val) == -1);
+        assert(hashTable_insert_owned(ht, NULL, val) == -1);
+        assert(hashTable_insert_owned(ht, key, NULL) == -1);
+        assert(hashTable_insert_borrowed(NULL, "key", "val") == -1);
+        assert(hashTable_insert_borrowed(ht, NULL, "val") == -1);
+        assert(hashTable_insert_borrowed(ht, "key", NULL) == -1);
+
+        // Table full
+        assert(hashTable_insert_borrowed(ht, "keyTwo", "valTwo") == 0);
+        assert(hashTable_insert_owned(ht, key, val) == -1);
+        assert(ht->noOfElems == 1);
+
+        free(key);
+        free(val);
+        hashTable_delete(ht);
+    }
+
+    // Owned buffers are stored as they are and freed with the table
+    {
+        HashTable* ht = hashTable_new(3);
+        char* key = test_strdup("keyOne");
+        char* val = test_strdup("valOne");
+
+        assert(hashTable_insert_owned(ht, key, val) == 0);
+        assert(hashTable_insert_owned(ht, test_strdup("keyTwo"), test_strdup("valTwo")) == 0);
+        assert(ht->noOfElems == 2);
+
+        const Record* record = test_record(ht, "keyOne");
+        assert(record != NULL && record_key(record) == key && record_value(record) == val);
+        assert(record->flags == 0);
+
+        // Update releases the new key and the old value
+        char* newVal = test_strdup("newValue");
+        assert(hashTable_insert_owned(ht, test_strdup("keyOne"), newVal) == 0);
+        assert(ht->noOfElems == 2);
+        record = test_record(ht, "keyOne");
+        assert(record_key(record) == key && record_value(record) == newVal);
+
+        hashTable_delete_record(ht, "keyTwo");
+        assert(hashTable_search(ht, "keyTwo") == NULL);
+        hashTable_delete(ht);
+    }
+
+    // Borrowed pointers are kept, neither written nor freed
+    {
+        HashTable* ht = hashTable_new(6);
+        static const char key[] = "keyOne";
+        static const char val[] = "valOne";
+
+        assert(hashTable_insert_borrowed(ht, key, val) == 0);
+        assert(hashTable_insert_borrowed(ht, "keyTwo", "valTwo") == 0);
+        assert(hashTable_insert_borrowed(ht, "keyThr", "valThr") == 0);
+        assert(ht->noOfElems == 3);
+
+        const Record* record = test_record(ht, "keyOne");
+        assert(record_key(record) == key && record_value(record) == val);
+        assert(record->flags == (RECORD_KEY_BORROWED | RECORD_VALUE_BORROWED));
+
+        // Copying update of a borrowed value makes own copy, borrowed key is kept
+        hashTable_insert(ht, "keyOne", "valNew");
+        record = test_record(ht, "keyOne");
+        assert(record_key(record) == key && record_value(record) != val);
+        assert(strcmp(record_value(record), "valNew") == 0);
+        assert(strcmp(val, "valOne") == 0);
+        assert(record->flags == (RECORD_KEY_BORROWED | RECORD_VALUE_INLINE));
+
+        // Borrowed update releases owned value
+        assert(hashTable_insert_borrowed(ht, "keyOne", val) == 0);
+        record = test_record(ht, "keyOne");
+        assert(record_value(record) == val);
+        assert(record->flags == (RECORD_KEY_BORROWED | RECORD_VALUE_BORROWED));
+
+        // Mixed with owned records in one collision chain
+        assert(hashTable_insert_owned(ht, test_strdup("keyFou"), test_strdup("valFou")) == 0);
+        hashTable_delete_record(ht, "keyTwo");
+        hashTable_delete_record(ht, "keyOne");
+        assert(strcmp(hashTable_search(ht, "keyThr"), "valThr") == 0);
+        assert(strcmp(hashTable_search(ht, "keyFou"), "valFou") == 0);
+        assert(ht->noOfElems == 2);
+
+        hashTable_delete(ht);
+    }
+}
+
+// Test function: int key_equals(const Record* record, const char* key, uint64_t hash);
+// Test function: void record_set_value(HashTable* hashTable, Record* record, const char* value);
+void hashtable_inline_strings_test(void)
+{
+    // Inline keys are equal only to the same string, not to its prefixes or extensions
+    {
+        Record* record = record_new("category", "v");
+
+        assert(key_equals(record, "category", key_hash("category")));
+        assert(!key_equals(record, "categor", key_hash("categor")));
+        assert(!key_equals(record, "category1", key_hash("category1")));
+        assert(!key_equals(record, "categoryXXXXXXXXXXXXXXXXXXXXXXXXXXXXX", key_hash("categoryXXXXXXXXXXXXXXXXXXXXXXXXXXXXX")));
+        assert(!key_equals(record, "", key_hash("")));
+
+        // Inline key is padded with zeros up to the last word compared
+        const char* stored = (const char*)record->key.words;
+        for (size_t i = strlen("category"); i < RECORD_INLINE_SIZE; ++i)
+        {
+            assert(stored[i] == '\0');
+        }
+
+        // Stored hash decides before the strings are read
+        assert(!key_equals(record, "category", record->hash ^ 1));
+
+        record_delete(record);
+    }
+
+    // Keys around the inline limit, inline and allocated ones in one table
+    {
+        HashTable* ht = hashTable_new(64);
+        char key[64];
+
+        for (size_t len = 1; len < sizeof(key); ++len)
+        {
+            memset(key, 'a', len);
+            key[len] = '\0';
+            hashTable_insert(ht, key, key);
+        }
+        assert(ht->noOfElems == sizeof(key) - 1);
+
+        for (size_t len = 1; len < sizeof(key); ++len)
+        {
+            memset(key, 'a', len);
+            key[len] = '\0';
+            assert(strcmp(hashTable_search(ht, key), key) == 0);
+        }
+
+        hashTable_delete(ht);
+    }
+
+    // Value moves between inline buffer and own allocation on update
+    {
+        HashTable* ht = hashTable_new(6);
+        static const char longValue[] = "value longer than the inline buffer";
+
+        hashTable_insert(ht, "keyOne", "short");
+        hashTable_insert(ht, "keyOne", longValue);
+        const Record* record = find_record(ht, "keyOne", key_hash("keyOne"), hash_function("keyOne", ht->size));
+        assert(!(record->flags & RECORD_VALUE_INLINE));
+        assert(strcmp(record_value(record), longValue) == 0);
+
+        hashTable_insert(ht, "keyOne", "back");
+        assert(record->flags & RECORD_VALUE_INLINE);
+        assert(record_value(record) == (const char*)record->value.words);
+        assert(strcmp(hashTable_search(ht, "keyOne"), "back") == 0);
+
+        hashTable_insert(ht, "keyOne", "four");
+        assert(record_value(record) == (const char*)record->value.words);
+        assert(strcmp(hashTable_search(ht, "keyOne"), "four") == 0);
+
+        hashTable_delete(ht);
+    }
+
+    // Bulk loaded tables use inline buffers too
+    {
+        const char* keys[] = {"keyOne", "a key which is too long to be stored inline"};
+        const char* values[] = {"a value which is too long to be stored inline", "valTwo"};
+        HashTable* ht = hashTable_new_from_arrays(keys, values, 2, 1);
+
+        assert(strcmp(hashTable_search(ht, keys[0]), values[0]) == 0);
+        assert(strcmp(hashTable_search(ht, keys[1]), values[1]) == 0);
+        hashTable_insert(ht, keys[1], "new value which is too long to be stored inline");
+        hashTable_insert(ht, keys[0], "new");
+        assert(strcmp(hashTable_search(ht, keys[0]), "new") == 0);
+
+        hashTable_delete(ht);
+    }
+}
+
+// Writes the n-th key "<base><number>" which falls into the bucket of base in a table of given size
+static void test_colliding_key(char* key, size_t keySize, const char* base, size_t tableSize, size_t n)
+{
+    const size_t index = hash_function(base, tableSize);
+
+    for (size_t number = 0;; ++number)
+    {
+        snprintf(key, keySize, "%s%zu", base, number);
+        if (hash_function(key, tableSize) == index && n-- == 0)
+        {
+            return;
+        }
+    }
+}
+
+// Chain of the bucket holds the same records as its sorted index, in the same increasing order
+static void test_sorted_bucket(const HashTable* ht, size_t index)
+{
+    const HashTableSortedBucket* sorted = ht->sortedBuckets[index];
+    const Record* record = ht->records[index];
+
+    assert(sorted != NULL);
+    assert(sorted->count <= sorted->capacity);
+    for (size_t i = 0; i < sorted->count; ++i, record = record->next)
+    {
+        assert(sorted->records[i] == record);
+        if (i > 0)
+        {
+            assert(record_compare(sorted->records[i - 1], record->hash, record_key(record)) < 0);
+        }
+    }
+    assert(record == NULL);
+}
+
+// Test functions: sorted index of long chains, used by all operations of HashTable
+void hashtable_treeify_test(void)
+{
+    char key[16];
+
+    // Chain is indexed when it grows over the threshold and the index is dropped when it shrinks
+    {
+        HashTable* ht = hashTable_new(64);
+        test_colliding_key(key, sizeof(key), "key", 64, 0);
+        const size_t index = hash_function(key, ht->size);
+        HashTableStats stats;
+
+        for (size_t n = 0; n < HASHTABLE_TREEIFY_THRESHOLD; ++n)
+        {
+            test_colliding_key(key, sizeof(key), "key", 64, n);
+            hashTable_insert(ht, key, key);
+            assert(hash_function(key, ht->size) == index);
+        }
+        assert(ht->sortedBuckets == NULL);
+
+        for (size_t n = HASHTABLE_TREEIFY_THRESHOLD; n < 24; ++n)
+        {
+            test_colliding_key(key, sizeof(key), "key", 64, n);
+            hashTable_insert(ht, key, key);
+            test_sorted_bucket(ht, index);
+        }
+
+        hashTable_stats(ht, &stats);
+        assert(stats.noOfElems == 24);
+        assert(stats.longestChain == 24);
+        assert(stats.sortedBuckets == 1);
+
+        // Every lookup bisects the 24 records, at most 5 compares
+        hashTable_reset_counters(ht);
+        for (size_t n = 0; n < 24; ++n)
+        {
+            test_colliding_key(key, sizeof(key), "key", 64, n);
+            assert(strcmp(hashTable_search(ht, key), key) == 0);
+        }
+        assert(hashTable_search(ht, "key") == NULL);
+        hashTable_stats(ht, &stats);
+        assert(ht->counters == NULL || stats.counters.lookups == 25);
+        assert(stats.counters.probes <= 25 * 5);
+
+        // Update keeps the record and its position
+        test_colliding_key(key, sizeof(key), "key", 64, 5);
+        hashTable_insert(ht, key, "updated");
+        assert(strcmp(hashTable_search(ht, key), "updated") == 0);
+        assert(ht->noOfElems == 24);
+        test_sorted_bucket(ht, index);
+
+        int deleted[24] = {0};
+        for (size_t n = 0; n < 24 - HASHTABLE_UNTREEIFY_THRESHOLD - 1; ++n)
+        {
+            deleted[n * 7 % 24] = 1;
+            test_colliding_key(key, sizeof(key), "key", 64, n * 7 % 24);
+            hashTable_delete_record(ht, key);
+            assert(hashTable_search(ht, key) == NULL);
+            test_sorted_bucket(ht, index);
+        }
+
+        // One more delete leaves HASHTABLE_UNTREEIFY_THRESHOLD records in a plain chain
+        size_t last = 0;
+        while (deleted[last])
+        {
+            last++;
+        }
+        deleted[last] = 1;
+        test_colliding_key(key, sizeof(key), "key", 64, last);
+        hashTable_delete_record(ht, key);
+        assert(ht->sortedBuckets[index] == NULL);
+        assert(ht->noOfElems == HASHTABLE_UNTREEIFY_THRESHOLD);
+
+        for (size_t n = 0; n < 24; ++n)
+        {
+            test_colliding_key(key, sizeof(key), "key", 64, n);
+            assert((hashTable_search(ht, key) != NULL) == !deleted[n]);
+        }
+
+        hashTable_delete(ht);
+    }
+
+    // Expiry and eviction unlink records of indexed chains too
+    {
+        HashTable* ht = hashTable_new(64);
+        test_colliding_key(key, sizeof(key), "key", 64, 0);
+        const size_t index = hash_function(key, ht->size);
+
+        for (size_t n = 0; n < 24; ++n)
+        {
+            test_colliding_key(key, sizeof(key), "key", 64, n);
+            hashTable_insert_ttl(ht, key, key, n % 2 == 0 ? 10 : 1000);
+        }
+        test_sorted_bucket(ht, index);
+
+        assert(hashTable_expire(ht, 100, 100) == 12);
+        test_sorted_bucket(ht, index);
+        for (size_t n = 0; n < 24; ++n)
+        {
+            test_colliding_key(key, sizeof(key), "key", 64, n);
+            assert((hashTable_search(ht, key) != NULL) == (n % 2 == 1));
+        }
+
+        assert(hashTable_cache_enable(ht, 10, 0) == 0);
+        assert(ht->noOfElems == 10);
+        test_sorted_bucket(ht, index);
+
+        hashTable_delete(ht);
+    }
+
+    // Bulk loaded chains are indexed as well
+    {
+        char keys[24][16];
+        const char* keyPtrs[24];
+        for (size_t n = 0; n < 24; ++n)
+        {
+            test_colliding_key(keys[n], sizeof(keys[n]), "key", 24, n);
+            keyPtrs[n] = keys[n];
+        }
+
+        HashTable* ht = hashTable_new_from_arrays(keyPtrs, keyPtrs, 24, 2);
+        const size_t index = hash_function(keys[0], ht->size);
+        test_sorted_bucket(ht, index);
+
+        for (size_t n = 0; n < 24; ++n)
+        {
+            assert(strcmp(hashTable_search(ht, keys[n]), keys[n]) == 0);
+        }
+
+        hashTable_delete(ht);
+    }
+}
+
+// Test functions: void hashTable_iterator_init(HashTableIterator* iterator, const HashTable* hashTable);
+//                 const Record* hashTable_iterator_next(HashTableIterator* iterator);
+void hashtable_iterator_test(void)
+{
+    // Incorrect arguments and empty table
+    {
+        HashTableIterator iterator;
+        hashTable_iterator_init(NULL, NULL);
+        assert(hashTable_iterator_next(NULL) == NULL);
+
+        hashTable_iterator_init(&iterator, NULL);
+        assert(hashTable_iterator_next(&iterator) == NULL);
+
+        HashTable* ht = hashTable_new(5);
+        hashTable_iterator_init(&iterator, ht);
+        assert(hashTable_iterator_next(&iterator) == NULL);
+        assert(hashTable_iterator_next(&iterator) == NULL);
+        hashTable_delete(ht);
+    }
+
+    // Every record is returned once, colliding ones too, expired ones are skipped
+    {
+        HashTable* ht = hashTable_new(6);
+        hashTable_insert(ht, "keyOne", "valueOne");
+        hashTable_insert(ht, "keyTwo", "valueTwo");
+        hashTable_insert(ht, "keyThr", "valueThr");
+        hashTable_insert(ht, "other", "valueOther");
+        hashTable_insert_ttl(ht, "short", "lived", 5);
+        hashTable_expire(ht, 10, 0);
+
+        HashTableIterator iterator;
+        size_t count = 0;
+        int seen = 0;
+        hashTable_iterator_init(&iterator, ht);
+        for (const Record* record = hashTable_iterator_next(&iterator); record != NULL; record = hashTable_iterator_next(&iterator))
+        {
+            assert(strcmp(record_key(record), "short") != 0);
+            assert(strcmp(hashTable_search(ht, record_key(record)), record_value(record)) == 0);
+            seen |= strcmp(record_key(record), "keyOne") == 0 ? 1 : strcmp(record_key(record), "keyTwo") == 0 ? 2 :
+                    strcmp(record_key(record), "keyThr") == 0 ? 4 : 8;
+            count++;
+        }
+        assert(count == 4);
+        assert(seen == 15);
+
+        hashTable_delete(ht);
+    }
+
+    // Returned record can be deleted during the iteration
+    {
+        HashTable* ht = hashTable_new(6);
+        hashTable_insert(ht, "keyOne", "valueOne");
+        hashTable_insert(ht, "keyTwo", "valueTwo");
+        hashTable_insert(ht, "keyThr", "valueThr");
+        hashTable_insert(ht, "other", "valueOther");
+
+        HashTableIterator iterator;
+        size_t count = 0;
+        char key[16];
+        hashTable_iterator_init(&iterator, ht);
+        for (const Record* record = hashTable_iterator_next(&iterator); record != NULL; record = hashTable_iterator_next(&iterator))
+        {
+            strcpy(key, record_key(record));
+            hashTable_delete_record(ht, key);
+            count++;
+        }
+        assert(count == 4);
+        assert(ht->noOfElems == 0);
+
+        hashTable_delete(ht);
+    }
+}
+
+// Counts passed records per key, context is an array indexed by the number after "key"
+static void* test_search_worker(void* arg)
+{
+    const HashTable* ht = arg;
+    char key[16];
+
+    // Keys of the first half of the table size are present, the others not
+    for (size_t round = 0; round < 100; ++round)
+    {
+        for (size_t i = 0; i < 64; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            const char* value = hashTable_search(ht, key);
+            assert((value != NULL) == (i < 32));
+        }
+    }
+
+    return NULL;
+}
+
+static void test_scan_count(const char* key, const char* value, void* context)
+{
+    size_t* counts = context;
+    assert(strcmp(key, value) == 0);
+    counts[strtoul(key + 3, NULL, 10)]++;
+}
+
+// Test function: size_t hashTable_scan(const HashTable* hashTable, size_t cursor, size_t count,
+//                                      HashTableScanCallback callback, void* context);
+void hashtable_scan_test(void)
+{
+    size_t counts[400];
+    char key[16];
+
+    // Incorrect arguments
+    {
+        HashTable* ht = hashTable_new(5);
+        assert(hashTable_scan(NULL, 0, 10, test_scan_count, counts) == 0);
+        assert(hashTable_scan(ht, 0, 10, NULL, counts) == 0);
+        assert(hashTable_scan(ht, 5, 10, test_scan_count, counts) == 0);
+        hashTable_delete(ht);
+    }
+
+    // Small steps over the whole table, every key is passed once
+    {
+        HashTable* ht = hashTable_new(300);
+        for (size_t i = 0; i < 200; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            hashTable_insert(ht, key, key);
+        }
+
+        memset(counts, 0, sizeof(counts));
+        size_t calls = 0;
+        size_t cursor = 0;
+        do
+        {
+            cursor = hashTable_scan(ht, cursor, 4, test_scan_count, counts);
+            calls++;
+        } while (cursor != 0);
+
+        assert(calls > 200 / 4 / 4);
+        for (size_t i = 0; i < 200; ++i)
+        {
+            assert(counts[i] == 1);
+        }
+
+        hashTable_delete(ht);
+    }
+
+    // Modifications between calls, keys present during the whole scan are passed exactly once
+    {
+        HashTable* ht = hashTable_new(400);
+        for (size_t i = 0; i < 200; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            hashTable_insert(ht, key, key);
+        }
+
+        memset(counts, 0, sizeof(counts));
+        size_t step = 0;
+        size_t cursor = 0;
+        do
+        {
+            cursor = hashTable_scan(ht, cursor, 3, test_scan_count, counts);
+
+            // Keys 100..199 are deleted and 200..299 inserted while scanning
+            snprintf(key, sizeof(key), "key%zu", 100 + step);
+            hashTable_delete_record(ht, key);
+            snprintf(key, sizeof(key), "key%zu", 200 + step);
+            hashTable_insert(ht, key, key);
+            step = step + 1 < 100 ? step + 1 : step;
+        } while (cursor != 0);
+
+        for (size_t i = 0; i < 100; ++i)
+        {
+            assert(counts[i] == 1);
+        }
+        for (size_t i = 100; i < 300; ++i)
+        {
+            assert(counts[i] <= 1);
+        }
+
+        hashTable_delete(ht);
+    }
+}
+
+// Sums decimal counts, context counts the calls
+static const char* test_combine_sum(const char* key, const char* present, const char* incoming,
+                                    char* buffer, size_t capacity, void* context)
+{
+    (void)key;
+    __atomic_fetch_add((size_t*)context, 1, __ATOMIC_RELAXED);
+    snprintf(buffer, capacity, "%lu", strtoul(present, NULL, 10) + strtoul(incoming, NULL, 10));
+    return buffer;
+}
+
+// Test function: int hashTable_merge(HashTable* destination, const HashTable* const* sources, size_t count,
+//                                    HashTableCombineCallback combine, void* context, size_t threads);
+void hashtable_merge_test(void)
+{
+    char key[32];
+    char value[32];
+
+    // Incorrect arguments
+    {
+        HashTable* ht = hashTable_new(5);
+        const HashTable* self[] = {ht};
+        const HashTable* none[] = {NULL};
+        assert(hashTable_merge(NULL, self, 1, NULL, NULL, 1) == -1);
+        assert(hashTable_merge(ht, NULL, 1, NULL, NULL, 1) == -1);
+        assert(hashTable_merge(ht, self, 1, NULL, NULL, 1) == -1);
+        assert(hashTable_merge(ht, none, 1, NULL, NULL, 1) == -1);
+        assert(hashTable_merge(ht, self, 0, NULL, NULL, 4) == 0);
+        assert(ht->noOfElems == 0);
+        hashTable_delete(ht);
+    }
+
+    // Per-thread counters summed into global ones, parallel merge gives the same table as the serial one
+    {
+        HashTable* sources[4];
+        for (size_t s = 0; s < 4; ++s)
+        {
+            // One source of different size is merged by hashing its keys again
+            sources[s] = hashTable_new(s == 3 ? 397 : 512);
+            for (size_t i = s * 50; i < s * 50 + 150; ++i)
+            {
+                snprintf(key, sizeof(key), "site%zu", i);
+                snprintf(value, sizeof(value), "%zu", s + 1);
+                hashTable_insert(sources[s], key, value);
+            }
+        }
+
+        HashTable* serial = hashTable_new(512);
+        HashTable* parallel = hashTable_new(512);
+        hashTable_insert(serial, "site0", "100");
+        hashTable_insert(parallel, "site0", "100");
+
+        size_t serialCalls = 0;
+        size_t parallelCalls = 0;
+        assert(hashTable_merge(serial, (const HashTable* const*)sources, 4, test_combine_sum, &serialCalls, 1) == 0);
+        assert(hashTable_merge(parallel, (const HashTable* const*)sources, 4, test_combine_sum, &parallelCalls, 4) == 0);
+
+        // Keys 50..299 are present in two or three sources, site0 was already present
+        assert(serialCalls == parallelCalls);
+        assert(serialCalls == 1 + 4 * 150 - 300);
+        assert(serial->noOfElems == 300);
+        assert(parallel->noOfElems == 300);
+
+        for (size_t i = 0; i < 300; ++i)
+        {
+            size_t expected = i == 0 ? 100 : 0;
+            for (size_t s = 0; s < 4; ++s)
+            {
+                expected += i >= s * 50 && i < s * 50 + 150 ? s + 1 : 0;
+            }
+
+            snprintf(key, sizeof(key), "site%zu", i);
+            snprintf(value, sizeof(value), "%zu", expected);
+            assert(strcmp(hashTable_search(serial, key), value) == 0);
+            assert(strcmp(hashTable_search(parallel, key), value) == 0);
+        }
+
+        // Without combine the incoming value replaces the present one
+        assert(hashTable_merge(serial, (const HashTable* const*)&sources[2], 1, NULL, NULL, 2) == 0);
+        assert(strcmp(hashTable_search(serial, "site100"), "3") == 0);
+        assert(serial->noOfElems == 300);
+
+        for (size_t s = 0; s < 4; ++s)
+        {
+            hashTable_delete(sources[s]);
+        }
+        hashTable_delete(serial);
+        hashTable_delete(parallel);
+    }
+
+    // Long chains of merged records are indexed, new keys which don't fit are dropped
+    {
+        HashTable* source = hashTable_new(4);
+        HashTable* ht = hashTable_new(4);
+        hashTable_insert(source, "ab", "1");
+        hashTable_insert(source, "ba", "2");
+        hashTable_insert(source, "c", "3");
+        hashTable_insert(ht, "c", "4");
+        hashTable_insert(ht, "d", "5");
+        hashTable_insert(ht, "e", "6");
+
+        assert(hashTable_merge(ht, (const HashTable* const*)&source, 1, NULL, NULL, 4) == -1);
+        assert(ht->noOfElems == 4);
+        assert(strcmp(hashTable_search(ht, "c"), "3") == 0);
+        assert((hashTable_search(ht, "ab") != NULL) != (hashTable_search(ht, "ba") != NULL));
+        hashTable_delete(ht);
+        hashTable_delete(source);
+
+        source = hashTable_new(64);
+        ht = hashTable_new(64);
+        for (size_t i = 0; i < 12; ++i)
+        {
+            test_colliding_key(key, sizeof(key), "key", 64, i);
+            hashTable_insert(source, key, key);
+        }
+        assert(hashTable_merge(ht, (const HashTable* const*)&source, 1, NULL, NULL, 4) == 0);
+        assert(ht->noOfElems == source->noOfElems);
+        assert(ht->sortedBuckets != NULL);
+
+        HashTableStats stats;
+        hashTable_stats(ht, &stats);
+        assert(stats.sortedBuckets == 1);
+        hashTable_delete(ht);
+        hashTable_delete(source);
+    }
+
+    // Destination with a filter is merged serially and the filter knows the new keys, expired records are skipped
+    {
+        HashTable* source = hashTable_new(16);
+        HashTable* ht = hashTable_new(16);
+        assert(hashTable_bloom_enable(ht, 0, HASHTABLE_BLOOM_COUNTING) == 0);
+        hashTable_insert(source, "kept", "1");
+        hashTable_insert_ttl(source, "expired", "2", 5);
+        hashTable_expire(source, 10, 0);
+
+        size_t calls = 0;
+        assert(hashTable_merge(ht, (const HashTable* const*)&source, 1, test_combine_sum, &calls, 4) == 0);
+        assert(calls == 0);
+        assert(ht->noOfElems == 1);
+        assert(strcmp(hashTable_search(ht, "kept"), "1") == 0);
+        assert(hashTable_search(ht, "expired") == NULL);
+        assert(bloom_may_contain(ht->bloom, key_hash("kept")));
+
+        hashTable_delete(ht);
+        hashTable_delete(source);
+    }
+}
+
+// Test functions: void hashTable_clear(HashTable* hashTable, size_t threads);
+//                 void hashTable_delete_parallel(HashTable* hashTable, size_t threads);
+void hashtable_clear_test(void)
+{
+    char key[16];
+
+    // Incorrect arguments
+    {
+        hashTable_clear(NULL, 4);
+        hashTable_delete_parallel(NULL, 4);
+    }
+
+    // Cleared table is empty and usable again, its filter, cache and wheel are reset
+    {
+        HashTable* ht = hashTable_new(100);
+        assert(hashTable_bloom_enable(ht, 0, HASHTABLE_BLOOM_PLAIN) == 0);
+        assert(hashTable_cache_enable(ht, 0, 0) == 0);
+        for (size_t i = 0; i < 100; ++i)
+        {
+            snprintf(key, sizeof(key), "key%zu", i);
+            hashTable_insert_ttl(ht, key, key, i % 2 ? 50 : 0);
+        }
+        hashTable_expire(ht, 10, 0);
+
+        hashTable_clear(ht, 4);
+        assert(ht->noOfElems == 0);
+        assert(ht->cache->bytes == 0);
+        assert(ht->wheel->now == 10);
+        assert(ht->wheel->pending[0] == 0 && ht->wheel->far == NULL && ht->wheel->due == NULL);
+        for (size_t i = 0; i < ht->size; ++i)
+        {
+            assert(ht->records[i] == NULL);
+        }
+        assert(!bloom_may_contain(ht->bloom, key_hash("key1")));
+        assert(hashTable_search(ht, "key1") == NULL);
+
+        hashTable_insert(ht, "key1", "value");
+        assert(strcmp(hashTable_search(ht, "key1"), "value") == 0);
+        assert(hashTable_expire(ht, 100, 0) == 0);
+        assert(ht->noOfElems == 1);
+        hashTable_delete_parallel(ht, 4);
+    }
+
+    // Records of a bulk loaded table and indexed chains are released in parallel
+    {
+        const char* keys[64];
+        char strings[64][16];
+        for (size_t i = 0; i < 64; ++i)
+        {
+            snprintf(strings[i], sizeof(strings[i]), i < 12 ? "chain%zu" : "bulk%zu", i);
+            keys[i] = strings[i];
+        }
+
+        HashTable* ht = hashTable_new_from_arrays(keys, keys, 64, 1);
+        hashTable_clear(ht, 8);
+        assert(ht->noOfElems == 0);
+        assert(ht->bulkBlock == NULL);
+
+        for (size_t i = 0; i < 12; ++i)
+        {
+            test_colliding_key(key, sizeof(key), "key", 64, i);
+            hashTable_insert(ht, key, key);
+        }
+        assert(ht->sortedBuckets != NULL);
+        hashTable_delete_parallel(ht, 100);
+    }
+}
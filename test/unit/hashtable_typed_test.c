@@ -0,0 +1,118 @@
+#include <hashtable_module/hashtable_typed.h>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct CallSite
+{
+    unsigned int line;
+    size_t calls;
+} CallSite;
+
+HASHTABLE_TYPED_INIT(U64, uint64_t, CallSite, hashTableTyped_hash_u64, HASHTABLE_TYPED_EQUAL_SCALAR)
+HASHTABLE_TYPED_INIT(Str, const char*, int, hashTableTyped_hash_str, HASHTABLE_TYPED_EQUAL_STR)
+
+// All keys in the same home slot, to exercise probing and backward shift deletion
+#define CONSTANT_HASH(key) ((void)(key), (uint64_t)5)
+HASHTABLE_TYPED_INIT(Clash, int, int, CONSTANT_HASH, HASHTABLE_TYPED_EQUAL_SCALAR)
+
+void hashtable_typed_test(void);
+
+// Test functions: generated hashTable<Name>_new, _insert, _search and _delete_record
+void hashtable_typed_test(void)
+{
+    // Incorrect arguments
+    {
+        const CallSite site = {1, 1};
+
+        assert(hashTableU64_insert(NULL, 1, site) == -1);
+        assert(hashTableU64_search(NULL, 1) == NULL);
+        hashTableU64_delete_record(NULL, 1);
+        hashTableU64_delete(NULL);
+    }
+
+    // Integer keys with struct values, values are updated through the returned pointer
+    {
+        HashTableU64* ht = hashTableU64_new(4);
+        assert(ht != NULL);
+        assert(ht->size == HASHTABLE_TYPED_MIN_SIZE);
+
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            const CallSite site = {(unsigned int)i, 0};
+            assert(hashTableU64_insert(ht, i * 4096, site) == 0);
+        }
+
+        // Table grows, load stays under the limit
+        assert(ht->noOfElems == 1000);
+        assert(ht->noOfElems * HASHTABLE_TYPED_LOAD_DEN <= ht->size * HASHTABLE_TYPED_LOAD_NUM);
+
+        CallSite* site = hashTableU64_search(ht, 42 * 4096);
+        assert(site != NULL && site->line == 42);
+        site->calls++;
+        assert(hashTableU64_search(ht, 42 * 4096)->calls == 1);
+        assert(hashTableU64_search(ht, 42) == NULL);
+
+        // Update keeps the number of elements
+        const CallSite updated = {7, 7};
+        assert(hashTableU64_insert(ht, 0, updated) == 0);
+        assert(ht->noOfElems == 1000);
+        assert(hashTableU64_search(ht, 0)->calls == 7);
+
+        for (uint64_t i = 0; i < 1000; i += 2)
+        {
+            hashTableU64_delete_record(ht, i * 4096);
+        }
+        assert(ht->noOfElems == 500);
+
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            assert((hashTableU64_search(ht, i * 4096) != NULL) == (i % 2 == 1));
+        }
+
+        hashTableU64_delete(ht);
+    }
+
+    // String keys are not copied, equal strings in different buffers are the same key
+    {
+        HashTableStr* ht = hashTableStr_new(0);
+        char key[8] = "keyOne";
+
+        assert(hashTableStr_insert(ht, "keyOne", 1) == 0);
+        assert(hashTableStr_insert(ht, "keyTwo", 2) == 0);
+        assert(*hashTableStr_search(ht, key) == 1);
+        assert(hashTableStr_search(ht, "keyThr") == NULL);
+
+        hashTableStr_delete_record(ht, key);
+        assert(hashTableStr_search(ht, "keyOne") == NULL);
+        assert(*hashTableStr_search(ht, "keyTwo") == 2);
+
+        hashTableStr_delete(ht);
+    }
+
+    // One long probe sequence, deleting from its middle keeps all other keys reachable
+    {
+        HashTableClash* ht = hashTableClash_new(16);
+
+        for (int i = 0; i < 12; ++i)
+        {
+            assert(hashTableClash_insert(ht, i, i * 10) == 0);
+        }
+
+        for (int deleted = 0; deleted < 12; deleted += 3)
+        {
+            hashTableClash_delete_record(ht, deleted);
+            assert(hashTableClash_search(ht, deleted) == NULL);
+
+            for (int i = 0; i < 12; ++i)
+            {
+                const int* value = hashTableClash_search(ht, i);
+                assert((value != NULL) == (i % 3 != 0 || i > deleted));
+                assert(value == NULL || *value == i * 10);
+            }
+        }
+
+        assert(ht->noOfElems == 8);
+        hashTableClash_delete(ht);
+    }
+}
@@ -3,14 +3,56 @@ extern void nodeList_new_test(void);
 extern void nodeList_insert_test(void);
 extern void nodeList_node_delete_test(void);
 
+// Unrolled list tests
+extern void unrolledList_new_test(void);
+extern void unrolledList_insert_test(void);
+extern void unrolledList_node_delete_test(void);
+
 // Hashtable tests
 extern void hashtable_record_new_test(void);
 extern void hashtable_new_test(void);
+extern void hashtable_new_from_arrays_test(void);
 extern void hashtable_insert_test(void);
 extern void hashtable_delete_record_test(void);
 extern void hashtable_hash_function_test(void);
 extern void hashtable_collision_test(void);
 extern void hashtable_search_test(void);
+extern void hashtable_stats_test(void);
+extern void hashtable_search_batch_test(void);
+extern void hashtable_bloom_test(void);
+extern void hashtable_cache_test(void);
+extern void hashtable_ttl_test(void);
+extern void hashtable_insert_zero_copy_test(void);
+extern void hashtable_inline_strings_test(void);
+extern void hashtable_treeify_test(void);
+extern void hashtable_iterator_test(void);
+extern void hashtable_scan_test(void);
+extern void hashtable_merge_test(void);
+extern void hashtable_clear_test(void);
+
+// Hashtable snapshot tests
+extern void hashtable_snapshot_test(void);
+
+// Frozen hashtable tests
+extern void hashtable_freeze_test(void);
+
+// Cuckoo hashtable tests
+extern void hashtable_cuckoo_test(void);
+
+// Hashtable export tests
+extern void hashtable_export_test(void);
+
+// String interning tests
+extern void hashtable_intern_test(void);
+
+// Category radix tree tests
+extern void hashtable_radix_test(void);
+
+// Read-copy-update hashtable tests
+extern void hashtable_rcu_test(void);
+
+// Typed hashtable tests
+extern void hashtable_typed_test(void);
 
 int main(void)
 {
@@ -18,13 +60,46 @@ int main(void)
     nodeList_insert_test();
     nodeList_node_delete_test();
 
+    unrolledList_new_test();
+    unrolledList_insert_test();
+    unrolledList_node_delete_test();
+
     hashtable_record_new_test();
     hashtable_new_test();
+    hashtable_new_from_arrays_test();
     hashtable_insert_test();
     hashtable_delete_record_test();
     hashtable_hash_function_test();
     hashtable_collision_test();
     hashtable_search_test();
+    hashtable_stats_test();
+    hashtable_search_batch_test();
+    hashtable_bloom_test();
+    hashtable_cache_test();
+    hashtable_ttl_test();
+    hashtable_insert_zero_copy_test();
+    hashtable_inline_strings_test();
+    hashtable_treeify_test();
+    hashtable_iterator_test();
+    hashtable_scan_test();
+    hashtable_merge_test();
+    hashtable_clear_test();
+
+    hashtable_snapshot_test();
+
+    hashtable_freeze_test();
+
+    hashtable_cuckoo_test();
+
+    hashtable_export_test();
+
+    hashtable_intern_test();
+
+    hashtable_radix_test();
+
+    hashtable_rcu_test();
+
+    hashtable_typed_test();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include <unrolledlist.c>
+#include <assert.h>
+#include <stdio.h>
+
+void unrolledList_new_test(void);
+void unrolledList_insert_test(void);
+void unrolledList_node_delete_test(void);
+
+static int unrolled_contains(const UnrolledList* head, const void* data);
+
+
+// Test function: UnrolledList* unrolledList_new(void* data);
+void unrolledList_new_test(void)
+{
+    // pass NULL pointer as an argument to constructor
+    {
+        UnrolledList* node = unrolledList_new(NULL);
+
+        assert(node == NULL);
+    }
+
+    // pass proper argument to constructor
+    {
+        int value = 1;
+        UnrolledList* node = unrolledList_new(&value);
+
+        assert(node != NULL);
+        assert(node->next == NULL);
+        assert(node->count == 1);
+        assert(node->data[0] == &value);
+        assert(unrolledList_size(node) == 1);
+
+        unrolledList_delete(&node);
+        assert(node == NULL);
+    }
+}
+
+// Test function: void unrolledList_insert(UnrolledList** head, void* data);
+void unrolledList_insert_test(void)
+{
+    // incorrect insert, NULL head as an argument, head should remain NULL
+    {
+        int value = 1;
+        UnrolledList* head = NULL;
+        unrolledList_insert(&head, &value);
+
+        assert(head == NULL);
+    }
+
+    // incorrect insert, proper head but NULL data, head should not be changed
+    {
+        int value = 1;
+        UnrolledList* head = unrolledList_new(&value);
+        unrolledList_insert(&head, NULL);
+
+        assert(head->count == 1);
+        assert(head->next == NULL);
+
+        unrolledList_delete(&head);
+    }
+
+    // head node is filled first, next element starts a new head node
+    {
+        int values[UNROLLED_LIST_NODE_CAPACITY + 1];
+        UnrolledList* head = unrolledList_new(&values[0]);
+        UnrolledList* first = head;
+
+        for (size_t i = 1; i < UNROLLED_LIST_NODE_CAPACITY; ++i)
+        {
+            unrolledList_insert(&head, &values[i]);
+            assert(head == first);
+            assert(head->count == i + 1);
+            assert(head->data[i] == &values[i]);
+        }
+
+        unrolledList_insert(&head, &values[UNROLLED_LIST_NODE_CAPACITY]);
+        assert(head != first);
+        assert(head->next == first);
+        assert(head->count == 1);
+        assert(head->data[0] == &values[UNROLLED_LIST_NODE_CAPACITY]);
+        assert(unrolledList_size(head) == UNROLLED_LIST_NODE_CAPACITY + 1);
+
+        unrolledList_delete(&head);
+    }
+}
+
+// Test function: void unrolledList_node_delete(UnrolledList** head, void* data)
+void unrolledList_node_delete_test(void)
+{
+    // Delete not existing element, list should not be changed
+    {
+        int values[2];
+        UnrolledList* head = unrolledList_new(&values[0]);
+
+        unrolledList_node_delete(&head, &values[1]);
+        assert(head != NULL);
+        assert(head->count == 1);
+
+        unrolledList_delete(&head);
+    }
+
+    // Delete the only element, list should not exist anymore
+    {
+        int value = 1;
+        UnrolledList* head = unrolledList_new(&value);
+
+        unrolledList_node_delete(&head, &value);
+        assert(head == NULL);
+    }
+
+    // Delete from a full node, the hole is filled from the head node
+    {
+        int values[UNROLLED_LIST_NODE_CAPACITY + 2];
+        UnrolledList* head = unrolledList_new(&values[0]);
+        for (size_t i = 1; i < UNROLLED_LIST_NODE_CAPACITY + 2; ++i)
+        {
+            unrolledList_insert(&head, &values[i]);
+        }
+        UnrolledList* full = head->next;
+        assert(head->count == 2);
+
+        unrolledList_node_delete(&head, &values[3]);
+        assert(head->count == 1);
+        assert(full->count == UNROLLED_LIST_NODE_CAPACITY);
+        assert(full->data[3] == &values[UNROLLED_LIST_NODE_CAPACITY + 1]);
+        assert(!unrolled_contains(head, &values[3]));
+
+        // Head node gives its last element and is released, the full node is the head again
+        unrolledList_node_delete(&head, &values[0]);
+        assert(head == full);
+        assert(head->next == NULL);
+        assert(head->count == UNROLLED_LIST_NODE_CAPACITY);
+        assert(head->data[0] == &values[UNROLLED_LIST_NODE_CAPACITY]);
+        assert(!unrolled_contains(head, &values[0]));
+
+        unrolledList_delete(&head);
+    }
+
+    // Random deletes keep all remaining elements reachable and only the head node partial
+    {
+        int values[100];
+        UnrolledList* head = unrolledList_new(&values[0]);
+        for (size_t i = 1; i < 100; ++i)
+        {
+            unrolledList_insert(&head, &values[i]);
+        }
+
+        for (size_t i = 0; i < 100; ++i)
+        {
+            const size_t deleted = (i * 37) % 100;
+            unrolledList_node_delete(&head, &values[deleted]);
+            assert(unrolledList_size(head) == 99 - i);
+
+            for (const UnrolledList* node = head != NULL ? head->next : NULL; node != NULL; node = node->next)
+            {
+                assert(node->count == UNROLLED_LIST_NODE_CAPACITY);
+            }
+        }
+
+        assert(head == NULL);
+    }
+}
+
+static int unrolled_contains(const UnrolledList* head, const void* data)
+{
+    for (const UnrolledList* node = head; node != NULL; node = node->next)
+    {
+        for (size_t i = 0; i < node->count; ++i)
+        {
+            if (node->data[i] == data)
+            {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}